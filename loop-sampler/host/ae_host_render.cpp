@@ -0,0 +1,682 @@
+/**
+ * @file ae_host_render.cpp
+ * @brief Offline render and benchmark harness for the loop-sampler engine
+ *
+ * Builds ae_render_block() for Linux against the stubs in host_stubs.cpp,
+ * plays a scripted knob/trigger timeline through it, writes the PWM output
+ * back out as a WAV file and reports render cost per sample and per block.
+ * This gives a repeatable before/after baseline for engine changes without
+ * flashing the Pico2-XXL.
+ *
+ * ## Usage
+ *
+ *   make                       # builds ./build/ae_host_render
+ *   ./build/ae_host_render [-i in.wav] [-s script.txt] [-o out.wav]
+ *                          [-d seconds] [-n passes] [-L window_ms] [-B] [-M] [-p] [-S] [-Z]
+ *
+ *   -i  source sample (PCM WAV). Without it a 2 s test chirp is used.
+ *   -B  use a 2 s synthetic drum break instead of the chirp. Its hit times
+ *       are known, so the slice map's onsets can be checked against them.
+ *   -s  timeline script (see below). Without it the knobs sit at defaults.
+ *   -o  output WAV (stereo, L/R as written to the PWM buffers).
+ *   -d  render length in seconds (overrides the script's `end`).
+ *   -n  repeat the timeline N times for steadier timing (WAV is pass 1 only).
+ *   -M  skip the octave mipmaps (what the device does when PSRAM is short).
+ *   -p  print the per-stage render profile (render_profiler.h).
+ *   -S  load stereo (SF_LOAD_STEREO): a stereo file keeps L/R, and the test
+ *       chirp gets a falling sweep on the right channel.
+ *   -Z  snap loop points to rising zero crossings (ZC_LOOP_SNAP) and allow
+ *       1-sample crossfades.
+ *   -L  stream the source through a PSRAM window of this many ms
+ *       (sample_stream.h), as the device does with files larger than PSRAM.
+ *       The test chirp is 8 s long then. Chunks are read from memory at
+ *       HOST_STREAM_RATE_X times the output rate, standing in for the card.
+ *
+ * ## Timeline scripts
+ *
+ * One event per line, `#` starts a comment, times in milliseconds:
+ *
+ *   0     knob   start 0          # set a knob (0..4095)
+ *   0     knob   len   4095
+ *   250   knob   tune  3000 500   # ramp to 3000 over 500 ms
+ *   0     octave 4                # rotary switch position (0 = LFO, 4 = 1x)
+ *   0     mode   fwd              # fwd | rev | alt
+ *   1000  trig                    # reset trigger rising edge (GPIO IRQ timestamp)
+ *   2000  shed   1                # load-shed level (0..AE_SHED_MAX)
+ *   0     pmosc  220 1500         # audio-rate PM: sine at 220 Hz, ±1500 around pm
+ *   0     snap   on               # loop length snaps to the trigger tempo (on | off)
+ *   0     slice  on               # start knob selects onset slices (on | off)
+ *   0     rec    on               # start a take from the PM input (on | off)
+ *   3000  overdub                 # overdub one pass of the playing loop
+ *   0     shape  fold             # saturation curve (tanh | tube | fold)
+ *   0     os2x   on               # 2x oversampled saturation (on | off)
+ *   0     fx     lowpass off      # enable / bypass an effect slot (fx_chain.h)
+ *   0     delay  on               # stereo delay (on | off | sync | free | time in ms)
+ *   0     grain  on               # granular mode in place of the voices (on | off)
+ *   4000  end                     # stop rendering
+ *
+ * Knob names: start len tune pm xfade fx1 fx2 depth, or a raw channel number.
+ * `pm` is the unfiltered TZFM input; all others go through adc_filter_get().
+ * `pmosc` streams the PM input per sample, as the device's ADC capture ring
+ * does; amplitude 0 goes back to one PM read per block. The recorder reads
+ * the same input, so `rec` and `overdub` record the `pmosc` sine. A take
+ * replaces the source once it ends, as it does on the device.
+ *
+ * Timing numbers are host-relative: compare runs on the same machine rather
+ * than reading them as RP2350 cycle counts.
+ *
+ * @author Brian Varren
+ * @version 1.0
+ * @date 2025
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <stdint.h>
+#include "ADCless.h"
+#include "DACless.h"
+#include "audio_engine.h"
+#include "crossfade.h"
+#include "interp_kernel.h"
+#include "sample_mipmap.h"
+#include "sample_cache.h"
+#include "seam_cache.h"
+#include "render_profiler.h"
+#include "reset_trigger.h"
+#include "tempo_clock.h"
+#include "zero_cross.h"
+#include "slice_map.h"
+#include "recorder.h"
+#include "sample_stream.h"
+#include "waveshaper.h"
+#include "stereo_delay.h"
+#include "granular.h"
+#include "fx_chain.h"
+#include "sf_globals_bridge.h"
+#include "storage_loader.h"
+#include "host_stubs.h"
+#include "host_cycles.h"
+#include "host_wav.h"
+
+// Forward declaration from audio_engine_render.cpp
+void ae_render_block(const int16_t* samples,
+                     uint32_t total_samples,
+                     uint8_t channels,
+                     ae_state_t engine_state,
+                     volatile uint64_t* io_phase_q32_32);
+
+// ── Timeline ─────────────────────────────────────────────────────────────
+enum EventType : uint8_t { EV_KNOB, EV_OCTAVE, EV_MODE, EV_TRIG, EV_SHED, EV_PMOSC, EV_SNAP, EV_SLICE, EV_REC, EV_OVERDUB, EV_SHAPE, EV_OS2X, EV_FX, EV_DELAY, EV_GRAIN, EV_END };
+
+struct Event {
+  uint32_t  t_ms;
+  EventType type;
+  uint8_t   ch;
+  uint16_t  value;
+  uint32_t  ramp_ms;
+  float     hz;
+};
+
+static const int MAX_EVENTS = 1024;
+static Event s_events[MAX_EVENTS];
+static int   s_event_count = 0;
+
+struct Ramp {
+  bool     active;
+  uint16_t from, to;
+  uint64_t t0_us, t1_us;
+};
+static Ramp s_ramps[NUM_ADC_INPUTS];
+
+static int knob_channel(const char* name) {
+  if (!strcmp(name, "start")) return ADC_LOOP_START_CH;
+  if (!strcmp(name, "len"))   return ADC_LOOP_LEN_CH;
+  if (!strcmp(name, "tune"))  return ADC_TUNE_CH;
+  if (!strcmp(name, "pm"))    return ADC_PM_CH;
+  if (!strcmp(name, "xfade")) return ADC_XFADE_LEN_CH;
+  if (!strcmp(name, "fx1"))   return ADC_FX1_CH;
+  if (!strcmp(name, "fx2"))   return ADC_FX2_CH;
+  if (!strcmp(name, "depth")) return ADC_TZFM_DEPTH_CH;
+  char* end = nullptr;
+  long ch = strtol(name, &end, 10);
+  if (end && *end == '\0' && ch >= 0 && ch < NUM_ADC_INPUTS) return (int)ch;
+  return -1;
+}
+
+static bool load_script(const char* path, uint32_t* io_end_ms) {
+  FILE* f = fopen(path, "r");
+  if (!f) { fprintf(stderr, "cannot open script %s\n", path); return false; }
+
+  char line[256];
+  int lineno = 0;
+  while (fgets(line, sizeof(line), f)) {
+    ++lineno;
+    char* hash = strchr(line, '#');
+    if (hash) *hash = '\0';
+
+    char cmd[32] = {0}, a[32] = {0};
+    unsigned t = 0, v = 0, ramp = 0;
+    int n = sscanf(line, "%u %31s %31s %u %u", &t, cmd, a, &v, &ramp);
+    if (n <= 0) continue;
+    if (n < 2 || s_event_count >= MAX_EVENTS) {
+      fprintf(stderr, "%s:%d: bad line\n", path, lineno);
+      fclose(f);
+      return false;
+    }
+
+    Event e = {};
+    e.t_ms = t;
+    if (!strcmp(cmd, "knob") && n >= 4) {
+      int ch = knob_channel(a);
+      if (ch < 0) { fprintf(stderr, "%s:%d: unknown knob '%s'\n", path, lineno, a); fclose(f); return false; }
+      e.type = EV_KNOB; e.ch = (uint8_t)ch; e.value = (uint16_t)(v > 4095u ? 4095u : v);
+      e.ramp_ms = (n >= 5) ? ramp : 0;
+    } else if (!strcmp(cmd, "octave") && n >= 3) {
+      e.type = EV_OCTAVE; e.value = (uint16_t)atoi(a);
+    } else if (!strcmp(cmd, "mode") && n >= 3) {
+      e.type = EV_MODE;
+      if      (!strcmp(a, "fwd")) e.value = AE_MODE_FORWARD;
+      else if (!strcmp(a, "rev")) e.value = AE_MODE_REVERSE;
+      else if (!strcmp(a, "alt")) e.value = AE_MODE_ALTERNATE;
+      else { fprintf(stderr, "%s:%d: unknown mode '%s'\n", path, lineno, a); fclose(f); return false; }
+    } else if (!strcmp(cmd, "trig")) {
+      e.type = EV_TRIG;
+    } else if (!strcmp(cmd, "shed") && n >= 3) {
+      e.type = EV_SHED; e.value = (uint16_t)atoi(a);
+    } else if (!strcmp(cmd, "snap") && n >= 3) {
+      e.type = EV_SNAP; e.value = !strcmp(a, "on") ? 1u : 0u;
+    } else if (!strcmp(cmd, "slice") && n >= 3) {
+      e.type = EV_SLICE; e.value = !strcmp(a, "on") ? 1u : 0u;
+    } else if (!strcmp(cmd, "rec") && n >= 3) {
+      e.type = EV_REC; e.value = !strcmp(a, "on") ? 1u : 0u;
+    } else if (!strcmp(cmd, "overdub")) {
+      e.type = EV_OVERDUB;
+    } else if (!strcmp(cmd, "shape") && n >= 3) {
+      e.type = EV_SHAPE;
+      if      (!strcmp(a, "tanh")) e.value = WS_CURVE_TANH;
+      else if (!strcmp(a, "tube")) e.value = WS_CURVE_TUBE;
+      else if (!strcmp(a, "fold")) e.value = WS_CURVE_FOLD;
+      else { fprintf(stderr, "%s:%d: unknown curve '%s'\n", path, lineno, a); fclose(f); return false; }
+    } else if (!strcmp(cmd, "os2x") && n >= 3) {
+      e.type = EV_OS2X; e.value = !strcmp(a, "on") ? 1u : 0u;
+    } else if (!strcmp(cmd, "fx") && n >= 3) {
+      char onoff[8] = {0};
+      const int slot = fx_find_slot(a);
+      if (slot < 0 || sscanf(line, "%*u %*s %*s %7s", onoff) != 1) {
+        fprintf(stderr, "%s:%d: bad fx slot line\n", path, lineno); fclose(f); return false;
+      }
+      e.type = EV_FX; e.ch = (uint8_t)slot; e.value = !strcmp(onoff, "on") ? 1u : 0u;
+    } else if (!strcmp(cmd, "delay") && n >= 3) {
+      // ch: 0 = on / off, 1 = sync / free, 2 = time (ms)
+      e.type = EV_DELAY;
+      if      (!strcmp(a, "on"))   { e.ch = 0; e.value = 1; }
+      else if (!strcmp(a, "off"))  { e.ch = 0; e.value = 0; }
+      else if (!strcmp(a, "sync")) { e.ch = 1; e.value = 1; }
+      else if (!strcmp(a, "free")) { e.ch = 1; e.value = 0; }
+      else if (atoi(a) > 0)        { e.ch = 2; e.value = (uint16_t)atoi(a); }
+      else { fprintf(stderr, "%s:%d: bad delay setting '%s'\n", path, lineno, a); fclose(f); return false; }
+    } else if (!strcmp(cmd, "grain") && n >= 3) {
+      e.type = EV_GRAIN; e.value = !strcmp(a, "on") ? 1u : 0u;
+    } else if (!strcmp(cmd, "pmosc") && n >= 4) {
+      e.type = EV_PMOSC; e.hz = (float)atof(a); e.value = (uint16_t)(v > 2047u ? 2047u : v);
+    } else if (!strcmp(cmd, "end")) {
+      e.type = EV_END;
+      *io_end_ms = t;
+      continue;
+    } else {
+      fprintf(stderr, "%s:%d: unknown command '%s'\n", path, lineno, cmd);
+      fclose(f);
+      return false;
+    }
+    s_events[s_event_count++] = e;
+  }
+  fclose(f);
+
+  // Stable insertion sort by time so same-time events keep script order
+  for (int i = 1; i < s_event_count; ++i) {
+    Event e = s_events[i];
+    int j = i - 1;
+    while (j >= 0 && s_events[j].t_ms > e.t_ms) { s_events[j + 1] = s_events[j]; --j; }
+    s_events[j + 1] = e;
+  }
+  return true;
+}
+
+static void apply_event(const Event& e, uint64_t now_us) {
+  switch (e.type) {
+    case EV_KNOB:
+      if (e.ramp_ms == 0) {
+        s_ramps[e.ch].active = false;
+        host_set_knob(e.ch, e.value);
+      } else {
+        Ramp& r = s_ramps[e.ch];
+        r.active = true;
+        r.from   = host_get_knob(e.ch);
+        r.to     = e.value;
+        r.t0_us  = now_us;
+        r.t1_us  = now_us + (uint64_t)e.ramp_ms * 1000u;
+      }
+      break;
+    case EV_OCTAVE: host_set_octave((uint8_t)e.value); break;
+    case EV_MODE:   host_set_mode((ae_mode_t)e.value); break;
+    case EV_TRIG:   host_fire_reset_trigger(e.t_ms * 1000u); break;
+    case EV_SHED:   host_set_load_shed((uint8_t)e.value); break;
+    case EV_PMOSC:  host_set_pm_osc(e.hz, e.value); break;
+    case EV_SNAP:   tc_set_snap(e.value != 0); break;
+    case EV_SLICE:  sm_set_slice_mode(e.value != 0); break;
+    case EV_REC:    if (e.value) rec_start(); else rec_stop(); break;
+    case EV_OVERDUB: rec_overdub(); break;
+    case EV_SHAPE:  ws_set_curve((ws_curve_t)e.value); break;
+    case EV_OS2X:   ws_set_oversample(e.value != 0); break;
+    case EV_FX:     fx_set_enabled(e.ch, e.value != 0); break;
+    case EV_DELAY:
+      if (e.ch == 0) dly_set_enabled(e.value != 0);
+      else if (e.ch == 1) dly_set_sync(e.value != 0);
+      else dly_set_time_ms(e.value);
+      break;
+    case EV_GRAIN:  gr_set_enabled(e.value != 0); break;
+    case EV_END:    break;
+  }
+}
+
+static void update_ramps(uint64_t now_us) {
+  for (int ch = 0; ch < NUM_ADC_INPUTS; ++ch) {
+    Ramp& r = s_ramps[ch];
+    if (!r.active) continue;
+    if (now_us >= r.t1_us) {
+      host_set_knob((uint8_t)ch, r.to);
+      r.active = false;
+      continue;
+    }
+    const double k = (double)(now_us - r.t0_us) / (double)(r.t1_us - r.t0_us);
+    host_set_knob((uint8_t)ch, (uint16_t)lround(r.from + k * ((double)r.to - (double)r.from)));
+  }
+}
+
+// ── Source material ──────────────────────────────────────────────────────
+// Exponential chirp 55 Hz -> 1760 Hz with a short click every 250 ms, so
+// loop points, pitch and crossfades are all audible in the render. The
+// stereo version sweeps the other way on the right channel.
+static int16_t chirp_q15(uint32_t i, uint32_t rate, double f0, double f1, double T) {
+  const double k = log(f1 / f0) / T;
+  const double t = (double)i / rate;
+  const double ph = 2.0 * M_PI * f0 * (exp(k * t) - 1.0) / k;
+  double s = 0.6 * sin(ph);
+  if ((i % (rate / 4)) < 32) s += 0.1;
+  return (int16_t)lrint(s * 32767.0);
+}
+
+static int16_t* make_test_chirp(uint32_t rate, uint32_t count, uint8_t channels) {
+  int16_t* buf = (int16_t*)malloc(sizeof(int16_t) * count * channels);
+  if (!buf) return nullptr;
+  const double T = (double)count / rate;
+  for (uint32_t i = 0; i < count; ++i) {
+    buf[i * channels] = chirp_q15(i, rate, 55.0, 1760.0, T);
+    if (channels == 2) buf[i * 2 + 1] = chirp_q15(i, rate, 1760.0, 55.0, T);
+  }
+  return buf;
+}
+
+// One bar of a 120 BPM break on a 16th-note grid: kicks (falling sine),
+// snares (noise + tone) and quieter hats (short noise bursts), each on top
+// of the previous hit's tail. s_break_hits holds the true onset frames.
+static const uint8_t s_break_kick[16]  = {1,0,0,1, 0,0,0,0, 1,0,1,0, 0,0,0,0};
+static const uint8_t s_break_snare[16] = {0,0,0,0, 1,0,0,0, 0,0,0,0, 1,0,0,1};
+static const uint8_t s_break_hat[16]   = {0,0,1,0, 0,0,1,0, 0,1,0,0, 0,0,1,0};
+static uint32_t s_break_hits[16];
+static uint32_t s_break_hit_count = 0;
+
+static int16_t* make_test_break(uint32_t rate, uint32_t count, uint8_t channels) {
+  int16_t* buf = (int16_t*)malloc(sizeof(int16_t) * count * channels);
+  if (!buf) return nullptr;
+  const uint32_t step = rate / 8u;  // 16th note at 120 BPM
+  uint32_t seed = 12345u;
+  double env_k = 0.0, env_s = 0.0, env_h = 0.0, ph_k = 0.0, ph_s = 0.0, hp = 0.0;
+  s_break_hit_count = 0;
+  for (uint32_t i = 0; i < count; ++i) {
+    const uint32_t st = (i / step) % 16u;
+    if (i % step == 0) {
+      if (s_break_kick[st])  { env_k = 0.9;  ph_k = 0.0; }
+      if (s_break_snare[st]) { env_s = 0.6;  ph_s = 0.0; }
+      if (s_break_hat[st])   env_h = 0.25;
+      if ((s_break_kick[st] || s_break_snare[st] || s_break_hat[st]) && s_break_hit_count < 16u) {
+        s_break_hits[s_break_hit_count++] = i;
+      }
+    }
+    seed = seed * 1664525u + 1013904223u;
+    const double noise = (double)(int32_t)seed / 2147483648.0;
+    const double t_k = (double)(i % step) / rate;
+    ph_k += 2.0 * M_PI * (50.0 + 100.0 * exp(-t_k / 0.03)) / rate;
+    ph_s += 2.0 * M_PI * 180.0 / rate;
+    const double hat = noise - hp;  // First difference: a bright hiss
+    hp = noise;
+    const double x = env_k * sin(ph_k) + env_s * (0.7 * noise + 0.3 * sin(ph_s)) + env_h * 0.5 * hat;
+    env_k *= exp(-1.0 / (0.12 * rate));
+    env_s *= exp(-1.0 / (0.06 * rate));
+    env_h *= exp(-1.0 / (0.015 * rate));
+    const int16_t q = (int16_t)lrint(fmax(-1.0, fmin(1.0, x)) * 32767.0);
+    for (uint32_t c = 0; c < channels; ++c) buf[i * channels + c] = q;
+  }
+  return buf;
+}
+
+// ── Streaming ────────────────────────────────────────────────────────────
+// The "card" is the decoded source in memory; the harness paces ss_poll()
+// so it delivers HOST_STREAM_RATE_X frames per output sample, like the
+// slowest reader the loader accepts (SS_MIN_RATE_X)
+#define HOST_STREAM_RATE_X  SS_MIN_RATE_X
+
+struct HostStreamSource {
+  const int16_t* samples;
+  uint8_t channels;
+};
+
+static bool host_stream_read(void* user, uint32_t frame, int16_t* dst, uint32_t frames) {
+  const HostStreamSource* src = (const HostStreamSource*)user;
+  memcpy(dst, src->samples + (size_t)frame * src->channels, (size_t)frames * 2u * src->channels);
+  return true;
+}
+
+// ── Timing helpers ───────────────────────────────────────────────────────
+static inline uint64_t now_ns(void) {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static int cmp_u32(const void* a, const void* b) {
+  const uint32_t x = *(const uint32_t*)a, y = *(const uint32_t*)b;
+  return (x > y) - (x < y);
+}
+
+static inline int16_t pwm_to_q15(uint16_t pwm) {
+  int32_t s = (int32_t)(((int64_t)pwm << 16) / (PWM_RESOLUTION - 1)) - 32768;
+  if (s > 32767) s = 32767;
+  if (s < -32768) s = -32768;
+  return (int16_t)s;
+}
+
+static void usage(const char* argv0) {
+  fprintf(stderr, "usage: %s [-i in.wav] [-s script.txt] [-o out.wav] [-d seconds] [-n passes] [-L window_ms] [-B] [-M] [-p] [-S] [-Z]\n", argv0);
+}
+
+int main(int argc, char** argv) {
+  const char* in_path = nullptr;
+  const char* script_path = nullptr;
+  const char* out_path = nullptr;
+  double duration_s = 0.0;
+  int passes = 1;
+  bool use_mips = true;
+  bool show_profile = false;
+  bool use_break = false;
+  uint32_t stream_ms = 0;
+  uint8_t load_flags = 0;
+
+  int opt;
+  while ((opt = getopt(argc, argv, "i:s:o:d:n:L:BMpSZh")) != -1) {
+    switch (opt) {
+      case 'i': in_path = optarg; break;
+      case 's': script_path = optarg; break;
+      case 'o': out_path = optarg; break;
+      case 'd': duration_s = atof(optarg); break;
+      case 'n': passes = atoi(optarg); if (passes < 1) passes = 1; break;
+      case 'L': stream_ms = (uint32_t)atoi(optarg); break;
+      case 'B': use_break = true; break;
+      case 'M': use_mips = false; break;
+      case 'p': show_profile = true; break;
+      case 'S': load_flags |= SF_LOAD_STEREO; break;
+      case 'Z': zc_set_snap(true); break;
+      default:  usage(argv[0]); return 2;
+    }
+  }
+
+  // Tables normally built by audio_init()
+  xfade_init_tables();
+  interp_init_tables();
+  gr_init_tables();
+  sc_init();
+  prof_init((float)(AUDIO_BLOCK_SIZE * 1e6 / audio_rate));
+  rt_init(audio_rate);
+  tc_init(audio_rate);
+  rec_init();
+  dly_init();
+
+  // Default panel: full-length loop, centered tune, filter open, no FM
+  host_set_knob(ADC_LOOP_START_CH, 0);
+  host_set_knob(ADC_LOOP_LEN_CH,   4095);
+  host_set_knob(ADC_TUNE_CH,       2048);
+  host_set_knob(ADC_PM_CH,         2048);
+  host_set_knob(ADC_XFADE_LEN_CH,  512);
+  host_set_knob(ADC_FX1_CH,        4095);
+  host_set_knob(ADC_FX2_CH,        0);
+  host_set_knob(ADC_TZFM_DEPTH_CH, 0);
+  host_set_octave(4);
+  host_set_mode(AE_MODE_FORWARD);
+
+  uint32_t end_ms = 2000;
+  if (script_path && !load_script(script_path, &end_ms)) return 1;
+  if (duration_s > 0.0) end_ms = (uint32_t)(duration_s * 1000.0);
+
+  // Source sample
+  int16_t* samples = nullptr;
+  uint32_t count = 0, src_rate = 48000;
+  uint8_t channels = 1;
+  if (!AE_STEREO) load_flags &= (uint8_t)~SF_LOAD_STEREO;
+  if (in_path) {
+    if (!host_wav_read_q15(in_path, &samples, &count, &src_rate, load_flags, &channels)) {
+      fprintf(stderr, "cannot read %s (PCM WAV 8/16/24/32-bit expected)\n", in_path);
+      return 1;
+    }
+  } else {
+    count = src_rate * (stream_ms ? 8u : 2u);
+    channels = (load_flags & SF_LOAD_STEREO) ? 2u : 1u;
+    samples = use_break ? make_test_break(src_rate, count, channels) : make_test_chirp(src_rate, count, channels);
+  }
+
+  // Streaming: the engine plays the window, bound to the whole source. Like
+  // the device, nothing is derived from the file (no mips, crossings, slices).
+  // Otherwise the loader takes the source over, as it would a recorder take.
+  HostStreamSource stream_src = {samples, channels};
+  int16_t* window = nullptr;
+  uint32_t window_frames = 0;
+  bool stream_ok = false;
+  if (stream_ms) {
+    window_frames = ss_window_frames((uint32_t)((uint64_t)src_rate * stream_ms / 1000u) * 2u * channels, channels);
+    window = window_frames ? (int16_t*)calloc(window_frames, 2u * channels) : nullptr;
+    if (!window || !ss_open(window, window_frames, count, channels, host_stream_read, &stream_src)) {
+      fprintf(stderr, "cannot stream through a %u ms window (%u frames minimum)\n", (unsigned)stream_ms,
+              (unsigned)(SS_MIN_CHUNKS * SS_CHUNK_FRAMES));
+      return 1;
+    }
+    stream_ok = ss_probe(src_rate);
+    sf::storage_adopt_stream_q15_psram(window, window_frames, count, channels, src_rate);
+  } else {
+    sf::storage_adopt_sample_q15_psram(samples, count, channels, src_rate);
+    if (!use_mips) mip_release();
+  }
+  const uint8_t mip_levels = g_sample_mipmap.levels;
+  const uint64_t sm_t0 = now_ns();
+  while (sm_poll()) {}  // The device scans on core 1 after the load
+  const double sm_ms = (now_ns() - sm_t0) / 1e6;
+
+  const uint32_t out_rate = (uint32_t)lrintf(audio_rate);
+  const double block_us = (double)AUDIO_BLOCK_SIZE * 1e6 / audio_rate;
+  const uint32_t total_blocks = (uint32_t)ceil((double)end_ms * 1000.0 / block_us);
+
+  HostWavWriter* wav = out_path ? host_wav_open(out_path, out_rate, 2) : nullptr;
+  if (out_path && !wav) { fprintf(stderr, "cannot write %s\n", out_path); return 1; }
+
+  uint32_t* block_ns = (uint32_t*)malloc(sizeof(uint32_t) * (size_t)total_blocks * (size_t)passes);
+  if (!block_ns) return 1;
+  uint64_t total_ns = 0;
+  uint64_t total_cycles = 0;
+  uint32_t measured = 0;
+  int16_t frame[AUDIO_BLOCK_SIZE * 2];
+  uint32_t stream_credit = 0;  // Frames the "card" may deliver
+
+  for (int pass = 0; pass < passes; ++pass) {
+    int next_event = 0;
+    rt_flush();  // The clock restarts each pass
+    for (uint32_t b = 0; b < total_blocks; ++b) {
+      const uint64_t t_us = (uint64_t)(b * block_us);
+      host_clock_set_us(t_us);
+      while (next_event < s_event_count && (uint64_t)s_events[next_event].t_ms * 1000u <= t_us) {
+        apply_event(s_events[next_event++], t_us);
+      }
+      update_ramps(t_us);
+
+      const volatile uint16_t* out_l;
+      const volatile uint16_t* out_r;
+      host_next_output_block(&out_l, &out_r);
+      rt_begin_block((uint32_t)t_us);  // Buffer freed "now"; edges from the last block period map into it
+
+      const uint64_t c0 = host_cycles();
+      const uint64_t t0 = now_ns();
+      const uint32_t render_frames = ss_total_frames() ? ss_total_frames() : audioSampleCount;
+      ae_render_block((const int16_t*)audioData, render_frames, audioChannels, AE_STATE_PLAYING, &g_phase_q32_32);
+      const uint64_t dt = now_ns() - t0;
+      total_cycles += host_cycles() - c0;
+
+      // Core 1's share: slice scans, publishing recorder takes and
+      // stream chunks at the card's pace
+      sm_poll();
+      rec_poll();
+      if (ss_total_frames()) {
+        stream_credit += AUDIO_BLOCK_SIZE * HOST_STREAM_RATE_X;
+        while (stream_credit >= SS_CHUNK_FRAMES && ss_poll()) stream_credit -= SS_CHUNK_FRAMES;
+        if (stream_credit > SS_CHUNK_FRAMES) stream_credit = SS_CHUNK_FRAMES;
+      }
+
+      total_ns += dt;
+      block_ns[measured++] = (uint32_t)(dt > 0xFFFFFFFFull ? 0xFFFFFFFFull : dt);
+
+      if (wav && pass == 0) {
+        for (uint32_t i = 0; i < AUDIO_BLOCK_SIZE; ++i) {
+          frame[2 * i]     = pwm_to_q15(out_l[i]);
+          frame[2 * i + 1] = pwm_to_q15(out_r[i]);
+        }
+        host_wav_write(wav, frame, AUDIO_BLOCK_SIZE);
+      }
+    }
+  }
+  host_wav_close(wav);
+
+  qsort(block_ns, measured, sizeof(uint32_t), cmp_u32);
+  const uint64_t total_samples = (uint64_t)measured * AUDIO_BLOCK_SIZE;
+  const double avg_block_us = measured ? (double)total_ns / measured / 1000.0 : 0.0;
+  const double p99_us = measured ? block_ns[(measured * 99u) / 100u] / 1000.0 : 0.0;
+  const double max_us = measured ? block_ns[measured - 1] / 1000.0 : 0.0;
+
+  printf("source      %u samples @ %u Hz, %s%s\n", (unsigned)count, (unsigned)src_rate,
+         (channels == 2) ? "stereo" : "mono", in_path ? "" : use_break ? " (test break)" : " (test chirp)");
+  printf("mipmaps     %u level(s)\n", (unsigned)mip_levels);
+  printf("zero-x      %u rising crossings, %u bytes, loop snap %s\n", (unsigned)g_zero_cross.crossings,
+         (unsigned)zc_required_bytes(count), zc_snap_enabled() ? "on" : "off");
+  const SliceMap* sm = sm_current();
+  printf("slices      %u onsets in %.2f ms, slice mode %s\n", sm ? (unsigned)sm->count : 0u, sm_ms,
+         sm_slice_mode() ? "on" : "off");
+  if (sm && use_break && !in_path) {
+    // Distance of every detected onset from the nearest true hit
+    uint32_t worst = 0, matched = 0;
+    for (uint32_t i = 0; i < sm->count; ++i) {
+      uint32_t best = 0xFFFFFFFFu;
+      for (uint32_t h = 0; h < s_break_hit_count; ++h) {
+        const uint32_t d = (sm->pos[i] > s_break_hits[h]) ? sm->pos[i] - s_break_hits[h] : s_break_hits[h] - sm->pos[i];
+        if (d < best) best = d;
+      }
+      if (best <= 64u) matched++;
+      if (best > worst) worst = best;
+    }
+    printf("slices      %u of %u hits matched within 64 frames, worst onset off by %u frames\n",
+           (unsigned)matched, (unsigned)s_break_hit_count, (unsigned)worst);
+  }
+  printf("output      %u Hz, block %u samples, deadline %.1f us\n",
+         (unsigned)out_rate, (unsigned)AUDIO_BLOCK_SIZE, block_us);
+  printf("rendered    %llu samples in %d pass(es), %.2f ms wall\n",
+         (unsigned long long)total_samples, passes, total_ns / 1e6);
+  printf("ns/sample   %.1f\n", total_samples ? (double)total_ns / total_samples : 0.0);
+  printf("cyc/sample  %.1f (%s)\n", total_samples ? (double)total_cycles / total_samples : 0.0, HOST_CYCLES_NAME);
+  printf("block us    avg %.2f  p99 %.2f  max %.2f  (worst %.1f%% of deadline)\n",
+         avg_block_us, p99_us, max_us, block_us > 0 ? 100.0 * max_us / block_us : 0.0);
+  // Latency of the configured output ring, and what the fixed per-block work
+  // (the profiler's params stage) costs per sample at this block size
+  ProfSnapshot prof;
+  prof_get_snapshot(&prof);
+  const double params_us = prof.tick_hz ? (double)prof.stage[PROF_PARAMS].avg * 1e6 / prof.tick_hz : 0.0;
+  const double prof_us = prof.tick_hz ? (double)prof.total.avg * 1e6 / prof.tick_hz : 0.0;
+  printf("latency     %u x %u buffers: %.2f ms slack, %.2f..%.2f ms output\n",
+         (unsigned)AUDIO_BLOCK_SIZE, (unsigned)AUDIO_BUFFER_DEPTH, block_us * (AUDIO_BUFFER_DEPTH - 1) / 1000.0,
+         block_us * (AUDIO_BUFFER_DEPTH - 1) / 1000.0, block_us * AUDIO_BUFFER_DEPTH / 1000.0);
+  printf("overhead    %.2f us/block fixed = %.1f ns/sample, %.1f%% of render\n",
+         params_us, params_us * 1000.0 / AUDIO_BLOCK_SIZE, prof_us > 0 ? 100.0 * params_us / prof_us : 0.0);
+  printf("loop LED    %u blinks\n", (unsigned)host_loop_led_blinks());
+  const SampleCacheStats* cs = sc_stats();
+  const uint32_t lookups = cs->hits + cs->misses;
+  printf("sram cache  %.1f%% hit (%u hit / %u miss / %u stall), %u mirror + %u window loads\n",
+         lookups ? 100.0 * cs->hits / lookups : 0.0, (unsigned)cs->hits, (unsigned)cs->misses,
+         (unsigned)cs->stalls, (unsigned)cs->mirror_loads, (unsigned)cs->window_loads);
+  const SeamCacheStats* ss = seam_stats();
+  printf("seam cache  %u recorded, %u replayed, %u cancelled\n",
+         (unsigned)ss->records, (unsigned)ss->replays, (unsigned)ss->cancels);
+  rt_stats_t rt;
+  rt_get_stats(&rt);
+  if (rt.triggers) {
+    printf("trigger     %u taken, latency %u/%u/%u us min/avg/max (nominal %u), %u late, %u dropped\n",
+           (unsigned)rt.triggers, (unsigned)rt.min_us, (unsigned)rt.avg_us, (unsigned)rt.max_us,
+           (unsigned)rt.nominal_us, (unsigned)rt.late, (unsigned)rt.dropped);
+    printf("trigger     late by 0/1/2-3/4-7/8-15/16-31/32-63/64+ samples:");
+    for (uint32_t i = 0; i < RT_HIST_BINS; ++i) printf(" %u", (unsigned)rt.hist[i]);
+    printf("\n");
+  }
+  if (tc_locked()) {
+    const uint32_t* div = tc_division_samples();
+    printf("clock       %.2f BPM, loop snap %s, 1/16 = %u .. 4 bars = %u output samples\n",
+           tc_bpm(), tc_snap_enabled() ? "on" : "off", (unsigned)div[0], (unsigned)div[TC_DIVISIONS - 1]);
+  }
+  if (stream_ms) {
+    ss_stats_t st;
+    ss_get_stats(&st);
+    printf("stream      %u frame window (%u chunks), loop cap %u frames, probe %s\n",
+           (unsigned)window_frames, (unsigned)(window_frames / SS_CHUNK_FRAMES),
+           (unsigned)ss_loop_capacity(), stream_ok ? "ok" : "too slow");
+    printf("stream      %u chunk loads, %u window moves, %u voice skips, %u primary underruns (%.1f ms), %u read errors\n",
+           (unsigned)st.loads, (unsigned)st.moves, (unsigned)st.skips, (unsigned)st.underruns,
+           st.underruns * block_us / 1000.0, (unsigned)st.read_errors);
+  }
+  rec_stats_t rs;
+  rec_get_stats(&rs);
+  if (rs.takes || rs.overdubs || rs.aborted) {
+    printf("recorder    %u take(s), last %u frames; %u overdub pass(es), %u aborted, %u stalls\n",
+           (unsigned)rs.takes, (unsigned)rs.last_frames, (unsigned)rs.overdubs, (unsigned)rs.aborted,
+           (unsigned)rs.stalls);
+  }
+  dly_stats_t ds;
+  dly_get_stats(&ds);
+  if (ds.blocks) {
+    printf("delay       %u blocks, %u ms free time, tempo sync %s, %u stalls\n",
+           (unsigned)ds.blocks, (unsigned)dly_time_ms(), dly_sync() ? "on" : "off", (unsigned)ds.stalls);
+  }
+  gr_stats_t gs;
+  gr_get_stats(&gs);
+  if (gs.spawned) {
+    printf("granular    %u grains, %u dropped, peak %u at once, last %u samples long\n",
+           (unsigned)gs.spawned, (unsigned)gs.dropped, (unsigned)gs.peak, (unsigned)gs.length);
+  }
+  if (show_profile) {
+    // Last published snapshot (every PROF_PUBLISH_BLOCKS blocks, all passes)
+    ProfSnapshot snap;
+    prof_get_snapshot(&snap);
+    char line[64];
+    for (uint32_t i = 0; prof_format_line(&snap, i, line, sizeof(line)); ++i) printf("profile     %s\n", line);
+  }
+  if (out_path) printf("wrote       %s\n", out_path);
+
+  free(block_ns);
+  sf::storage_release_sample_q15_psram();  // The source or window, or a take that replaced it
+  if (window) free(samples);               // The "card"
+  return 0;
+}
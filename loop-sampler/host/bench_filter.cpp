@@ -0,0 +1,134 @@
+/**
+ * @file bench_filter.cpp
+ * @brief Micro-benchmark: 8-pole per-sample lowpass vs the 4-pole block ladder
+ *
+ * Times both filters over a block-sized loop with the cutoff knob swept, then
+ * measures the 4-pole ladder's gain for sines an octave below, at and above
+ * its cutoff, at no, half and full resonance. A full-scale square at full
+ * resonance checks that the loop stays bounded.
+ *
+ *   make bench-filter
+ *
+ * @author Brian Varren
+ * @version 1.0
+ * @date 2025
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <math.h>
+#include "ladder_filter.h"
+#include "host_cycles.h"
+
+static const float    RATE   = 48000.0f;
+static const uint32_t BLOCK  = 64;
+static const uint32_t BLOCKS = 1u << 15;
+static int16_t s_buf[BLOCK];
+
+static void fill_noise(int16_t* buf, uint32_t n, uint32_t* seed) {
+  for (uint32_t i = 0; i < n; ++i) {
+    *seed = *seed * 1664525u + 1013904223u;
+    buf[i] = (int16_t)((int32_t)(*seed >> 16) - 32768) / 2;
+  }
+}
+
+// Knob position (0..4095) swept once up and down over the run
+static uint16_t sweep_knob(uint32_t blk) {
+  const uint32_t p = (blk * 2u * 4095u) / BLOCKS;
+  return (uint16_t)(p <= 4095u ? p : 8190u - p);
+}
+
+__attribute__((noinline))
+static int64_t run_8pole(void) {
+  Ladder8PoleLowpassFilter f;
+  uint32_t seed = 1;
+  uint64_t cycles = 0;
+  volatile int32_t sink = 0;
+  for (uint32_t blk = 0; blk < BLOCKS; ++blk) {
+    fill_noise(s_buf, BLOCK, &seed);
+    const uint64_t c0 = host_cycles();
+    const uint16_t coeff = adc_to_ladder_coefficient(sweep_knob(blk));
+    for (uint32_t i = 0; i < BLOCK; ++i) s_buf[i] = f.process(s_buf[i], coeff);
+    cycles += host_cycles() - c0;
+    sink = sink + s_buf[BLOCK - 1];
+  }
+  (void)sink;
+  return (int64_t)cycles;
+}
+
+__attribute__((noinline))
+static int64_t run_4pole(uint16_t resonance_q12) {
+  Ladder4PoleFilter f;
+  uint32_t seed = 1;
+  uint64_t cycles = 0;
+  volatile int32_t sink = 0;
+  for (uint32_t blk = 0; blk < BLOCKS; ++blk) {
+    fill_noise(s_buf, BLOCK, &seed);
+    const uint64_t c0 = host_cycles();
+    Ladder4Coeffs c;
+    ladder4_coeffs(sweep_knob(blk), resonance_q12, RATE, &c);
+    f.set_target(c, BLOCK);
+    f.process_block(s_buf, BLOCK);
+    cycles += host_cycles() - c0;
+    sink = sink + s_buf[BLOCK - 1];
+  }
+  (void)sink;
+  return (int64_t)cycles;
+}
+
+// Steady-state gain in dB of a sine at `hz` through a fixed cutoff
+static double gain_db(uint16_t cutoff_q12, uint16_t resonance_q12, double hz) {
+  Ladder4PoleFilter f;
+  Ladder4Coeffs c;
+  ladder4_coeffs(cutoff_q12, resonance_q12, RATE, &c);
+  const double amp = 4096.0;
+  double in2 = 0.0, out2 = 0.0;
+  uint32_t n = 0;
+  for (uint32_t blk = 0; blk < 2048u; ++blk) {
+    for (uint32_t i = 0; i < BLOCK; ++i, ++n) s_buf[i] = (int16_t)lrint(amp * sin(2.0 * M_PI * hz * n / RATE));
+    int16_t x[BLOCK];
+    for (uint32_t i = 0; i < BLOCK; ++i) x[i] = s_buf[i];
+    f.set_target(c, BLOCK);
+    f.process_block(s_buf, BLOCK);
+    if (blk < 1024u) continue;  // Settle
+    for (uint32_t i = 0; i < BLOCK; ++i) {
+      in2 += (double)x[i] * x[i];
+      out2 += (double)s_buf[i] * s_buf[i];
+    }
+  }
+  return 10.0 * log10((out2 + 1e-9) / in2);
+}
+
+int main() {
+  const double n = (double)BLOCKS * BLOCK;
+  printf("lowpass, %u blocks of %u, cutoff swept (%s per sample)\n", BLOCKS, BLOCK, HOST_CYCLES_NAME);
+  printf("  8-pole per-sample        %6.2f\n", (double)run_8pole() / n);
+  printf("  4-pole ladder, res 0     %6.2f\n", (double)run_4pole(0) / n);
+  printf("  4-pole ladder, res 2048  %6.2f\n", (double)run_4pole(2048) / n);
+
+  const uint16_t knobs[] = {1024, 2048, 3072};
+  const uint16_t res[] = {0, 2048, 4095};
+  printf("\n4-pole gain (dB) an octave below / at / an octave above the cutoff\n");
+  for (uint16_t k : knobs) {
+    const double fc = LADDER_MIN_HZ * exp2((double)k * 10.0 / 4096.0);
+    printf("  knob %4u (%6.0f Hz)", k, fc);
+    for (uint16_t r : res) {
+      printf("   res %4u: %6.1f %6.1f %6.1f", r, gain_db(k, r, fc / 2.0), gain_db(k, r, fc), gain_db(k, r, fc * 2.0));
+    }
+    printf("\n");
+  }
+
+  // Full-scale square into full resonance: the tanh feedback keeps it bounded
+  Ladder4PoleFilter f;
+  Ladder4Coeffs c;
+  ladder4_coeffs(2048, 4095, RATE, &c);
+  int32_t peak = 0;
+  for (uint32_t blk = 0; blk < 4096u; ++blk) {
+    for (uint32_t i = 0; i < BLOCK; ++i) s_buf[i] = ((blk * BLOCK + i) / 80u) & 1u ? 32767 : -32768;
+    f.set_target(c, BLOCK);
+    f.process_block(s_buf, BLOCK);
+    for (uint32_t i = 0; i < BLOCK; ++i) peak = (abs(s_buf[i]) > peak) ? abs(s_buf[i]) : peak;
+  }
+  printf("\nfull-scale square, knob 2048, res 4095: peak %d\n", (int)peak);
+  return 0;
+}
@@ -0,0 +1,107 @@
+/**
+ * @file bench_interp.cpp
+ * @brief Micro-benchmark: cost and accuracy of each interpolation mode
+ *
+ * Resamples a sine through every interp_kernel.h mode and reports cycles per
+ * output sample and the error against the exact sine, at a slow (LFO-like),
+ * unity-ish and fast increment. Taps are read straight from the buffer (the
+ * fast path in the engine), so this isolates the interpolation math.
+ *
+ *   make bench-interp
+ *
+ * @author Brian Varren
+ * @version 1.0
+ * @date 2025
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <math.h>
+#include "interp_kernel.h"
+#include "host_cycles.h"
+
+static const uint32_t LEN     = 1u << 16;
+static const uint32_t OUTPUTS = 1u << 21;
+static int16_t s_buf[LEN];
+
+// Host stand-in for the hardware blend (same math as host_stubs.cpp)
+static inline int16_t interp_linear8(const int16_t* x, uint32_t frac32) {
+  const uint16_t u0 = (uint16_t)(x[0] + 32768), u1 = (uint16_t)(x[1] + 32768);
+  const uint16_t mu = (uint16_t)(frac32 >> 24);
+  return (int16_t)((int32_t)(u0 + (((int32_t)u1 - (int32_t)u0) * mu >> 8)) - 32768);
+}
+
+template <interp_mode_t IM>
+__attribute__((noinline))
+static int64_t run(uint64_t inc_q32_32, double cycles_per_sample, double* err_db) {
+  uint64_t phase = (uint64_t)8 << 32;
+  const uint64_t wrap = (uint64_t)(LEN - 16) << 32;
+  volatile int64_t sink = 0;
+  double err2 = 0.0, sig2 = 0.0;
+  const uint64_t c0 = host_cycles();
+  for (uint32_t n = 0; n < OUTPUTS; ++n) {
+    const int16_t* x = s_buf + (phase >> 32);
+    const uint32_t f = (uint32_t)phase;
+    int16_t y;
+    if (IM == INTERP_LINEAR8)        y = interp_linear8(x, f);
+    else if (IM == INTERP_LINEAR16)  y = interp_linear16(x, f);
+    else if (IM == INTERP_HERMITE4)  y = interp_hermite4(x, f);
+    else                             y = interp_sinc8(x, f);
+    sink = sink + y;
+    phase += inc_q32_32;
+    if (phase >= wrap) phase -= wrap - ((uint64_t)8 << 32);
+  }
+  const int64_t cycles = (int64_t)(host_cycles() - c0);
+
+  // Accuracy pass (not timed)
+  phase = (uint64_t)8 << 32;
+  for (uint32_t n = 0; n < OUTPUTS / 8; ++n) {
+    const int16_t* x = s_buf + (phase >> 32);
+    const uint32_t f = (uint32_t)phase;
+    int16_t y;
+    if (IM == INTERP_LINEAR8)        y = interp_linear8(x, f);
+    else if (IM == INTERP_LINEAR16)  y = interp_linear16(x, f);
+    else if (IM == INTERP_HERMITE4)  y = interp_hermite4(x, f);
+    else                             y = interp_sinc8(x, f);
+    const double pos = (double)phase / 4294967296.0;
+    const double ref = 16384.0 * sin(2.0 * M_PI * cycles_per_sample * pos);
+    err2 += (y - ref) * (y - ref);
+    sig2 += ref * ref;
+    phase += inc_q32_32;
+    if (phase >= wrap) phase -= wrap - ((uint64_t)8 << 32);
+  }
+  *err_db = 10.0 * log10(err2 / sig2 + 1e-20);
+  (void)sink;
+  return cycles;
+}
+
+int main() {
+  interp_init_tables();
+
+  // Sine at 0.1 of the sample rate (4.8 kHz at 48 kHz) - a bright partial
+  const double cps = 0.1;
+  for (uint32_t i = 0; i < LEN; ++i) s_buf[i] = (int16_t)lrint(16384.0 * sin(2.0 * M_PI * cps * i));
+
+  const struct { const char* name; uint64_t inc; } speeds[] = {
+    {"0.01x (LFO)", (uint64_t)(0.01 * 4294967296.0)},
+    {"0.93x",       (uint64_t)(0.93 * 4294967296.0)},
+    {"3.7x",        (uint64_t)(3.7  * 4294967296.0)},
+  };
+
+  printf("interpolation, %u samples per run (%s per sample, error vs exact sine)\n", OUTPUTS, HOST_CYCLES_NAME);
+  for (const auto& s : speeds) {
+    double e[INTERP_COUNT];
+    const int64_t c[INTERP_COUNT] = {
+      run<INTERP_LINEAR8>(s.inc, cps, &e[0]),
+      run<INTERP_LINEAR16>(s.inc, cps, &e[1]),
+      run<INTERP_HERMITE4>(s.inc, cps, &e[2]),
+      run<INTERP_SINC8>(s.inc, cps, &e[3]),
+    };
+    static const char* names[INTERP_COUNT] = {"linear8", "linear16", "hermite4", "sinc8"};
+    printf("  %s\n", s.name);
+    for (uint32_t m = 0; m < INTERP_COUNT; ++m) {
+      printf("    %-9s %6.2f   %7.1f dB\n", names[m], (double)c[m] / OUTPUTS, e[m]);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,112 @@
+/**
+ * @file bench_voice_kernel.cpp
+ * @brief Micro-benchmark: legacy float increment path vs fixed-point voice kernel
+ *
+ * Times just the per-sample increment and edge-fade work that ae_render_block()
+ * does for one voice, isolated from fetch, mixing and effects, so the saving
+ * from voice_kernel.h is visible on its own. The legacy functions are verbatim
+ * copies of the float code that used to live in audio_engine_render.cpp.
+ *
+ *   make bench-kernel
+ *
+ * @author Brian Varren
+ * @version 1.0
+ * @date 2025
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <math.h>
+#include "voice_kernel.h"
+#include "host_cycles.h"
+
+static const uint32_t BLOCK  = 16;
+static const uint32_t BLOCKS = 200000;
+
+// ── Legacy (float) path ──────────────────────────────────────────────────
+static float base_ratio = 1.0f;
+static float tzfm_depth = 0.0f;
+static float modulator_smoothed = 0.0f;
+static const float MODULATOR_SMOOTHING = 0.85f;
+
+__attribute__((noinline))
+static int64_t legacy_calculate_increment(uint16_t adc_fm_raw, bool is_reverse) {
+  int64_t base_inc = (int64_t)(base_ratio * (double)(1ULL << 32));
+  if (is_reverse) base_inc = -base_inc;
+  if (tzfm_depth > 0.001f) {
+    float raw_mod = ((float)adc_fm_raw - 2048.0f) / 2048.0f;
+    raw_mod = fmaxf(-1.0f, fminf(1.0f, raw_mod));
+    modulator_smoothed = MODULATOR_SMOOTHING * modulator_smoothed +
+                         (1.0f - MODULATOR_SMOOTHING) * raw_mod;
+    float modulated = (float)base_inc * (1.0f + modulator_smoothed * tzfm_depth);
+    base_inc = (int64_t)modulated;
+  }
+  const int64_t MAX_INC = (1LL << 37), MIN_INC = -(1LL << 37);
+  if (base_inc > MAX_INC) base_inc = MAX_INC;
+  if (base_inc < MIN_INC) base_inc = MIN_INC;
+  return base_inc;
+}
+
+__attribute__((noinline))
+static int16_t legacy_edge_fade(int16_t sample, uint32_t distance_from_end, bool near_end) {
+  float additional_fade = 1.0f;
+  if (near_end) {
+    additional_fade = (float)distance_from_end / 7.0f;
+    additional_fade = fmaxf(0.0f, fminf(1.0f, additional_fade));
+  }
+  return (int16_t)(sample * additional_fade);
+}
+
+// ── Fixed-point path ─────────────────────────────────────────────────────
+static IncRamp ramp = {(int64_t)1 << 32, 0};
+
+__attribute__((noinline))
+static void kernel_retarget(uint16_t adc_fm_raw, uint16_t adc_depth) {
+  const int64_t target = vk_tzfm_increment((int64_t)1 << 32,
+                                           vk_adc_to_bipolar_q15(adc_fm_raw),
+                                           vk_adc_to_depth_q15(adc_depth));
+  vk_inc_retarget(&ramp, target, BLOCK);
+}
+
+__attribute__((noinline))
+static int16_t kernel_edge_fade(int16_t sample, uint32_t distance_from_end) {
+  return vk_edge_fade(sample, distance_from_end);
+}
+
+int main() {
+  volatile int64_t sink = 0;
+  volatile int16_t sink16 = 0;
+  const uint64_t n = (uint64_t)BLOCK * BLOCKS;
+
+  // Legacy: per-sample float increment + float fade
+  tzfm_depth = 0.5f;
+  uint64_t c0 = host_cycles();
+  for (uint32_t b = 0; b < BLOCKS; ++b) {
+    const uint16_t fm = (uint16_t)((b * 37u) & 4095u);
+    for (uint32_t i = 0; i < BLOCK; ++i) {
+      sink += legacy_calculate_increment(fm, false);
+      sink16 = legacy_edge_fade((int16_t)(i * 1000), i & 7u, true);
+    }
+  }
+  const uint64_t legacy = host_cycles() - c0;
+
+  // Fixed-point: block-rate retarget, per-sample ramp + integer fade
+  c0 = host_cycles();
+  for (uint32_t b = 0; b < BLOCKS; ++b) {
+    const uint16_t fm = (uint16_t)((b * 37u) & 4095u);
+    kernel_retarget(fm, 2048);
+    for (uint32_t i = 0; i < BLOCK; ++i) {
+      sink += vk_inc_next(&ramp);
+      sink16 = kernel_edge_fade((int16_t)(i * 1000), i & 7u);
+    }
+  }
+  const uint64_t fixed = host_cycles() - c0;
+
+  const double l = (double)legacy / n, f = (double)fixed / n;
+  printf("voice kernel, %llu samples (%s per sample)\n", (unsigned long long)n, HOST_CYCLES_NAME);
+  printf("  legacy float   %6.2f\n", l);
+  printf("  fixed-point    %6.2f\n", f);
+  printf("  saved          %6.2f  (%.0f%%)\n", l - f, l > 0 ? 100.0 * (l - f) / l : 0.0);
+  (void)sink; (void)sink16;
+  return 0;
+}
@@ -0,0 +1,37 @@
+/**
+ * @file host_cycles.h
+ * @brief Cycle counter for host benchmarks
+ *
+ * x86-64 reads the TSC, AArch64 the virtual counter; anything else falls back
+ * to CLOCK_MONOTONIC nanoseconds. TSC ticks at a fixed reference rate rather
+ * than the core clock, so treat the result as "host cycles" for before/after
+ * comparisons only.
+ *
+ * @author Brian Varren
+ * @version 1.0
+ * @date 2025
+ */
+
+#pragma once
+#include <stdint.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HOST_CYCLES_NAME "TSC cycles"
+static inline uint64_t host_cycles(void) { return __rdtsc(); }
+#elif defined(__aarch64__)
+#define HOST_CYCLES_NAME "CNTVCT ticks"
+static inline uint64_t host_cycles(void) {
+  uint64_t v;
+  __asm__ volatile ("mrs %0, cntvct_el0" : "=r"(v));
+  return v;
+}
+#else
+#define HOST_CYCLES_NAME "ns"
+static inline uint64_t host_cycles(void) {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+#endif
@@ -0,0 +1,205 @@
+/**
+ * @file host_stubs.cpp
+ * @brief Host implementations of DACless, ADCless, adc_filter, pico_interp, UI hooks
+ *        and the loader's card reads
+ *
+ * These replace the RP2350-specific translation units when the render path
+ * is compiled for Linux. Everything here is deliberately trivial: the goal
+ * is to feed ae_render_block() the same inputs the device would and capture
+ * exactly what it writes, not to emulate the peripherals.
+ *
+ * @author Brian Varren
+ * @version 1.0
+ * @date 2025
+ */
+
+#include <stdint.h>
+#include <math.h>
+#include "ADCless.h"
+#include "DACless.h"
+#include "adc_filter.h"
+#include "audio_engine.h"
+#include "pico_interp.h"
+#include "ui_input.h"
+#include "sf_globals_bridge.h"
+#include "reset_trigger.h"
+#include "zero_cross.h"
+#include "storage_loader.h"
+#include "storage_wav_meta.h"
+#include "host_stubs.h"
+
+// ── DACless ──────────────────────────────────────────────────────────────
+volatile uint16_t pwm_out_buf_L[AUDIO_BUFFER_DEPTH][AUDIO_BLOCK_SIZE];
+volatile uint16_t pwm_out_buf_R[AUDIO_BUFFER_DEPTH][AUDIO_BLOCK_SIZE];
+volatile uint16_t* out_buf_ptr_L = pwm_out_buf_L[0];
+volatile uint16_t* out_buf_ptr_R = pwm_out_buf_R[0];
+volatile int callback_flag_L = 0;
+volatile int callback_flag_R = 0;
+volatile uint32_t dma_block_count = 0;
+volatile uint32_t dma_block_timestamp_us = 0;
+int dma_chan_L[AUDIO_BUFFER_DEPTH];
+int dma_chan_R[AUDIO_BUFFER_DEPTH];
+
+// RP2350 default clk_sys (150 MHz) divided by the PWM wrap, as in DACless.cpp
+float audio_rate = 150000000.0f / (PWM_RESOLUTION - 1);
+
+void muteAudioOutput() {}
+void unmuteAudioOutput() {}
+void PWM_DMATransCpltCallbackL() {}
+void PWM_DMATransCpltCallbackR() {}
+void configurePWM_DMA_L() {}
+void configurePWM_DMA_R() {}
+void setBlockRenderIRQ(int) {}
+
+void host_next_output_block(const volatile uint16_t** out_l,
+                            const volatile uint16_t** out_r) {
+  // Same order as the device's render IRQ: completion n frees buffer n % depth
+  const uint32_t b = dma_block_count++ % AUDIO_BUFFER_DEPTH;
+  out_buf_ptr_L = pwm_out_buf_L[b];
+  out_buf_ptr_R = pwm_out_buf_R[b];
+  if (out_l) *out_l = out_buf_ptr_L;
+  if (out_r) *out_r = out_buf_ptr_R;
+}
+
+// ── ADCless / adc_filter ─────────────────────────────────────────────────
+volatile uint16_t adc_results_buf[NUM_ADC_INPUTS];
+volatile uint16_t* adc_results_ptr[1] = {adc_results_buf};
+int adc_samp_chan, adc_ctrl_chan;
+
+static uint16_t s_knobs[NUM_ADC_INPUTS];
+
+void configureADC_DMA() {}
+
+// Audio-rate PM stream: off until the harness sets an oscillator, so the
+// render falls back to one adc_results_buf[ADC_PM_CH] read per block.
+static double   s_pm_osc_hz = 0.0;
+static double   s_pm_osc_amp = 0.0;
+static double   s_pm_osc_phase = 0.0;
+static uint16_t s_pm_block[AUDIO_BLOCK_SIZE];
+
+const uint16_t* adc_capture_next_block(uint8_t ch) {
+  if (s_pm_osc_amp <= 0.0 || ch != ADC_PM_CH) return nullptr;
+  const double step = 2.0 * M_PI * s_pm_osc_hz / (double)audio_rate;
+  for (uint32_t i = 0; i < AUDIO_BLOCK_SIZE; ++i) {
+    const long v = lround((double)s_knobs[ch] + s_pm_osc_amp * sin(s_pm_osc_phase));
+    s_pm_block[i] = (uint16_t)(v < 0 ? 0 : v > 4095 ? 4095 : v);
+    s_pm_osc_phase += step;
+    if (s_pm_osc_phase >= 2.0 * M_PI) s_pm_osc_phase -= 2.0 * M_PI;
+  }
+  return s_pm_block;
+}
+
+// Knobs write adc_results_buf[] directly (host_set_knob())
+void adc_capture_refresh_controls(void) {}
+
+const uint16_t* adc_capture_block(uint8_t ch) {
+  return (s_pm_osc_amp > 0.0 && ch == ADC_PM_CH) ? s_pm_block : nullptr;
+}
+
+void adc_capture_get_stats(adc_capture_stats_t* out) {
+  out->blocks = 0;
+  out->resyncs = 0;
+  out->frame_hz = (s_pm_osc_amp > 0.0) ? audio_rate : 0.0f;
+}
+
+void host_set_pm_osc(double hz, double amp_q12) {
+  s_pm_osc_hz = hz;
+  s_pm_osc_amp = amp_q12;
+}
+
+// Scripted knobs are already "clean", so the bank passes them through.
+void adc_filter_init(float, float, uint32_t) {}
+void adc_filter_update_from_dma(void) {}
+
+uint16_t adc_filter_get(uint8_t ch) {
+  if (ch >= NUM_ADC_INPUTS) return 0;
+  return s_knobs[ch];
+}
+
+void host_set_knob(uint8_t ch, uint16_t value_q12) {
+  if (ch >= NUM_ADC_INPUTS) return;
+  if (value_q12 > 4095u) value_q12 = 4095u;
+  s_knobs[ch] = value_q12;
+  adc_results_buf[ch] = value_q12;
+}
+
+uint16_t host_get_knob(uint8_t ch) {
+  return (ch < NUM_ADC_INPUTS) ? s_knobs[ch] : 0;
+}
+
+// ── pico_interp ──────────────────────────────────────────────────────────
+// Mirrors the interpolator blend mode: base0 + (base1 - base0) * alpha / 256,
+// where alpha is the low 8 bits of accum1.
+void setupInterpolators() {}
+
+uint16_t interpolate(uint16_t x, uint16_t y, uint16_t mu_scaled) {
+  const int32_t d = (int32_t)y - (int32_t)x;
+  return (uint16_t)((int32_t)x + ((d * (int32_t)(mu_scaled & 0xFFu)) >> 8));
+}
+
+uint16_t interpolate1(uint16_t x, uint16_t y, uint16_t mu_scaled) {
+  return interpolate(x, y, mu_scaled);
+}
+
+// ── UI / engine hooks used by the render path ────────────────────────────
+static uint8_t   s_octave = 4;
+static ae_mode_t s_mode   = AE_MODE_FORWARD;
+static uint32_t  s_led_blinks = 0;
+
+namespace sf {
+uint8_t ui_get_octave_position() { return s_octave; }
+}
+
+void host_set_octave(uint8_t pos) { s_octave = (pos > 7u) ? 7u : pos; }
+void host_set_mode(ae_mode_t m) { s_mode = m; }
+
+ae_mode_t audio_engine_get_mode(void) { return s_mode; }
+void audio_engine_loop_led_blink(void) { ++s_led_blinks; }
+uint32_t host_loop_led_blinks(void) { return s_led_blinks; }
+
+void host_fire_reset_trigger(uint32_t t_us) { rt_record_edge(t_us); }
+void host_set_load_shed(uint8_t level) { g_ae_load_shed = (level > AE_SHED_MAX) ? AE_SHED_MAX : level; }
+
+// Engine globals normally defined in audio_engine.cpp
+volatile uint64_t g_phase_q32_32 = 0;
+uint64_t g_inc_base_q32_32 = (1ULL << 32);
+volatile bool g_reset_trigger_pending = false;
+volatile uint8_t g_ae_load_shed = 0;
+
+// Sample buffer globals normally defined in loop-sampler.ino
+uint8_t*    audioData = nullptr;
+uint32_t    audioDataSize = 0;
+uint32_t    audioSampleCount = 0;
+uint8_t     audioChannels = 1;
+sf::WavInfo currentWav;
+
+// ── storage_loader ───────────────────────────────────────────────────────
+// storage_loader.cpp is built as is; only its card reads are missing. The
+// harness publishes its source through storage_adopt_sample_q15_psram() or
+// storage_adopt_stream_q15_psram() and renders audioData itself each block,
+// so binding only resets the loop boundaries, as on the device.
+void playback_bind_loaded_buffer(uint32_t, uint32_t, uint32_t, uint8_t) {
+  ae_reset_loop_boundaries_flag();
+}
+
+// The harness renders between loader calls, so no block is ever in flight
+void playback_unbind_buffer(void) {}
+
+namespace sf {
+bool wav_read_info(const char*, WavInfo&) { return false; }
+
+bool wav_decode_q15_into_buffer(const char*, int16_t*, uint32_t, uint32_t*, float*, uint8_t, ZeroCrossIndex*) {
+  return false;
+}
+
+void wav_stream_close(void) {}
+}
+
+// ── Clock ────────────────────────────────────────────────────────────────
+static uint64_t s_clock_us = 0;
+
+void host_clock_set_us(uint64_t us) { s_clock_us = us; }
+
+uint32_t millis(void)     { return (uint32_t)(s_clock_us / 1000u); }
+uint32_t micros(void)     { return (uint32_t)s_clock_us; }
+uint32_t time_us_32(void) { return (uint32_t)s_clock_us; }
@@ -0,0 +1,49 @@
+/**
+ * @file host_stubs.h
+ * @brief Control surface for the host-side stand-ins of the hardware drivers
+ *
+ * On the device the render path reads knobs through adc_filter_get(), the
+ * raw PM channel through adc_results_buf[], the octave switch through
+ * sf::ui_get_octave_position() and writes PWM words through out_buf_ptr_L/R.
+ * The host build links against stubs of those symbols instead; this header
+ * lets the harness drive them from a scripted timeline.
+ *
+ * @author Brian Varren
+ * @version 1.0
+ * @date 2025
+ */
+
+#pragma once
+#include <stdint.h>
+#include "audio_engine.h"
+
+// ── Simulated controls ────────────────────────────────────────────────────
+// Sets both the filtered value returned by adc_filter_get(ch) and the raw
+// DMA slot adc_results_buf[ch]. Values are 12-bit (0..4095).
+void host_set_knob(uint8_t ch, uint16_t value_q12);
+uint16_t host_get_knob(uint8_t ch);
+
+// Streams the PM input at audio rate through adc_capture_next_block() (and
+// adc_capture_block(), which the recorder reads it through): the
+// pm knob plus a sine of amp_q12 (12-bit counts) at hz. amp 0 turns the
+// stream off again and the render reads the pm knob once per block.
+void host_set_pm_osc(double hz, double amp_q12);
+
+void host_set_octave(uint8_t pos);            // 0 = LFO, 4 = unity
+void host_set_mode(ae_mode_t m);              // what audio_engine_get_mode() returns
+void host_fire_reset_trigger(uint32_t t_us);  // rising edge on GPIO18 at time_us_32() == t_us
+void host_set_load_shed(uint8_t level);       // what missed deadlines do on the device
+
+// ── Simulated time ───────────────────────────────────────────────────────
+// millis()/micros()/time_us_32() report this clock; the harness advances it
+// by one block period per rendered block.
+void host_clock_set_us(uint64_t us);
+
+// ── Output routing ───────────────────────────────────────────────────────
+// Points out_buf_ptr_L/R at the next buffer of the stub DMA rings and
+// returns them so the harness can read back what the engine wrote.
+void host_next_output_block(const volatile uint16_t** out_l,
+                            const volatile uint16_t** out_r);
+
+// Number of times the engine asked for a loop LED blink (loop wraps + triggers).
+uint32_t host_loop_led_blinks(void);
@@ -0,0 +1,180 @@
+/**
+ * @file host_wav.cpp
+ * @brief Minimal WAV I/O for the host render harness
+ *
+ * @author Brian Varren
+ * @version 1.0
+ * @date 2025
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "host_wav.h"
+#include "storage_loader.h"
+
+static uint32_t rd_u32(const uint8_t* p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+static uint16_t rd_u16(const uint8_t* p) {
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+// One channel of one frame as a float in -1..+1 (same scaling as the device decoder)
+static float pcm_to_float(const uint8_t* p, int bps) {
+  if (bps == 8)  return ((int)p[0] - 128) / 128.0f;
+  if (bps == 16) return (float)(int16_t)rd_u16(p) / 32768.0f;
+  if (bps == 24) {
+    int32_t v = (int32_t)((uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16));
+    if (v & 0x00800000) v |= (int32_t)0xFF000000;
+    return (float)v / 8388608.0f;
+  }
+  return (float)(int32_t)rd_u32(p) / 2147483648.0f;
+}
+
+bool host_wav_read_q15(const char* path,
+                       int16_t** out_q15,
+                       uint32_t* out_count,
+                       uint32_t* out_sample_rate,
+                       uint8_t load_flags,
+                       uint8_t* out_channels)
+{
+  *out_q15 = nullptr; *out_count = 0; *out_sample_rate = 0;
+  if (out_channels) *out_channels = 1;
+
+  FILE* f = fopen(path, "rb");
+  if (!f) return false;
+  fseek(f, 0, SEEK_END);
+  long size = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  if (size < 44) { fclose(f); return false; }
+  uint8_t* file = (uint8_t*)malloc((size_t)size);
+  if (!file) { fclose(f); return false; }
+  const bool read_ok = fread(file, 1, (size_t)size, f) == (size_t)size;
+  fclose(f);
+  if (!read_ok || memcmp(file, "RIFF", 4) || memcmp(file + 8, "WAVE", 4)) { free(file); return false; }
+
+  uint16_t channels = 0, bps = 0;
+  uint32_t rate = 0, data_off = 0, data_size = 0;
+  for (long pos = 12; pos + 8 <= size; ) {
+    const uint8_t* ch = file + pos;
+    const uint32_t ck = rd_u32(ch + 4);
+    if (!memcmp(ch, "fmt ", 4) && ck >= 16) {
+      channels = rd_u16(ch + 10);
+      rate     = rd_u32(ch + 12);
+      bps      = rd_u16(ch + 22);
+    } else if (!memcmp(ch, "data", 4)) {
+      data_off  = (uint32_t)pos + 8u;
+      data_size = ck;
+      if ((long)(data_off + data_size) > size) data_size = (uint32_t)(size - data_off);
+    }
+    pos += 8 + (long)ck + (long)(ck & 1u);
+  }
+
+  const uint32_t frame_bytes = (bps / 8u) * channels;
+  if (!data_off || !frame_bytes || (bps != 8 && bps != 16 && bps != 24 && bps != 32)) {
+    free(file);
+    return false;
+  }
+
+  const uint32_t frames = data_size / frame_bytes;
+  const uint32_t out_ch = ((load_flags & SF_LOAD_STEREO) && channels == 2) ? 2u : 1u;
+  const uint32_t values = frames * out_ch;
+  float* pcm = (float*)malloc(sizeof(float) * (values ? values : 1));
+  int16_t* q15 = (int16_t*)malloc(sizeof(int16_t) * (values ? values : 1));
+  if (!pcm || !q15) { free(pcm); free(q15); free(file); return false; }
+
+  // Pass 1: downmix (or keep L/R) and find the peak
+  float peak = 0.0f;
+  const uint8_t* p = file + data_off;
+  for (uint32_t i = 0; i < frames; ++i, p += frame_bytes) {
+    float l = pcm_to_float(p, bps);
+    float r = (channels >= 2) ? pcm_to_float(p + bps / 8, bps) : l;
+    if (out_ch == 2) {
+      pcm[2 * i] = l;
+      pcm[2 * i + 1] = r;
+      float a = l >= 0.0f ? l : -l;
+      float b = r >= 0.0f ? r : -r;
+      if (a > peak) peak = a;
+      if (b > peak) peak = b;
+      continue;
+    }
+    float m = (channels >= 2) ? 0.5f * (l + r) : l;
+    pcm[i] = m;
+    float a = m >= 0.0f ? m : -m;
+    if (a > peak) peak = a;
+  }
+
+  // Pass 2: -3 dB normalize into Q15 (never boosts above unity gain)
+  float gain = 1.0f;
+  if (peak > 0.000001f) {
+    const float g = 0.7071f / peak;
+    gain = (g > 1.0f) ? 1.0f : g;
+  }
+  for (uint32_t i = 0; i < values; ++i) {
+    float s = pcm[i] * gain * 32767.0f;
+    int32_t q = (int32_t)(s + (s >= 0 ? 0.5f : -0.5f));
+    if (q >  32767) q =  32767;
+    if (q < -32768) q = -32768;
+    q15[i] = (int16_t)q;
+  }
+
+  free(pcm);
+  free(file);
+  *out_q15 = q15;
+  *out_count = frames;
+  *out_sample_rate = rate;
+  if (out_channels) *out_channels = (uint8_t)out_ch;
+  return true;
+}
+
+// ── Writer ───────────────────────────────────────────────────────────────
+struct HostWavWriter {
+  FILE*    f;
+  uint16_t channels;
+  uint32_t frames;
+};
+
+static void wr_u32(FILE* f, uint32_t v) {
+  uint8_t b[4] = {(uint8_t)v, (uint8_t)(v >> 8), (uint8_t)(v >> 16), (uint8_t)(v >> 24)};
+  fwrite(b, 1, 4, f);
+}
+static void wr_u16(FILE* f, uint16_t v) {
+  uint8_t b[2] = {(uint8_t)v, (uint8_t)(v >> 8)};
+  fwrite(b, 1, 2, f);
+}
+
+HostWavWriter* host_wav_open(const char* path, uint32_t sample_rate, uint16_t channels) {
+  FILE* f = fopen(path, "wb");
+  if (!f) return nullptr;
+  HostWavWriter* w = (HostWavWriter*)calloc(1, sizeof(HostWavWriter));
+  if (!w) { fclose(f); return nullptr; }
+  w->f = f;
+  w->channels = channels;
+
+  fwrite("RIFF", 1, 4, f); wr_u32(f, 0); fwrite("WAVE", 1, 4, f);
+  fwrite("fmt ", 1, 4, f); wr_u32(f, 16);
+  wr_u16(f, 1);                                  // PCM
+  wr_u16(f, channels);
+  wr_u32(f, sample_rate);
+  wr_u32(f, sample_rate * channels * 2u);        // byte rate
+  wr_u16(f, (uint16_t)(channels * 2u));          // block align
+  wr_u16(f, 16);
+  fwrite("data", 1, 4, f); wr_u32(f, 0);
+  return w;
+}
+
+void host_wav_write(HostWavWriter* w, const int16_t* interleaved, uint32_t frames) {
+  if (!w) return;
+  for (uint32_t i = 0; i < frames * w->channels; ++i) wr_u16(w->f, (uint16_t)interleaved[i]);
+  w->frames += frames;
+}
+
+void host_wav_close(HostWavWriter* w) {
+  if (!w) return;
+  const uint32_t data_bytes = w->frames * w->channels * 2u;
+  fseek(w->f, 4, SEEK_SET);  wr_u32(w->f, 36u + data_bytes);
+  fseek(w->f, 40, SEEK_SET); wr_u32(w->f, data_bytes);
+  fclose(w->f);
+  free(w);
+}
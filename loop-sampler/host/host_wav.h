@@ -0,0 +1,33 @@
+/**
+ * @file host_wav.h
+ * @brief Minimal WAV I/O for the host render harness
+ *
+ * The reader mirrors storage_wav_decode.cpp closely enough that a file
+ * renders the same on the host as after loading from SD: PCM 8/16/24/32-bit,
+ * mono or stereo, downmixed to mono (or kept as interleaved L/R with
+ * SF_LOAD_STEREO) and peak-normalized to -3 dB.
+ *
+ * @author Brian Varren
+ * @version 1.0
+ * @date 2025
+ */
+
+#pragma once
+#include <stdint.h>
+
+// Decode a PCM WAV into a malloc'd Q15 buffer. Caller frees *out_q15.
+// out_count is in frames; out_channels (optional) is 2 only when a stereo
+// file was loaded with SF_LOAD_STEREO in load_flags.
+bool host_wav_read_q15(const char* path,
+                       int16_t** out_q15,
+                       uint32_t* out_count,
+                       uint32_t* out_sample_rate,
+                       uint8_t load_flags = 0u,
+                       uint8_t* out_channels = nullptr);
+
+// Streaming 16-bit PCM writer. Header sizes are patched on close.
+struct HostWavWriter;
+
+HostWavWriter* host_wav_open(const char* path, uint32_t sample_rate, uint16_t channels);
+void host_wav_write(HostWavWriter* w, const int16_t* interleaved, uint32_t frames);
+void host_wav_close(HostWavWriter* w);
@@ -0,0 +1,22 @@
+/**
+ * @file Arduino.h
+ * @brief Host stand-in for the Arduino core header
+ *
+ * Only the pieces the render path touches are provided. Timing functions
+ * are backed by the harness clock so scripted timelines stay deterministic.
+ *
+ * @author Brian Varren
+ * @version 1.0
+ * @date 2025
+ */
+
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+uint32_t millis(void);
+uint32_t micros(void);
+uint32_t time_us_32(void);
@@ -0,0 +1,14 @@
+/**
+ * @file sync.h
+ * @brief Host stand-in for pico-sdk hardware/sync.h
+ *
+ * @author Brian Varren
+ * @version 1.0
+ * @date 2025
+ */
+
+#pragma once
+
+static inline void __compiler_memory_barrier(void) {
+  __asm__ volatile ("" : : : "memory");
+}
@@ -11,6 +11,88 @@
 volatile uint16_t adc_results_buf[NUM_ADC_INPUTS] __attribute__((aligned(NUM_ADC_INPUTS * sizeof(uint16_t))));
 volatile uint16_t* adc_results_ptr[1] = {adc_results_buf};
 int adc_samp_chan, adc_ctrl_chan;
+volatile uint16_t adc_capture_ring[ADC_CAPTURE_RING_FRAMES * NUM_ADC_INPUTS] __attribute__((aligned(4)));
+static volatile uint16_t* adc_capture_ptr[1] = {adc_capture_ring};
+
+// ── PM capture state (reader runs on core 0 only) ──────────────────────────────
+#define CAPTURE_BLOCK_FRAMES (AUDIO_BLOCK_SIZE * ADC_PM_CAPTURE_RATIO)
+static bool     s_capture_running = false;
+static uint32_t s_capture_read = 0;            // Next frame to read (0..RING-1)
+static uint16_t s_capture_pm[AUDIO_BLOCK_SIZE];
+static uint8_t  s_capture_pm_ch = 0xFF;        // Channel in s_capture_pm
+static uint32_t s_capture_block_read = 0;      // First frame of the block last taken
+static uint16_t s_capture_other[AUDIO_BLOCK_SIZE];
+static volatile uint32_t s_capture_blocks = 0;
+static volatile uint32_t s_capture_resyncs = 0;
+static float    s_capture_frame_hz = 0.0f;
+
+static_assert((ADC_CAPTURE_RING_FRAMES & (ADC_CAPTURE_RING_FRAMES - 1)) == 0,
+              "ADC_CAPTURE_RING_FRAMES must be a power of two");
+
+// Frames the DMA has completed in the current pass over the ring
+static inline uint32_t capture_write_frame() {
+    const uint32_t total = ADC_CAPTURE_RING_FRAMES * NUM_ADC_INPUTS;
+    const uint32_t remaining = dma_hw->ch[adc_samp_chan].transfer_count;
+    return ((total - remaining) / NUM_ADC_INPUTS) & (ADC_CAPTURE_RING_FRAMES - 1);
+}
+
+// One output block of channel ch from the frames starting at ring frame r
+static void capture_extract(uint32_t r, uint8_t ch, uint16_t* out) {
+    const uint32_t mask = ADC_CAPTURE_RING_FRAMES - 1;
+    for (uint32_t i = 0; i < AUDIO_BLOCK_SIZE; ++i) {
+        uint32_t sum = 0;
+        for (uint32_t k = 0; k < ADC_PM_CAPTURE_RATIO; ++k) {
+            sum += adc_capture_ring[r * NUM_ADC_INPUTS + ch] & 0x0FFFu;
+            r = (r + 1) & mask;
+        }
+        out[i] = (uint16_t)(sum / ADC_PM_CAPTURE_RATIO);
+    }
+}
+
+const uint16_t* adc_capture_next_block(uint8_t ch) {
+    if (!s_capture_running) return nullptr;
+
+    const uint32_t mask = ADC_CAPTURE_RING_FRAMES - 1;
+    const uint32_t w = capture_write_frame();
+    const uint32_t avail = (w - s_capture_read) & mask;
+
+    // Keep between one block and (ring - one block) behind the writer; outside
+    // that the ADC and PWM clocks have drifted apart, so restart two blocks back
+    if (avail < CAPTURE_BLOCK_FRAMES || avail > ADC_CAPTURE_RING_FRAMES - CAPTURE_BLOCK_FRAMES) {
+        s_capture_read = (w - 2 * CAPTURE_BLOCK_FRAMES) & mask;
+        s_capture_resyncs = s_capture_resyncs + 1;
+    }
+
+    s_capture_block_read = s_capture_read;
+    capture_extract(s_capture_read, ch, s_capture_pm);
+    s_capture_pm_ch = ch;
+    s_capture_read = (s_capture_read + CAPTURE_BLOCK_FRAMES) & mask;
+    s_capture_blocks = s_capture_blocks + 1;
+    return s_capture_pm;
+}
+
+void adc_capture_refresh_controls(void) {
+    if (!s_capture_running) return;  // DMA writes adc_results_buf[] itself
+
+    // Newest complete frame feeds the control filters
+    const uint32_t newest = (capture_write_frame() - 1) & (ADC_CAPTURE_RING_FRAMES - 1);
+    for (int c = 0; c < NUM_ADC_INPUTS; ++c) {
+        adc_results_buf[c] = adc_capture_ring[newest * NUM_ADC_INPUTS + c];
+    }
+}
+
+const uint16_t* adc_capture_block(uint8_t ch) {
+    if (!s_capture_running || !s_capture_blocks) return nullptr;
+    if (ch == s_capture_pm_ch) return s_capture_pm;
+    capture_extract(s_capture_block_read, ch, s_capture_other);
+    return s_capture_other;
+}
+
+void adc_capture_get_stats(adc_capture_stats_t* out) {
+    out->blocks = s_capture_blocks;
+    out->resyncs = s_capture_resyncs;
+    out->frame_hz = s_capture_frame_hz;
+}
 
 // Function definition
 void configureADC_DMA(){
@@ -29,7 +111,17 @@ void configureADC_DMA(){
     }
 
     adc_init();
+#if ADC_PM_CAPTURE
+    // Pace the round robin to 8 * ratio conversions per output sample. The
+    // divider is fractional, so the frame rate only drifts by the ADC/sys
+    // clock mismatch; the reader resyncs when that accumulates to a block.
+    float target_sps = (float)NUM_ADC_INPUTS * ADC_PM_CAPTURE_RATIO * audio_rate;
+    if (target_sps > ADC_CAPTURE_MAX_SPS) target_sps = ADC_CAPTURE_MAX_SPS;  // Ratio too high for this rate
+    adc_set_clkdiv((float)clock_get_hz(clk_adc) / target_sps - 1.0f);
+    s_capture_frame_hz = target_sps / (NUM_ADC_INPUTS * ADC_PM_CAPTURE_RATIO);
+#else
     adc_set_clkdiv(1);
+#endif
     adc_set_round_robin((1 << NUM_ADC_INPUTS) - 1);
     adc_select_input(0);
     adc_fifo_setup(true, true, 4, false, false);
@@ -53,7 +145,7 @@ void configureADC_DMA(){
         &samp_conf,
         nullptr,
         &adc_hw->fifo,
-        NUM_ADC_INPUTS,
+        ADC_PM_CAPTURE ? ADC_CAPTURE_RING_FRAMES * NUM_ADC_INPUTS : NUM_ADC_INPUTS,
         false
     );
 
@@ -68,10 +160,13 @@ void configureADC_DMA(){
         ctrl_chan,
         &ctrl_conf,
         &dma_hw->ch[samp_chan].al2_write_addr_trig,
-        adc_results_ptr,
+        ADC_PM_CAPTURE ? adc_capture_ptr : adc_results_ptr,  // Re-arm at the ring (or slot) start
         1,
         false
     );
+    adc_samp_chan = samp_chan;
+    adc_ctrl_chan = ctrl_chan;
     dma_channel_start(ctrl_chan);
     adc_run(true);
+    s_capture_running = ADC_PM_CAPTURE;
 }
\ No newline at end of file
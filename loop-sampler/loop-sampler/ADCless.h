@@ -26,6 +26,25 @@
  * - Channel 6: Effect 2 (future use)
  * - Channel 7: Reserved
  * 
+ * ## Audio-rate PM Capture
+ * 
+ * With ADC_PM_CAPTURE set, the ADC is no longer free-running. Its clock
+ * divider paces the round robin so that one frame of all 8 channels
+ * completes per output sample (times ADC_PM_CAPTURE_RATIO). DMA streams the
+ * frames into adc_capture_ring instead of overwriting one slot per channel.
+ * Once per block the renderer takes the next block of frames from the ring
+ * with adc_capture_next_block(). That gives it one PM (TZFM) sample per
+ * output sample. Before every block, rendered or not,
+ * adc_capture_refresh_controls() copies the newest frame into
+ * adc_results_buf[] for the control filters. The core never polls the ADC. The recorder (recorder.h)
+ * takes its input from the same frames with adc_capture_block().
+ * 
+ * The ADC clock is not derived from the PWM clock, so the reader keeps its
+ * own position in the ring. It follows the writer about two blocks behind,
+ * which absorbs render jitter. If clock drift moves the writer more than a
+ * block away from that point, the reader jumps back to it and counts a
+ * resync.
+ * 
  * ## Hardware Compatibility
  * 
  * The system supports both RP2040 and RP2350B microcontrollers with
@@ -37,10 +56,25 @@
  */
 
 #pragma once
+#include <stdint.h>
+#include "DACless.h"   // AUDIO_BLOCK_SIZE
 
 // ── ADC Configuration ──────────────────────────────────────────────────────────
 #define NUM_ADC_INPUTS      8  // Number of analog control inputs
 
+// ── PM Capture Configuration ───────────────────────────────────────────────────
+#ifndef ADC_PM_CAPTURE
+#define ADC_PM_CAPTURE          1   // 1 = stream all channels at the output rate (audio-rate TZFM)
+#endif
+#ifndef ADC_PM_CAPTURE_RATIO
+#define ADC_PM_CAPTURE_RATIO    1   // ADC frames per output sample, averaged (1, 2 or 4)
+#endif
+#define ADC_CAPTURE_RING_FRAMES (4u * AUDIO_BLOCK_SIZE * ADC_PM_CAPTURE_RATIO)  // Four blocks
+#define ADC_CAPTURE_MAX_SPS     500000.0f  // 48 MHz ADC clock / 96 cycles per conversion
+
+static_assert(ADC_PM_CAPTURE_RATIO == 1 || ADC_PM_CAPTURE_RATIO == 2 || ADC_PM_CAPTURE_RATIO == 4,
+              "ADC_PM_CAPTURE_RATIO must be 1, 2 or 4");
+
 // ── Hardware Target Selection ──────────────────────────────────────────────────
 // Uncomment the appropriate target for your hardware
 #define ADCLESS_RP2350B     // Olimex Pico2-XXL (RP2350B)
@@ -57,6 +91,13 @@
 extern volatile uint16_t adc_results_buf[NUM_ADC_INPUTS];  // DMA buffer for ADC results
 extern volatile uint16_t* adc_results_ptr[1];              // DMA pointer (must be array of 1)
 extern int adc_samp_chan, adc_ctrl_chan;                   // DMA channel assignments
+extern volatile uint16_t adc_capture_ring[ADC_CAPTURE_RING_FRAMES * NUM_ADC_INPUTS];  // PM capture frames
+
+typedef struct {
+  uint32_t blocks;      // Blocks taken from the ring
+  uint32_t resyncs;     // Reader jumped back to two blocks behind the writer
+  float    frame_hz;    // Achieved frame rate (0 = capture off)
+} adc_capture_stats_t;
 
 // ── ADC Interface Functions ────────────────────────────────────────────────────
 
@@ -66,4 +107,37 @@ extern int adc_samp_chan, adc_ctrl_chan;                   // DMA channel assign
  * Sets up the ADC and DMA system for continuous, non-blocking sampling
  * of all control inputs. Must be called during system initialization.
  */
-void configureADC_DMA();
\ No newline at end of file
+void configureADC_DMA();
+
+/**
+ * @brief Take the next output block of captured frames
+ * 
+ * Call once per rendered block (core 0). Returns AUDIO_BLOCK_SIZE samples of
+ * input `ch`, one per output sample (each the mean of ADC_PM_CAPTURE_RATIO
+ * conversions). Returns nullptr when capture is not running; the caller then
+ * reads adc_results_buf[ch] once per block as before.
+ */
+const uint16_t* adc_capture_next_block(uint8_t ch);
+
+/**
+ * @brief Copy the newest complete frame into adc_results_buf[]
+ * 
+ * Call once per block (core 0) before adc_filter_update_from_dma(), whatever
+ * the engine state. Does nothing when capture is not running (DMA then writes
+ * adc_results_buf[] directly).
+ */
+void adc_capture_refresh_controls(void);
+
+/**
+ * @brief The block last taken by adc_capture_next_block(), for input `ch`
+ * 
+ * Same frames, another channel (the recorder's input). Returns the same
+ * buffer when `ch` is the channel already taken, nullptr when capture is
+ * not running. Valid until the next call to either function.
+ */
+const uint16_t* adc_capture_block(uint8_t ch);
+
+/**
+ * @brief Copy the capture counters (any core)
+ */
+void adc_capture_get_stats(adc_capture_stats_t* out);
\ No newline at end of file
@@ -7,21 +7,26 @@
 #include "hardware/irq.h"
 #include "DACless.h"
 
-// Fixed a/b output buffers
-volatile uint16_t pwm_out_buf_a[AUDIO_BLOCK_SIZE] __attribute__((aligned(AUDIO_BLOCK_SIZE * sizeof(uint16_t))));
-volatile uint16_t pwm_out_buf_b[AUDIO_BLOCK_SIZE] __attribute__((aligned(AUDIO_BLOCK_SIZE * sizeof(uint16_t))));
-volatile uint16_t pwm_out_buf_c[AUDIO_BLOCK_SIZE] __attribute__((aligned(AUDIO_BLOCK_SIZE * sizeof(uint16_t))));
-volatile uint16_t pwm_out_buf_d[AUDIO_BLOCK_SIZE] __attribute__((aligned(AUDIO_BLOCK_SIZE * sizeof(uint16_t))));
+// Output buffer rings; each buffer is aligned to its own size for the DMA read ring
+#define AUDIO_BLOCK_BYTES (AUDIO_BLOCK_SIZE * sizeof(uint16_t))
+volatile uint16_t pwm_out_buf_L[AUDIO_BUFFER_DEPTH][AUDIO_BLOCK_SIZE] __attribute__((aligned(AUDIO_BLOCK_BYTES)));
+volatile uint16_t pwm_out_buf_R[AUDIO_BUFFER_DEPTH][AUDIO_BLOCK_SIZE] __attribute__((aligned(AUDIO_BLOCK_BYTES)));
 
-static const uint size_bits = 5; // 128 = 8
-static_assert((1<<size_bits) == AUDIO_BLOCK_SIZE * sizeof(uint16_t));
+// DMA read ring size (log2 bytes) derived from the block size: 32 B -> 5 ... 256 B -> 8
+static constexpr uint ring_bits(uint bytes) { return (bytes > 1u) ? 1u + ring_bits(bytes >> 1) : 0u; }
+static const uint size_bits = ring_bits(AUDIO_BLOCK_BYTES);
+static_assert((1u << size_bits) == AUDIO_BLOCK_BYTES, "block must be a power-of-two byte size");
 
 volatile uint16_t* out_buf_ptr_L;
 volatile uint16_t* out_buf_ptr_R;
 volatile int callback_flag_L;
 volatile int callback_flag_R;
+volatile uint32_t dma_block_count = 0;
+volatile uint32_t dma_block_timestamp_us = 0;
+static int s_block_irq = -1;  // IRQ pended on each completed block (-1 = none)
 
-int dma_chan_a, dma_chan_b, dma_chan_c, dma_chan_d;
+int dma_chan_L[AUDIO_BUFFER_DEPTH];
+int dma_chan_R[AUDIO_BUFFER_DEPTH];
 
 float audio_rate = clock_get_hz(clk_sys) / (PWM_RESOLUTION - 1);
 
@@ -41,140 +46,91 @@ void unmuteAudioOutput() {
 void PWM_DMATransCpltCallbackL(){
     uint32_t pending = dma_hw->ints1;  // Get all pending interrupts on IRQ 1
     uint32_t timestamp_us = time_us_32();
-    
-    // Handle the interrupt for channel A
-    if (pending & (1u << dma_chan_a)) {
-        dma_hw->ints1 = 1u << dma_chan_a; // clear the interrupt request
-        out_buf_ptr_L   = &pwm_out_buf_a[0];
-        callback_flag_L = 1;
+    uint32_t completed = 0;
+
+    // Handle the interrupt for each buffer in the ring
+    for (uint i = 0; i < AUDIO_BUFFER_DEPTH; ++i) {
+        if (pending & (1u << dma_chan_L[i])) {
+            dma_hw->ints1 = 1u << dma_chan_L[i]; // clear the interrupt request
+            if (s_block_irq < 0) out_buf_ptr_L = &pwm_out_buf_L[i][0];
+            callback_flag_L = 1;
+            completed++;
+        }
     }
 
-    // Handle the interrupt for channel B
-    if (pending & (1u << dma_chan_b)) {
-        dma_hw->ints1 = 1u << dma_chan_b; // clear the interrupt request
-        out_buf_ptr_L   = &pwm_out_buf_b[0];
-        callback_flag_L = 1;
+    // Hand the block to the render IRQ; the right channel's completion lands
+    // a few cycles later and must not trigger a second render
+    if (completed) {
+        dma_block_timestamp_us = timestamp_us;
+        dma_block_count += completed;
+        if (s_block_irq >= 0) irq_set_pending((uint)s_block_irq);
     }
 }
 
 void PWM_DMATransCpltCallbackR(){
-    uint32_t pending = dma_hw->ints0;  // Get all pending interrupts on IRQ 1
-    uint32_t timestamp_us = time_us_32();
-    
-    // Handle the interrupt for channel C
-    if (pending & (1u << dma_chan_c)) {
-        dma_hw->ints0 = 1u << dma_chan_c; // clear the interrupt request
-        out_buf_ptr_R   = &pwm_out_buf_c[0];
-        callback_flag_R = 1;
+    uint32_t pending = dma_hw->ints0;  // Get all pending interrupts on IRQ 0
+
+    for (uint i = 0; i < AUDIO_BUFFER_DEPTH; ++i) {
+        if (pending & (1u << dma_chan_R[i])) {
+            dma_hw->ints0 = 1u << dma_chan_R[i]; // clear the interrupt request
+            if (s_block_irq < 0) out_buf_ptr_R = &pwm_out_buf_R[i][0];
+            callback_flag_R = 1;
+        }
     }
+}
 
-    // Handle the interrupt for channel D
-    if (pending & (1u << dma_chan_d)) {
-        dma_hw->ints0 = 1u << dma_chan_d; // clear the interrupt request
-        out_buf_ptr_R   = &pwm_out_buf_d[0];
-        callback_flag_R = 1;
-    }
+void setBlockRenderIRQ(int irq_num) {
+    s_block_irq = irq_num;
 }
 
-void configurePWM_DMA_L(){
-    gpio_set_function(PIN_PWM_OUT_L, GPIO_FUNC_PWM);// set GP2 function PWM
-    uint slice_num = pwm_gpio_to_slice_num(PIN_PWM_OUT_L);// GP2 PWM slice
+// One PWM slice fed by a ring of chained DMA channels, one per buffer
+static void configurePWM_DMA_ring(uint pin, volatile uint16_t (*bufs)[AUDIO_BLOCK_SIZE], int* chans, bool irq1) {
+    gpio_set_function(pin, GPIO_FUNC_PWM);
+    uint slice_num = pwm_gpio_to_slice_num(pin);
     pwm_set_clkdiv(slice_num, 1);
     pwm_set_wrap(slice_num, PWM_RESOLUTION);
     pwm_set_enabled(slice_num, true);
     pwm_set_irq_enabled(slice_num, true); // Necessary? Yes
 
-    dma_chan_a = dma_claim_unused_channel(true);
-    dma_chan_b = dma_claim_unused_channel(true);
-
-    dma_channel_config cfg_0_a = dma_channel_get_default_config(dma_chan_a);
-    channel_config_set_transfer_data_size(&cfg_0_a, DMA_SIZE_16);
-    channel_config_set_read_increment(&cfg_0_a, true);
-    channel_config_set_dreq(&cfg_0_a, DREQ_PWM_WRAP0 + slice_num); // write data at pwm frequency
-    channel_config_set_ring(&cfg_0_a, false, size_bits); //'false' refers to whether data is being written to the buffer
-    channel_config_set_chain_to(&cfg_0_a, dma_chan_b); // start chan b when chan a completed
-
-    dma_channel_configure(
-        dma_chan_a,         // Channel to be configured
-        &cfg_0_a,           // The configuration we just created
-        &pwm_hw->slice[slice_num].cc, // write address
-        pwm_out_buf_a,      // The initial read address
-        AUDIO_BLOCK_SIZE,   // Number of transfers
-        false               // Start immediately?
-    );
-
-    dma_channel_set_irq1_enabled(dma_chan_a, true);
-
-    dma_channel_config cfg_0_b = dma_channel_get_default_config(dma_chan_b);
-    channel_config_set_transfer_data_size(&cfg_0_b, DMA_SIZE_16);
-    channel_config_set_read_increment(&cfg_0_b, true);
-    channel_config_set_dreq(&cfg_0_b, DREQ_PWM_WRAP0 + slice_num); // write data at pwm frequency
-    channel_config_set_ring(&cfg_0_b, false, size_bits);
-    channel_config_set_chain_to(&cfg_0_b, dma_chan_a); // start chan a when chan b completed
-    
-    dma_channel_configure(
-        dma_chan_b,         // Channel to be configured
-        &cfg_0_b,           // The configuration we just created
-        &pwm_hw->slice[slice_num].cc, // write address
-        pwm_out_buf_b,      // The initial read address
-        AUDIO_BLOCK_SIZE,   // Number of transfers
-        false               // Start immediately?
-    );
-
-    dma_channel_set_irq1_enabled(dma_chan_b, true);
+    for (uint i = 0; i < AUDIO_BUFFER_DEPTH; ++i) {
+        chans[i] = dma_claim_unused_channel(true);
+    }
+
+    for (uint i = 0; i < AUDIO_BUFFER_DEPTH; ++i) {
+        dma_channel_config cfg = dma_channel_get_default_config(chans[i]);
+        channel_config_set_transfer_data_size(&cfg, DMA_SIZE_16);
+        channel_config_set_read_increment(&cfg, true);
+        channel_config_set_dreq(&cfg, DREQ_PWM_WRAP0 + slice_num); // write data at pwm frequency
+        channel_config_set_ring(&cfg, false, size_bits); //'false' refers to whether data is being written to the buffer
+        channel_config_set_chain_to(&cfg, chans[(i + 1) % AUDIO_BUFFER_DEPTH]); // start the next buffer when this one completes
+
+        dma_channel_configure(
+            chans[i],           // Channel to be configured
+            &cfg,               // The configuration we just created
+            &pwm_hw->slice[slice_num].cc, // write address
+            bufs[i],            // The initial read address
+            AUDIO_BLOCK_SIZE,   // Number of transfers
+            false               // Start immediately?
+        );
+
+        if (irq1) dma_channel_set_irq1_enabled(chans[i], true);
+        else      dma_channel_set_irq0_enabled(chans[i], true);
+    }
+}
+
+void configurePWM_DMA_L(){
+    configurePWM_DMA_ring(PIN_PWM_OUT_L, pwm_out_buf_L, dma_chan_L, true);
     irq_set_exclusive_handler(DMA_IRQ_1, PWM_DMATransCpltCallbackL);
+    irq_set_priority(DMA_IRQ_1, PICO_HIGHEST_IRQ_PRIORITY);  // Preempts the render IRQ
     irq_set_enabled(DMA_IRQ_1, true);
 }
 
 void configurePWM_DMA_R(){
-    gpio_set_function(PIN_PWM_OUT_R, GPIO_FUNC_PWM);// set GP2 function PWM
-    uint slice_num = pwm_gpio_to_slice_num(PIN_PWM_OUT_R);// GP2 PWM slice
-    pwm_set_clkdiv(slice_num, 1);
-    pwm_set_wrap(slice_num, PWM_RESOLUTION);
-    pwm_set_enabled(slice_num, true);
-    pwm_set_irq_enabled(slice_num, true); // Necessary? Yes
-
-    dma_chan_c = dma_claim_unused_channel(true);
-    dma_chan_d = dma_claim_unused_channel(true);
-
-    dma_channel_config cfg_0_c = dma_channel_get_default_config(dma_chan_c);
-    channel_config_set_transfer_data_size(&cfg_0_c, DMA_SIZE_16);
-    channel_config_set_read_increment(&cfg_0_c, true);
-    channel_config_set_dreq(&cfg_0_c, DREQ_PWM_WRAP0 + slice_num); // write data at pwm frequency
-    channel_config_set_ring(&cfg_0_c, false, size_bits); //'false' refers to whether data is being written to the buffer
-    channel_config_set_chain_to(&cfg_0_c, dma_chan_d); // start chan b when chan a completed
-
-    dma_channel_configure(
-        dma_chan_c,         // Channel to be configured
-        &cfg_0_c,           // The configuration we just created
-        &pwm_hw->slice[slice_num].cc, // write address
-        pwm_out_buf_c,      // The initial read address
-        AUDIO_BLOCK_SIZE,   // Number of transfers
-        false               // Start immediately?
-    );
-
-    dma_channel_set_irq0_enabled(dma_chan_c, true);
-
-    dma_channel_config cfg_0_d = dma_channel_get_default_config(dma_chan_d);
-    channel_config_set_transfer_data_size(&cfg_0_d, DMA_SIZE_16);
-    channel_config_set_read_increment(&cfg_0_d, true);
-    channel_config_set_dreq(&cfg_0_d, DREQ_PWM_WRAP0 + slice_num); // write data at pwm frequency
-    channel_config_set_ring(&cfg_0_d, false, size_bits);
-    channel_config_set_chain_to(&cfg_0_d, dma_chan_c); // start chan c when chan d completed
-    
-    dma_channel_configure(
-        dma_chan_d,         // Channel to be configured
-        &cfg_0_d,           // The configuration we just created
-        &pwm_hw->slice[slice_num].cc, // write address
-        pwm_out_buf_d,      // The initial read address
-        AUDIO_BLOCK_SIZE,   // Number of transfers
-        false               // Start immediately?
-    );
-
-    dma_channel_set_irq0_enabled(dma_chan_d, true);
+    configurePWM_DMA_ring(PIN_PWM_OUT_R, pwm_out_buf_R, dma_chan_R, false);
     irq_set_exclusive_handler(DMA_IRQ_0, PWM_DMATransCpltCallbackR);
+    irq_set_priority(DMA_IRQ_0, PICO_HIGHEST_IRQ_PRIORITY);
     irq_set_enabled(DMA_IRQ_0, true);
 
-    dma_channel_start(dma_chan_a); // seems to start something
-    dma_channel_start(dma_chan_c); // seems to start something
-}
\ No newline at end of file
+    // Start both rings together so buffer n of each channel completes in lockstep
+    dma_start_channel_mask((1u << dma_chan_L[0]) | (1u << dma_chan_R[0]));
+}
@@ -11,7 +11,7 @@
  * 
  * **PWM Audio**: Uses PWM to generate analog audio output with 12-bit resolution
  * **DMA Transfer**: Continuous audio output without CPU intervention
- * **Dual Buffering**: Ping-pong buffers for seamless audio streaming
+ * **Ring Buffering**: 2-4 chained DMA buffers per channel for seamless streaming
  * **High Sample Rate**: 48kHz output for professional audio quality
  * **Low Latency**: Minimal delay between audio processing and output
  * 
@@ -26,9 +26,33 @@
  * 
  * - **Sample Rate**: Configurable via audio_rate setting (typically 48kHz)
  * - **Bit Depth**: 12-bit PWM resolution (equivalent to ~12-bit DAC)
- * - **Latency**: <1ms end-to-end audio latency
+ * - **Latency**: <1ms end-to-end audio latency (16-sample blocks, 2 buffers)
  * - **CPU Load**: <5% CPU usage for audio output
  * 
+ * ## Block Size and Buffer Depth
+ * 
+ * AUDIO_BLOCK_SIZE (16, 32, 64 or 128 samples) and AUDIO_BUFFER_DEPTH (2-4
+ * buffers per channel) are build-time settings. Each channel runs one DMA
+ * channel per buffer, chained in a ring; each wraps its read address over its
+ * own buffer (ring size derived from the block size), so a finished buffer is
+ * ready to refill as soon as the next one starts. A freed buffer plays again
+ * AUDIO_BUFFER_DEPTH - 1 blocks later, which is the render's slack; output
+ * latency is between that and one more block.
+ * 
+ * Fixed per-block work (ADC filter update, pitch and loop math, display
+ * publish) is paid once per block, so larger blocks trade latency for
+ * throughput. At 36.6 kHz:
+ * 
+ * | Profile       | Block x depth | Render slack | Output latency |
+ * |---------------|---------------|--------------|----------------|
+ * | Low latency   | 16 x 2        | 0.44 ms      | 0.44-0.87 ms   |
+ * | Balanced      | 32 x 3        | 1.75 ms      | 1.75-2.62 ms   |
+ * | Throughput    | 64 x 3        | 3.49 ms      | 3.49-5.24 ms   |
+ * | Max block     | 128 x 2       | 3.49 ms      | 3.49-6.99 ms   |
+ * 
+ * `make bench-blocks` in host/ prints latency and per-block overhead for
+ * every block size.
+ * 
  * @author Brian Varren
  * @version 1.0
  * @date 2024
@@ -37,21 +61,31 @@
 #pragma once
 
 // ── Audio Output Configuration ──────────────────────────────────────────────────
-#define AUDIO_BLOCK_SIZE    16    // Audio buffer size (samples per DMA transfer)
+#ifndef AUDIO_BLOCK_SIZE
+#define AUDIO_BLOCK_SIZE    16    // Audio buffer size (samples per DMA transfer): 16/32/64/128
+#endif
+#ifndef AUDIO_BUFFER_DEPTH
+#define AUDIO_BUFFER_DEPTH  2     // Chained DMA buffers per channel: 2..4
+#endif
 #define PIN_PWM_OUT_L       20    // PWM output pin for audio
 #define PIN_PWM_OUT_R       21    // PWM output pin for audio
 #define PWM_RESOLUTION      4096  // PWM resolution (12-bit)
 
+static_assert(AUDIO_BLOCK_SIZE == 16 || AUDIO_BLOCK_SIZE == 32 || AUDIO_BLOCK_SIZE == 64 ||
+              AUDIO_BLOCK_SIZE == 128, "AUDIO_BLOCK_SIZE must be 16, 32, 64 or 128");
+static_assert(AUDIO_BUFFER_DEPTH >= 2 && AUDIO_BUFFER_DEPTH <= 4, "AUDIO_BUFFER_DEPTH must be 2..4");
+
 // ── Audio Output State Variables ────────────────────────────────────────────────
-extern volatile uint16_t pwm_out_buf_a[AUDIO_BLOCK_SIZE];  // First audio buffer
-extern volatile uint16_t pwm_out_buf_b[AUDIO_BLOCK_SIZE];  // Second audio buffer
-extern volatile uint16_t pwm_out_buf_c[AUDIO_BLOCK_SIZE];  // Third audio buffer
-extern volatile uint16_t pwm_out_buf_d[AUDIO_BLOCK_SIZE];  // Fourth audio buffer
+extern volatile uint16_t pwm_out_buf_L[AUDIO_BUFFER_DEPTH][AUDIO_BLOCK_SIZE];  // Left DMA ring
+extern volatile uint16_t pwm_out_buf_R[AUDIO_BUFFER_DEPTH][AUDIO_BLOCK_SIZE];  // Right DMA ring
 extern volatile uint16_t* out_buf_ptr_L;                     // Pointer to active buffer
 extern volatile uint16_t* out_buf_ptr_R;                     // Pointer to active buffer
 extern volatile int callback_flag_L;                         // DMA completion flag
 extern volatile int callback_flag_R;                         // DMA completion flag
-extern int dma_chan_a, dma_chan_b, dma_chan_c, dma_chan_d;                        // DMA channel assignments
+extern volatile uint32_t dma_block_count;                    // Left-channel blocks completed
+extern volatile uint32_t dma_block_timestamp_us;             // time_us_32() at the last completion
+extern int dma_chan_L[AUDIO_BUFFER_DEPTH];                   // DMA channel per left buffer
+extern int dma_chan_R[AUDIO_BUFFER_DEPTH];                   // DMA channel per right buffer
 extern float audio_rate;                                   // Audio sample rate (Hz)
 
 // ── Audio Output Interface Functions ────────────────────────────────────────────
@@ -76,12 +110,23 @@ void unmuteAudioOutput();
  * @brief DMA transfer completion callback
  * 
  * Called by the DMA system when an audio buffer transfer completes.
- * This function manages the ping-pong buffer system and signals
+ * This function manages the DMA buffer ring and signals
  * the audio engine to process the next buffer.
  */
 void PWM_DMATransCpltCallbackL();
 void PWM_DMATransCpltCallbackR();
 
+/**
+ * @brief Pend an IRQ on every completed output block
+ * 
+ * The left-channel callback records the completion time, counts the block
+ * and pends irq_num, so the block can be rendered at that IRQ's priority.
+ * Completion n (from 0) frees buffer n % AUDIO_BUFFER_DEPTH on both
+ * channels (they run in lockstep); the IRQ picks the buffer itself, so the
+ * callbacks leave out_buf_ptr_L/R alone while it is set. Pass -1 to stop.
+ */
+void setBlockRenderIRQ(int irq_num);
+
 /**
  * @brief Configure PWM DMA for audio output
  * 
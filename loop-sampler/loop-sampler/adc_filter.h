@@ -101,7 +101,8 @@ public:
     float alpha = 1.f - expf(-2.f * 3.14159265f * cutoff_hz / tick_rate_hz);
     if (alpha < 1e-6f) alpha = 1e-6f;
     int s = (int)lroundf(log2f(1.0f / alpha));
-    if (s < 0) s = 0; if (s > 15) s = 15;
+    if (s < 0) s = 0;
+    if (s > 15) s = 15;
     smoothing_shift = (uint8_t)s;
   }
 
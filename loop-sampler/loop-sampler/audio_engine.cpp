@@ -27,13 +27,24 @@
 #include "pico_interp.h"
 #include "sf_globals_bridge.h"
 #include "config_pins.h"
+#include "crossfade.h"
+#include "interp_kernel.h"
+#include "sample_cache.h"
+#include "render_profiler.h"
+#include "reset_trigger.h"
+#include "tempo_clock.h"
+#include "recorder.h"
+#include "stereo_delay.h"
+#include "granular.h"
 #include <hardware/pwm.h>
 #include <hardware/gpio.h>
+#include <hardware/irq.h>
 #include <Arduino.h>  // Add for Serial
 
 // Forward declaration from audio_engine_render.cpp
 void ae_render_block(const int16_t* samples,
                      uint32_t total_samples,
+                     uint8_t channels,
                      ae_state_t engine_state,
                      volatile uint64_t* io_phase_q32_32);
 
@@ -186,9 +197,10 @@ int64_t g_pm_scale_q32_32 = 0;             // default = no phase modulation
 
 // ── Reset trigger state ──────────────────────────────────────────────────────
 // Reset trigger functionality for tempo sync - allows external triggers to reset
-// the loop phase and recalculate loop parameters with crossfading
+// the loop phase and recalculate loop parameters with crossfading. GPIO edges
+// go through the timestamped queue in reset_trigger.cpp; this flag is the
+// software trigger, which starts on the first sample of the next block.
 volatile bool g_reset_trigger_pending = false;
-static bool s_reset_trigger_last_state = false;
 
 // ── Loop LED state ────────────────────────────────────────────────────────────
 // LED control for visual feedback when loop wraps
@@ -199,10 +211,13 @@ static const uint32_t LOOP_LED_BLINK_MS = 10;  // LED blink duration in millisec
 
 static const int16_t* g_samples_q15 = nullptr;
 
-static uint32_t g_total_samples = 0;      // set when file is bound
+static uint32_t g_total_samples = 0;      // set when file is bound (frames)
+static uint8_t g_channels = 1;            // 1 = mono, 2 = interleaved L/R
 static const uint32_t MIN_LOOP_LEN_CONST = 64;  // Fixed minimum loop length
 static uint32_t g_span_start    = 0;      // = total - MIN_LOOP_LEN_CONST (precomputed)
 static uint32_t g_span_len      = 0;      // = total - MIN_LOOP_LEN_CONST (same span)
+static volatile uint32_t s_renders_started = 0;  // Renders begun (playback_unbind_buffer() waits on it)
+static volatile bool s_render_running = false;   // Set once audio_init() has started the output
 
 
 // ── Tune knob ──────────────────────────────────────────────────────────────
@@ -297,10 +312,12 @@ static inline uint16_t q15_to_pwm_u(int16_t s) {
 // Call this after the loader fills sf::audioData + metadata
 void playback_bind_loaded_buffer(uint32_t src_sample_rate_hz,
                                  uint32_t out_sample_rate_hz,
-                                 uint32_t sample_count)
+                                 uint32_t sample_count,
+                                 uint8_t channels)
 {
     g_samples_q15   = reinterpret_cast<const int16_t*>(sf::audioData);
     g_total_samples = sample_count;
+    g_channels      = channels;
 
     // Unity base: src_hz / out_hz in Q16.16
     g_inc_base_q32_32 = (uint64_t)(((uint64_t)src_sample_rate_hz << 32) / (uint64_t)out_sample_rate_hz);
@@ -320,78 +337,205 @@ void playback_bind_loaded_buffer(uint32_t src_sample_rate_hz,
 }
 
 
+void playback_unbind_buffer(void)
+{
+    g_samples_q15   = nullptr;
+    g_total_samples = 0;
+    __compiler_memory_barrier();  // Unbound before the count is read
+    if (!s_render_running) return;
+
+    // A block that read the old pointer counted itself first, so once the
+    // count moves that block is over and the next one renders silence
+    const uint32_t seen = s_renders_started;
+    while (s_renders_started == seen) tight_loop_contents();
+}
+
+// One block over the bound buffer. The count goes up before the buffer is
+// read, so playback_unbind_buffer() knows when no render holds an old one.
+static inline void render_bound_block(void) {
+    s_renders_started = s_renders_started + 1u;
+    __compiler_memory_barrier();
+    ae_render_block(g_samples_q15, g_total_samples, g_channels, s_state, &g_phase_q32_32);
+}
+
+
+// ── Render Scheduling ───────────────────────────────────────────────────────
+// The left DMA callback pends a spare IRQ on core 0 for every finished block;
+// the block renders there, so loop() work can delay it only by preemption
+// from higher-priority IRQs. Timing is measured from the DMA completion.
+static ae_deadline_stats_t s_deadline = {};
+static uint32_t s_clean_blocks = 0;       // Consecutive blocks with headroom
+volatile uint8_t g_ae_load_shed = 0;
+
+// Count one rendered block and step the load-shed level
+// start_us: DMA completion, end_us: render done, skipped: blocks never rendered
+static void audio_account_block(uint32_t start_us, uint32_t end_us, uint32_t skipped) {
+    const uint32_t elapsed = end_us - start_us;
+    const uint32_t deadline = s_deadline.deadline_us;
+    s_deadline.blocks++;
+    s_deadline.underruns += skipped;
+    if (elapsed > s_deadline.worst_us) s_deadline.worst_us = elapsed;
+    
+    const bool missed = elapsed > deadline;
+    if (missed) s_deadline.deadline_misses++;
+    if (missed || skipped) {
+        // Shed load right away; one level per late block
+        if (g_ae_load_shed < AE_SHED_MAX) g_ae_load_shed++;
+        s_clean_blocks = 0;
+    } else if (g_ae_load_shed && elapsed * 100u < deadline * AE_SHED_HEADROOM_PCT) {
+        // Step back up only after a long run of blocks with headroom
+        if (++s_clean_blocks >= AE_SHED_RECOVER_BLOCKS) {
+            g_ae_load_shed--;
+            s_clean_blocks = 0;
+        }
+    } else {
+        s_clean_blocks = 0;
+    }
+}
+
+#if AE_RENDER_IRQ
+static uint32_t s_blocks_seen = 0;        // dma_block_count at the last render
+
+static void audio_render_irq(void) {
+    for (;;) {
+        // Completion count and time are written together by the DMA callback
+        // (which can preempt us), so re-read until they belong to the same block
+        uint32_t done, start_us;
+        do {
+            done = dma_block_count;
+            start_us = dma_block_timestamp_us;
+        } while (done != dma_block_count);
+        
+        uint32_t behind = done - s_blocks_seen;
+        if (behind == 0) return;  // Caught up
+        
+        // A buffer freed more than DEPTH-1 completions ago is already playing
+        // again: count those as underruns and refill only the ones still queued
+        uint32_t skipped = 0;
+        if (behind > AUDIO_BUFFER_DEPTH - 1) {
+            skipped = behind - (AUDIO_BUFFER_DEPTH - 1);
+            s_blocks_seen += skipped;
+            behind -= skipped;
+        }
+        
+        // Completion n frees buffer n % DEPTH on both channels
+        const uint32_t b = s_blocks_seen % AUDIO_BUFFER_DEPTH;
+        s_blocks_seen++;
+        out_buf_ptr_L = pwm_out_buf_L[b];
+        out_buf_ptr_R = pwm_out_buf_R[b];
+        // This buffer came free (behind - 1) blocks before the latest completion
+        const uint32_t freed_us = start_us - (behind - 1u) * s_deadline.block_us;
+        adc_capture_refresh_controls();  // Before the filters, in every engine state
+        adc_filter_update_from_dma();
+        rt_begin_block(freed_us);
+        render_bound_block();
+        callback_flag_L = 0;
+        callback_flag_R = 0;
+        audio_account_block(freed_us, time_us_32(), skipped);
+    }
+}
+
+static void audio_render_irq_init(void) {
+    const int irq_num = user_irq_claim_unused(true);
+    irq_set_exclusive_handler((uint)irq_num, audio_render_irq);
+    irq_set_priority((uint)irq_num, AE_RENDER_IRQ_PRIORITY);
+    irq_set_enabled((uint)irq_num, true);
+    s_blocks_seen = dma_block_count;
+    setBlockRenderIRQ(irq_num);
+}
+#endif
+
 void audio_init(void) {
     // Initialize all audio buffers to silence to prevent startup pops
     const uint16_t silence_pwm = PWM_RESOLUTION / 2;  // Midpoint = silence
-    for (int i = 0; i < AUDIO_BLOCK_SIZE; i++) {
-        pwm_out_buf_a[i] = silence_pwm;
-        pwm_out_buf_b[i] = silence_pwm;
-        pwm_out_buf_c[i] = silence_pwm;
-        pwm_out_buf_d[i] = silence_pwm;
+    for (int b = 0; b < AUDIO_BUFFER_DEPTH; b++) {
+        for (int i = 0; i < AUDIO_BLOCK_SIZE; i++) {
+            pwm_out_buf_L[b][i] = silence_pwm;
+            pwm_out_buf_R[b][i] = silence_pwm;
+        }
     }
     
     init_expo_table_1oct();
+    xfade_init_tables();
+    interp_init_tables();
+    gr_init_tables();
+    sc_init();
+    prof_init(AUDIO_BLOCK_SIZE * 1e6f / audio_rate);  // Block deadline in us
+    rt_init(audio_rate);
+    tc_init(audio_rate);
+    rec_init();            // Recorder's PSRAM copy channels
+    dly_init();            // Delay's PSRAM copy channels
+    setupInterpolators();  // Before the first block can render
+    s_deadline.block_us = (uint32_t)(AUDIO_BLOCK_SIZE * 1e6f / audio_rate);
+    s_deadline.deadline_us = s_deadline.block_us * (AUDIO_BUFFER_DEPTH - 1);  // Slack before a freed buffer replays
+#if AE_RENDER_IRQ
+    audio_render_irq_init();
+#endif
     configurePWM_DMA_L();
     configurePWM_DMA_R();
     unmuteAudioOutput();
-    
-    setupInterpolators();
+    s_render_running = true;
 
     // dma_start_channel_mask(1u << dma_chan);
-    // Serial.printf("[AE] DMA L started? %d\n", dma_channel_is_busy(dma_chan_a));
-    // Serial.printf("[AE] DMA R started? %d\n", dma_channel_is_busy(dma_chan_c));
+    // Serial.printf("[AE] DMA L started? %d\n", dma_channel_is_busy(dma_chan_L[0]));
+    // Serial.printf("[AE] DMA R started? %d\n", dma_channel_is_busy(dma_chan_R[0]));
 
     // Serial.println(F("[AE] Audio engine initialized"));
 }
 
 void audio_tick(void) {
+#if !AE_RENDER_IRQ
     // Process audio when either channel is ready to prevent buffer underruns
     // This fixes the pop issue caused by waiting for both channels simultaneously
     if (callback_flag_L > 0 || callback_flag_R > 0) {
+        const uint32_t t0 = time_us_32();
+        adc_capture_refresh_controls();  // Before the filters, in every engine state
         adc_filter_update_from_dma();
-        ae_render_block(g_samples_q15, g_total_samples, s_state, &g_phase_q32_32);
+        rt_begin_block(t0);  // Polled: the buffer came free no later than now
+        render_bound_block();
         callback_flag_L = 0;
         callback_flag_R = 0;
+        audio_account_block(t0, time_us_32(), 0);
     }
+#endif
+}
+
+void audio_engine_get_deadline_stats(ae_deadline_stats_t* out) {
+    // Counters only ever grow, so retry until a copy lands between two blocks
+    do {
+        *out = s_deadline;
+    } while (out->blocks != s_deadline.blocks);
+    out->shed_level = g_ae_load_shed;
 }
 
 // ── Reset Trigger Functions ──────────────────────────────────────────────────────
 
+// Rising edge on GPIO18: stamp it before anything else can delay it
+static void reset_trigger_gpio_irq(void) {
+    if (gpio_get_irq_event_mask(RESET_TRIGGER_PIN) & GPIO_IRQ_EDGE_RISE) {
+        gpio_acknowledge_irq(RESET_TRIGGER_PIN, GPIO_IRQ_EDGE_RISE);
+        rt_record_edge(time_us_32());
+    }
+}
+
 /**
  * @brief Initialize GPIO18 for reset trigger detection
  * 
  * Sets up GPIO18 as an input with pull-down resistor for detecting external
- * reset triggers. The trigger is active-high (rising edge to trigger).
+ * reset triggers. The trigger is active-high: each rising edge is
+ * timestamped in the GPIO IRQ (on the core that calls this, i.e. core 0) and
+ * queued for the renderer, which starts the new loop on the matching sample.
  */
 void audio_engine_reset_trigger_init(void) {
     gpio_init(RESET_TRIGGER_PIN);
     gpio_set_dir(RESET_TRIGGER_PIN, GPIO_IN);
     gpio_pull_down(RESET_TRIGGER_PIN);
-    
-    // Initialize state tracking
-    s_reset_trigger_last_state = gpio_get(RESET_TRIGGER_PIN);
     g_reset_trigger_pending = false;
     
-    // Serial.println(F("[AE] Reset trigger initialized on GPIO18 (rising edge)"));
-}
-
-/**
- * @brief Poll for reset trigger on GPIO18
- * 
- * This function should be called from the main loop to detect rising edges
- * on the reset trigger pin. When a trigger is detected, it sets the pending
- * flag for processing in the audio engine.
- */
-void audio_engine_reset_trigger_poll(void) {
-    bool current_state = gpio_get(RESET_TRIGGER_PIN);
-    
-    // Detect rising edge (active-high trigger)
-    if (!s_reset_trigger_last_state && current_state) {
-        g_reset_trigger_pending = true;
-        // Serial.println(F("[AE] Reset trigger detected (rising edge)"));
-    }
-    
-    s_reset_trigger_last_state = current_state;
+    gpio_add_raw_irq_handler(RESET_TRIGGER_PIN, reset_trigger_gpio_irq);
+    gpio_set_irq_enabled(RESET_TRIGGER_PIN, GPIO_IRQ_EDGE_RISE, true);
+    irq_set_priority(IO_IRQ_BANK0, RT_IRQ_PRIORITY);
+    irq_set_enabled(IO_IRQ_BANK0, true);
 }
 
 /**
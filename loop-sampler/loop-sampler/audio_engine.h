@@ -35,6 +35,22 @@
  * - **REVERSE**: Reverse playback
  * - **ALTERNATE**: Ping-pong (forward then reverse, repeating)
  * 
+ * ## Render Scheduling
+ * 
+ * Each left-channel DMA completion pends a spare software IRQ on core 0 and
+ * the block is rendered in that handler (AE_RENDER_IRQ). The handler sits
+ * below the DMA IRQs and above every default-priority IRQ, so nothing
+ * loop() does can hold a block back. Every freed buffer still queued is
+ * rendered in order; buffers the handler could not reach before they
+ * started playing again are counted as underruns and skipped, and blocks
+ * that finish after their buffer was due (AUDIO_BUFFER_DEPTH - 1 blocks
+ * after it came free) are counted as deadline misses. Either raises
+ * the load-shed level read by the renderer, which steps back down after
+ * AE_SHED_RECOVER_BLOCKS blocks with headroom:
+ * 
+ * - **Level 1**: interpolation capped at linear
+ * - **Level 2**: also frees released voices beyond the newest one
+ * 
  * @author Brian Varren
  * @version 1.0
  * @date 2024
@@ -44,6 +60,20 @@
 #include <stdint.h>
 #include "DACless.h"
 
+// ── Render scheduling ─────────────────────────────────────────────────────
+#ifndef AE_RENDER_IRQ
+#define AE_RENDER_IRQ           1      // 1 = render from a DMA-pended IRQ, 0 = poll in audio_tick()
+#endif
+#define AE_RENDER_IRQ_PRIORITY  0x40   // Below the DMA IRQs (0x00), above defaults (0x80)
+#define AE_SHED_MAX             2      // Highest load-shed level
+#define AE_SHED_RECOVER_BLOCKS  1024u  // Clean blocks before stepping down (~0.45 s at 16)
+#define AE_SHED_HEADROOM_PCT    75u    // A clean block finishes within this share of its deadline
+
+// ── Channels ──────────────────────────────────────────────────────────────
+#ifndef AE_STEREO
+#define AE_STEREO               1      // 0 = build only the mono kernels (stereo loads fall back to mono)
+#endif
+
 // ── Public engine state (keep small) ──────────────────────────────────────
 
 // ── Direction / transport ─────────────────────────────────────────
@@ -74,23 +104,48 @@ extern int32_t g_pm_scale_q16_16;
 // Live playhead position normalized to the current loop, 0..65535.
 extern volatile uint16_t g_playhead_norm_u16;
 
-// Reset trigger state
+// Software reset trigger (starts on the next block's first sample)
 extern volatile bool g_reset_trigger_pending;
 
+// Load-shed level (0 = full quality), raised by missed render deadlines
+extern volatile uint8_t g_ae_load_shed;
+
+typedef struct {
+  uint32_t blocks;           // Blocks rendered
+  uint32_t deadline_misses;  // Blocks finished after their buffer was due
+  uint32_t underruns;        // Blocks skipped because the render fell a whole block behind
+  uint32_t worst_us;         // Longest DMA completion to render end
+  uint32_t block_us;         // One block at the output rate
+  uint32_t deadline_us;      // Render slack: AUDIO_BUFFER_DEPTH - 1 blocks
+  uint8_t  shed_level;       // Current g_ae_load_shed
+} ae_deadline_stats_t;
+
 // ── Lifecycle ─────────────────────────────────────────────────────────────
 
 // Initializes tables and PWM DMA (expects your DACless/ADCless to be linkable)
 void audio_init(void);
 
+// Renders a pending block when AE_RENDER_IRQ is 0; nothing to do otherwise.
 void audio_tick(void);
 
+// Copy the render deadline counters (any core).
+void audio_engine_get_deadline_stats(ae_deadline_stats_t* out);
+
 // Bind the loaded sample buffer and set the base increment to unity for that file.
 //  - src_sample_rate_hz: WAV/native sample rate
 //  - out_sample_rate_hz: your audio engine output rate (PWM ISR rate)
-//  - sample_count: number of int16 PCM samples in PSRAM
+//  - sample_count: number of sample frames in PSRAM
+//  - channels: 1 = mono Q15, 2 = interleaved L/R Q15 frames (rendered in stereo)
 void playback_bind_loaded_buffer(uint32_t src_sample_rate_hz,
                                  uint32_t out_sample_rate_hz,
-                                 uint32_t sample_count);
+                                 uint32_t sample_count,
+                                 uint8_t channels = 1);
+
+// Unbind the sample buffer and wait for the block that may still be reading
+// it (core 1 only). Returns once a new block has started, so the buffer and
+// everything derived from it (mip levels, zero crossings, SRAM copies) may
+// then be freed or rebuilt: an unbound render touches none of them.
+void playback_unbind_buffer(void);
 
 // ── Transport / mode control (UI calls these) ────────────────────
 void audio_engine_set_mode(ae_mode_t m);      // FORWARD/REVERSE/ALTERNATE
@@ -100,8 +155,7 @@ ae_state_t audio_engine_get_state(void);
 ae_mode_t  audio_engine_get_mode(void);
 
 // ── Reset trigger control ─────────────────────────────────────────────
-void audio_engine_reset_trigger_init(void);  // Initialize GPIO18 for reset trigger
-void audio_engine_reset_trigger_poll(void);  // Poll for reset trigger (call from main loop)
+void audio_engine_reset_trigger_init(void);  // GPIO18 edge IRQ -> timestamped queue (reset_trigger.h)
 
 // ── Loop LED control ─────────────────────────────────────────────
 void audio_engine_loop_led_init(void);       // Initialize GPIO15 for loop LED
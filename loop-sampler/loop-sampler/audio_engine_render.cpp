@@ -1,14 +1,39 @@
 /**
  * @file audio_engine_render.cpp
- * @brief Dual-voice audio rendering engine with seamless crossfading
+ * @brief Polyphonic audio rendering engine with seamless crossfading
  * 
- * Simplified architecture using two concurrent voices for clean crossfading,
- * TZFM support, and bidirectional playback.
+ * Voices come from an N-voice pool (voice_pool.h). One voice is the looping
+ * primary; loop seams and retriggers start a new primary and release the old
+ * one, which keeps playing out along its own envelope, so retriggers overlap
+ * instead of cutting the previous pass. TZFM and forward / reverse /
+ * ping-pong playback are supported.
+ * 
+ * Rendering is split into small template-specialized kernels, one per
+ * (direction x voice stage x FM on/off) combination. Each active voice is
+ * rendered for the whole block by the kernel for its stage, so the
+ * per-sample loop carries no mode, envelope or modulation branches. Voices
+ * accumulate into an int32 block that the effects pass then clamps and
+ * converts to PWM.
+ * 
+ * A stereo buffer (interleaved L/R Q15, SF_LOAD_STEREO) is rendered by the
+ * stereo kernel set: each tap is one 32-bit read carrying both channels,
+ * the voices mix into separate L and R blocks and each side gets its own
+ * saturation and filter state, so the two PWM outputs carry independent
+ * channels. Mono buffers take the original path and output the same signal
+ * on both pins.
+ * 
+ * In granular mode (granular.h) a pool of short windowed grains takes over
+ * from the voices, reading through the same fetch.
  * 
  * Key Concepts:
  * - Q32.32 fixed-point: 32-bit integer + 32-bit fractional part for sub-sample precision
- * - Constant-power crossfading: Uses cos/sin curves to maintain consistent loudness
- * - Hardware interpolation: Leverages Pico's interpolate() for smooth sample reconstruction
+ * - Fixed-point crossfading: Q15 gain tables stepped by an integer accumulator (crossfade.h)
+ * - Interpolation: hardware blend, linear, Hermite or sinc, chosen per block (interp_kernel.h)
+ * - Octave mipmaps: above 1x, voices read band-limited ½..⅛ rate copies (sample_mipmap.h)
+ * - Sample cache: voices read SRAM copies of the PSRAM data they are about to touch (sample_cache.h)
+ * - Seam cache: an unchanged loop seam is recorded once and replayed as one read (seam_cache.h)
+ * - Profiler: per-stage block timing against the block deadline (render_profiler.h)
+ * - Load shedding: cheaper interpolation, then fewer release tails, after missed deadlines (audio_engine.h)
  * - TZFM (Through-Zero FM): Allows negative frequencies for reverse playback
  * 
  * @author Brian Varren (rewritten)
@@ -25,7 +50,22 @@
  #include "pico_interp.h"
  #include "sf_globals_bridge.h"
  #include "ui_input.h"
- #include "ladder_filter.h"
+ #include "crossfade.h"
+ #include "voice_kernel.h"
+ #include "voice_pool.h"
+ #include "interp_kernel.h"
+ #include "sample_mipmap.h"
+ #include "sample_cache.h"
+ #include "seam_cache.h"
+ #include "render_profiler.h"
+ #include "reset_trigger.h"
+ #include "tempo_clock.h"
+ #include "zero_cross.h"
+ #include "slice_map.h"
+ #include "recorder.h"
+ #include "sample_stream.h"
+ #include "fx_chain.h"
+ #include "granular.h"
  #include <Arduino.h>
  
  // Forward declarations
@@ -36,27 +76,19 @@
      g_loop_boundaries_calculated = false;
  }
  
-// ── Voice Structure ──────────────────────────────────────────────────────────
-// Each voice maintains its own playback state and loop boundaries
-struct Voice {
-    uint64_t phase_q32_32;      // Q32.32 phase accumulator - 32-bit integer + 32-bit fractional
-    uint32_t loop_start;        // Loop start (samples) - where playback begins
-    uint32_t loop_end;          // Loop end (samples) - where playback wraps to start
-    float amplitude;            // Current amplitude (0-1) for mixing during crossfades
-    bool active;                // Is this voice currently playing? (false = silent)
+// ── Playback Direction ───────────────────────────────────────────────────────
+// Compile-time direction for the render kernels (AE_MODE_ALTERNATE = ping-pong)
+enum PlayDir : uint8_t {
+    DIR_FORWARD = 0,
+    DIR_REVERSE,
+    DIR_PINGPONG,
+    DIR_COUNT
 };
- 
+
 // ── Global State ─────────────────────────────────────────────────────────────
-// Two voices for seamless crossfading - only one is "primary" at a time
-static Voice voice_A = {0, 0, 0, 1.0f, true};   // Initially active
-static Voice voice_B = {0, 0, 0, 0.0f, false};  // Initially silent
-static Voice* primary_voice = &voice_A;         // Currently playing voice
-static Voice* secondary_voice = &voice_B;       // Voice fading in during crossfade
- 
-// Crossfade state - tracks the transition between voices
-static bool crossfading = false;                    // Are we currently crossfading?
-static uint32_t crossfade_samples_total = 0;        // Total crossfade duration
-static uint32_t crossfade_samples_remaining = 0;    // Samples left in current crossfade
+// Voice pool - one primary voice loops, the rest are fading in or ringing out
+static VoicePool s_pool;
+static bool s_pool_ready = false;                   // vp_init() on first render
 
 // Pending loop parameters (calculated once per block to avoid recalculation)
 static uint32_t pending_start = 0;                  // New loop start position
@@ -64,16 +96,67 @@ static uint32_t pending_end = 0;                    // New loop end position
 
 // Zone detection state - prevents retriggering crossfade on zone entry
 static bool was_in_zone_last_sample = false;
- 
-// Filters (mono path - applied after mixing both voices)
-static Ladder8PoleLowpassFilter s_lowpass_filter;   // 8-pole ladder filter for lowpass
-static SaturationEffect s_saturation_effect;        // Saturation effect for warmth and distortion
-
-// TZFM (Through-Zero Frequency Modulation) state
-static float base_ratio = 1.0f;                     // Base playback speed (1.0 = normal)
-static float tzfm_depth = 0.0f;                     // FM modulation depth
-static float modulator_smoothed = 0.0f;             // Smoothed modulator to prevent clicks
-const float MODULATOR_SMOOTHING = 0.85f;            // One-pole smoothing coefficient
+
+// Pitch / TZFM (Through-Zero Frequency Modulation) state
+// The increment is retargeted once per block and ramped per sample (voice_kernel.h)
+static IncRamp inc_ramp = {(int64_t)1 << 32, 0};    // Current Q32.32 increment + per-sample step
+static ae_mode_t last_mode = AE_MODE_FORWARD;      // Snap (don't ramp) on direction switch
+
+// Loop seam recording / replay (seam_cache.h)
+enum SeamMode : uint8_t {
+    SEAM_OFF = 0,
+    SEAM_RECORD,    // Seam voices mix into seam_acc, which is appended to the recording
+    SEAM_PLAY       // Seam voices only step their state; the recording is mixed instead
+};
+static SeamMode s_seam_mode = SEAM_OFF;
+static SeamKey s_seam_key;                          // Key of the seam in progress
+static uint32_t s_seam_mask = 0;                    // Voices covered by the seam
+static uint32_t s_seam_pos = 0;                     // Seam samples already replayed
+static uint32_t s_seam_from = 0;                    // First seam sample of this block
+
+// Granular mode (granular.h): the grains stand in for the voice pool
+static GrainPool s_grains;
+static uint32_t s_gr_fade = 0;                      // 0 = voices only .. GR_FADE_BLOCKS = grains only
+
+// Per-block render context - everything the kernels need for the block
+struct RenderCtx {
+    const int16_t* samples;     // Sample buffer (Q15 mono or interleaved L/R frames)
+    uint32_t total_samples;     // Frames in buffer
+    uint8_t channels;           // 1 = mono, 2 = stereo
+    uint16_t adc_start_q12;     // Loop start knob
+    uint16_t adc_len_q12;       // Loop length knob
+    uint32_t snap_len;          // Clock-snapped loop length in source samples (0 = free knob)
+    bool zc_snap;               // Loop points snap to zero crossings (index valid for this buffer)
+    uint32_t slice_start;       // Slice-mode loop start (onset frame)
+    uint32_t slice_end;         // Slice-mode loop end (0 = loop knobs are free)
+    bool stream;                // Samples stream from SD through a PSRAM window (sample_stream.h)
+    uint32_t loop_cap;          // Longest loop the stream window can pin (0 = no limit)
+    int64_t inc_q32_32;         // Block-constant increment (non-FM kernels)
+    int64_t safe_inc_q32_32;    // Base increment floored for time divisions
+    uint32_t xfade_len;         // Crossfade zone length (samples of source)
+    uint32_t xfade_samples;     // Crossfade duration (output samples)
+    xfade_curve_t xfade_curve;  // Crossfade gain curve
+
+    const int16_t* mip_samples[MIP_LEVELS];  // Per-level sample data (level 0 = samples)
+    uint32_t mip_total[MIP_LEVELS];          // Per-level frame count
+    uint8_t mip_level;                       // Level read this block
+    int32_t mip_blend_q15;                   // Crossfade towards mip_level + 1 (MIPX kernels)
+    int64_t max_inc_q32_32;                  // Largest |increment| this block (cache spans)
+    const int16_t* voice_base[SC_LEVELS_PER_VOICE];  // Voice being rendered: level / level + 1 read base
+    uint8_t interp;                          // Interpolation mode this block
+    bool seam_ok;                            // Seams may be cached (FWD/REV, no FM)
+
+    int64_t inc[AUDIO_BLOCK_SIZE];        // Per-sample ramped increment (FM kernels)
+    int32_t acc[AUDIO_BLOCK_SIZE];        // Voice mix accumulator (left for stereo)
+    int32_t acc_r[AUDIO_BLOCK_SIZE];      // Right channel mix (stereo kernels)
+    int32_t seam_acc[AUDIO_BLOCK_SIZE];   // Mix of the seam voices while recording
+    int32_t grain_acc[AUDIO_BLOCK_SIZE];  // Grain mix (left for stereo)
+    int32_t grain_acc_r[AUDIO_BLOCK_SIZE];
+    int32_t* mix;                         // Where the voice being rendered accumulates
+    int32_t* mix_r;                       // Right channel of the same (stereo kernels)
+    uint32_t todo_mask;                   // Voices still to render this block
+    uint8_t start_n[VP_MAX_VOICES];       // First sample to render, per voice
+};
  
  // ── Helper Functions ─────────────────────────────────────────────────────────
  
@@ -86,14 +169,14 @@ static inline uint16_t q15_to_pwm_u(int16_t s) {
  
 // Wrap phase within loop boundaries (handles both forward and reverse)
 // Converts sample indices to Q32.32 for precise boundary checking
-static void wrap_phase(Voice* v) {
-    const int64_t start_q = ((int64_t)v->loop_start) << 32;  // Convert to Q32.32
-    const int64_t end_q = ((int64_t)v->loop_end) << 32;      // Convert to Q32.32
+static inline void wrap_phase(uint64_t& phase_q32_32, uint32_t loop_start, uint32_t loop_end) {
+    const int64_t start_q = ((int64_t)loop_start) << 32;  // Convert to Q32.32
+    const int64_t end_q = ((int64_t)loop_end) << 32;      // Convert to Q32.32
      const int64_t span_q = end_q - start_q;  // Loop length in Q32.32
      
      if (span_q <= 0) return;  // Invalid loop boundaries
      
-     int64_t phase = (int64_t)v->phase_q32_32;
+     int64_t phase = (int64_t)phase_q32_32;
      int64_t normalized = phase - start_q;  // Position relative to loop start
      
      // Modulo wrapping for both directions - handles forward and reverse playback
@@ -104,100 +187,202 @@ static void wrap_phase(Voice* v) {
          if (normalized == span_q) normalized = 0;  // Edge case: exactly at end
      }
      
-     v->phase_q32_32 = (uint64_t)(start_q + normalized);
+     phase_q32_32 = (uint64_t)(start_q + normalized);
  }
  
-// Get interpolated sample from voice using hardware interpolation
-// Returns smoothly interpolated sample between two adjacent samples
-static int16_t get_sample(const Voice* v, const int16_t* samples, uint32_t total_samples, bool is_reverse) {
-    if (!v->active || v->amplitude <= 0.0f) return 0;  // Silent voice
-    if (v->loop_end <= v->loop_start) return 0;        // Invalid loop
+// Reflect phase at loop boundaries for ping-pong playback
+// Flips the voice direction whenever the playhead crosses either edge, so the
+// waveform turns around continuously instead of jumping back to the start.
+// Returns true on a turnaround.
+static inline bool reflect_phase(uint64_t& phase_q32_32, int8_t& dir, uint32_t loop_start, uint32_t loop_end) {
+    const int64_t start_q = ((int64_t)loop_start) << 32;  // Convert to Q32.32
+    const int64_t end_q = ((int64_t)loop_end) << 32;      // Convert to Q32.32 (exclusive)
+    if (end_q <= start_q) return false;  // Invalid loop boundaries
+
+    int64_t phase = (int64_t)phase_q32_32;
+    if (phase >= end_q) {
+        phase = 2 * end_q - phase - 1;   // Mirror back inside, just below the end
+    } else if (phase < start_q) {
+        phase = 2 * start_q - phase;     // Mirror forward from the start
+    } else {
+        return false;
+    }
+    dir = (int8_t)-dir;
+
+    // Overshoot larger than the loop (extreme FM): pin to the edge we turned at
+    if (phase < start_q || phase >= end_q) phase = (dir > 0) ? start_q : end_q - 1;
+    phase_q32_32 = (uint64_t)phase;
+    return true;
+}
+
+// Run a software interpolation kernel around base index i
+// The fast path reads the taps straight from the buffer. Near the edges they
+// are gathered into a small window: FWD/REV loops wrap, ping-pong clamps (it
+// turns around there), and released voices clamp to the buffer because they
+// play on past their loop end. ST reads interleaved L/R frames (the mono
+// result is returned in both halves).
+template <PlayDir DIR, bool OUTGOING, interp_mode_t IM, bool ST>
+static inline StereoQ15 interp_fetch(const int16_t* samples, uint32_t i, uint32_t loop_start, uint32_t loop_end,
+                                     uint32_t total_samples, uint32_t frac32) {
+    const uint32_t before = interp_taps_before(IM);
+    const uint32_t after = interp_taps_after(IM);
+    const uint32_t lo = OUTGOING ? 0u : loop_start;
+    const uint32_t hi = OUTGOING ? total_samples : loop_end;  // Exclusive
+    const uint32_t ch = ST ? 2u : 1u;
+
+    const int16_t* x = samples + i * ch;
+    int16_t window[INTERP_SINC_TAPS * ch];
+    if (i < lo + before || i + after >= hi) {
+        const int32_t len = (int32_t)(hi - lo);
+        for (uint32_t k = 0; k < before + 1 + after; ++k) {
+            int32_t j = (int32_t)i - (int32_t)before + (int32_t)k;
+            if (OUTGOING || DIR == DIR_PINGPONG) {
+                if (j < (int32_t)lo) j = (int32_t)lo;
+                if (j >= (int32_t)hi) j = (int32_t)hi - 1;
+            } else {
+                while (j < (int32_t)lo) j += len;
+                while (j >= (int32_t)hi) j -= len;
+            }
+            if (ST) {
+                const uint32_t f = interp_frame(samples, j);
+                memcpy(window + 2 * k, &f, sizeof(f));
+            } else {
+                window[k] = samples[j];
+            }
+        }
+        x = window + before * ch;
+    }
+
+    if (ST) {
+        if (IM == INTERP_SINC8) return interp_sinc8_st(x, frac32);
+        if (IM == INTERP_HERMITE4) return interp_hermite4_st(x, frac32);
+        return interp_linear16_st(x, frac32);
+    }
+    const int16_t s = (IM == INTERP_SINC8) ? interp_sinc8(x, frac32) :
+                      (IM == INTERP_HERMITE4) ? interp_hermite4(x, frac32) : interp_linear16(x, frac32);
+    return {s, s};
+}
+
+// Hardware 8-bit blend of two signed samples
+static inline int16_t interp_hw8(int32_t a, int32_t b, uint16_t mu8) {
+    // Convert to unsigned for hardware interpolation, then back to signed
+    const uint16_t u0 = (uint16_t)(a + 32768);   // Convert -32768..32767 to 0..65535
+    const uint16_t u1 = (uint16_t)(b + 32768);
+    const uint16_t ui = interpolate(u0, u1, mu8);  // Hardware interpolation on Pico
+    return (int16_t)((int32_t)ui - 32768);         // Convert back to signed
+}
+
+// Get interpolated sample at a voice position
+// Returns a sample reconstructed with interpolation mode IM.
+//  - DIR selects how the interpolation neighbours wrap at the loop edges
+//  - OUTGOING is a released voice: it is allowed to run past the buffer end,
+//    so it clamps and fades instead of going silent
+//  - ST reads both channels of an interleaved L/R frame (mono: r == l)
+template <PlayDir DIR, bool OUTGOING, interp_mode_t IM, bool ST>
+static inline StereoQ15 get_sample(uint64_t phase_q32_32, uint32_t loop_start, uint32_t loop_end, int32_t gain_q15,
+                                   const int16_t* samples, uint32_t total_samples, bool is_reverse) {
+    if (loop_end <= loop_start) return {0, 0};   // Invalid loop
     
     // Extract integer sample index from Q32.32 phase
-    uint32_t i = (uint32_t)(v->phase_q32_32 >> 32);
+    uint32_t i = (uint32_t)(phase_q32_32 >> 32);
 
-   // Special case: During crossfade, handle primary voice buffer overflow more gracefully
+   // Special case: A released voice handles buffer overflow more gracefully
    // This prevents loud pops from discontinuity while still allowing fade-out
-   if (crossfading && v == primary_voice) {
+   uint32_t distance_from_end = 7;  // Default: no additional fade
+   if (OUTGOING) {
        if (i >= total_samples) {
-           // If primary voice has significant amplitude, clamp to last sample to avoid pop
-           // If amplitude is very low, allow wrap to prevent unnecessary processing
-           if (v->amplitude > 0.1f) {
+           // If primary voice has significant gain, clamp to last sample to avoid pop
+           // If gain is very low, allow wrap to prevent unnecessary processing
+           if (gain_q15 > XF_GAIN_UNITY / 10) {
                i = total_samples - 1;  // Clamp to last valid sample
            } else {
                i %= total_samples;  // Safe to wrap when nearly silent
            }
        }
+       
+       // Additional safety: If we're very close to buffer end during crossfade, 
+       // apply additional amplitude reduction to ensure smooth fade-out
+       if (i >= total_samples - 8) {
+           // Calculate distance from buffer end (0-7 samples)
+           // Fade factor is 1.0 at distance 7, 0.0 at distance 0 (applied below)
+           distance_from_end = total_samples - 1 - i;
+       }
    } else {
-       if (i >= total_samples) return 0;  // Normal case: silence if past buffer
-   }
-   
-   // Additional safety: If we're very close to buffer end during crossfade, 
-   // apply additional amplitude reduction to ensure smooth fade-out
-   float additional_fade = 1.0f;  // Default: no additional fade
-   if (crossfading && v == primary_voice && i >= total_samples - 8) {
-       // Calculate distance from buffer end (0-7 samples)
-       uint32_t distance_from_end = total_samples - 1 - i;
-       // Apply additional fade factor (1.0 at distance 7, 0.0 at distance 0)
-       additional_fade = (float)distance_from_end / 7.0f;
-       additional_fade = fmaxf(0.0f, fminf(1.0f, additional_fade));
+       if (i >= total_samples) return {0, 0};  // Normal case: silence if past buffer
    }
     
+    const uint32_t frac32 = (uint32_t)(phase_q32_32 & 0xFFFFFFFFull);
+    if (IM != INTERP_LINEAR8) {
+        StereoQ15 sample = interp_fetch<DIR, OUTGOING, IM, ST>(samples, i, loop_start, loop_end, total_samples, frac32);
+        if (OUTGOING) {
+            sample.l = vk_edge_fade(sample.l, distance_from_end);
+            if (ST) sample.r = vk_edge_fade(sample.r, distance_from_end);
+        }
+        return sample;
+    }
+    
     // Get second sample for interpolation (handles loop boundaries)
+    // Ping-pong turns around at the edges, so its neighbour clamps instead of wrapping
     uint32_t i2;
-    if (is_reverse) {
-        i2 = (i > v->loop_start) ? (i - 1) : (v->loop_end - 1);  // Reverse: previous sample
+    if (DIR == DIR_PINGPONG) {
+        if (is_reverse) {
+            i2 = (i > loop_start) ? (i - 1) : i;
+        } else {
+            i2 = (i < loop_end - 1) ? (i + 1) : i;
+        }
+    } else if (is_reverse) {
+        i2 = (i > loop_start) ? (i - 1) : (loop_end - 1);  // Reverse: previous sample
     } else {
-        i2 = (i < v->loop_end - 1) ? (i + 1) : v->loop_start;   // Forward: next sample
+        i2 = (i < loop_end - 1) ? (i + 1) : loop_start;   // Forward: next sample
     }
     
     // Extract 8-bit fractional part for interpolation (0-255)
-    const uint32_t frac32 = (uint32_t)(v->phase_q32_32 & 0xFFFFFFFFull);
     const uint16_t mu8 = (uint16_t)(frac32 >> 24);  // Use upper 8 bits as interpolation weight
     
-    // Convert to unsigned for hardware interpolation, then back to signed
-    const uint16_t u0 = (uint16_t)((int32_t)samples[i] + 32768);   // Convert -32768..32767 to 0..65535
-    const uint16_t u1 = (uint16_t)((int32_t)samples[i2] + 32768);
-    const uint16_t ui = interpolate(u0, u1, mu8);  // Hardware interpolation on Pico
-    int16_t sample = (int16_t)((int32_t)ui - 32768);  // Convert back to signed
+    // One 32-bit read per frame for stereo, then one blend per channel
+    StereoQ15 sample;
+    if (ST) {
+        const uint32_t f0 = interp_frame(samples, (int32_t)i);
+        const uint32_t f1 = interp_frame(samples, (int32_t)i2);
+        sample.l = interp_hw8(interp_frame_l(f0), interp_frame_l(f1), mu8);
+        sample.r = interp_hw8(interp_frame_r(f0), interp_frame_r(f1), mu8);
+    } else {
+        sample.l = interp_hw8(samples[i], samples[i2], mu8);
+        sample.r = sample.l;
+    }
     
-    // Apply additional fade factor if near buffer end during crossfade
-    sample = (int16_t)(sample * additional_fade);
+    // Apply additional fade factor if near buffer end while fading out
+    if (OUTGOING) {
+        sample.l = vk_edge_fade(sample.l, distance_from_end);
+        if (ST) sample.r = vk_edge_fade(sample.r, distance_from_end);
+    }
     
     return sample;
 }
  
-// Calculate TZFM-modulated increment for phase accumulator
-// TZFM (Through-Zero FM) allows negative frequencies for reverse playback
-static int64_t calculate_increment(uint16_t adc_fm_raw, bool is_reverse) {
-    // Base increment from pitch controls (in Q32.32 format)
-    int64_t base_inc = (int64_t)(base_ratio * (double)(1ULL << 32));
-    
+// Get interpolated sample from mip level L
+// Phase and loop bounds are level-0 coordinates; level L runs at 2^-L rate
+template <PlayDir DIR, bool OUTGOING, interp_mode_t IM, bool ST>
+static inline StereoQ15 get_level_sample(const int16_t* level_samples, uint32_t level_total, uint32_t L,
+                                         uint64_t phase_q32_32, uint32_t loop_start, uint32_t loop_end,
+                                         int32_t gain_q15, bool is_reverse) {
+    return get_sample<DIR, OUTGOING, IM, ST>(phase_q32_32 >> L, loop_start >> L, loop_end >> L, gain_q15,
+                                         level_samples, level_total, is_reverse);
+}
+
+// Calculate TZFM-modulated target increment for the end of this block
+// TZFM (Through-Zero FM) allows negative frequencies for reverse playback.
+// Called once per block; the render loop ramps towards the result per sample,
+// which replaces the old per-sample one-pole smoothing of the modulator.
+static int64_t calculate_target_increment(int64_t base_inc_q32_32, uint16_t adc_fm_raw,
+                                          uint16_t adc_tzfm_depth_q12, bool is_reverse) {
     // Apply direction - negative for reverse playback
-    if (is_reverse) base_inc = -base_inc;
+    int64_t base_inc = is_reverse ? -base_inc_q32_32 : base_inc_q32_32;
     
-    // Apply TZFM if enabled (allows through-zero modulation)
-    if (tzfm_depth > 0.001f) {
-        // Convert FM input to bipolar (-1 to +1) from 12-bit ADC
-        float raw_mod = ((float)adc_fm_raw - 2048.0f) / 2048.0f;
-        raw_mod = fmaxf(-1.0f, fminf(1.0f, raw_mod));  // Clamp to valid range
-        
-        // One-pole smoothing to prevent clicks from rapid FM changes
-        modulator_smoothed = MODULATOR_SMOOTHING * modulator_smoothed + 
-                           (1.0f - MODULATOR_SMOOTHING) * raw_mod;
-        
-        // Apply modulation: 1.0 + (mod * depth) allows through-zero
-        float modulated = (float)base_inc * (1.0f + modulator_smoothed * tzfm_depth);
-        base_inc = (int64_t)modulated;
-    }
-    
-    // Safety limits to prevent overflow in phase accumulator
-    const int64_t MAX_INC = (1LL << 37);   // Reasonable upper limit
-    const int64_t MIN_INC = -(1LL << 37);  // Reasonable lower limit
-    if (base_inc > MAX_INC) base_inc = MAX_INC;
-    if (base_inc < MIN_INC) base_inc = MIN_INC;
-    
-    return base_inc;
+    // Apply modulation: base * (1 + mod * depth) allows through-zero, clamped to ±VK_INC_MAX
+    const int32_t mod_q15 = vk_adc_to_bipolar_q15(adc_fm_raw);          // -1..+1
+    const int32_t depth_q15 = vk_adc_to_depth_q15(adc_tzfm_depth_q12);  // 0..1
+    return vk_tzfm_increment(base_inc, mod_q15, depth_q15);
 }
  
 // Check if phase is in crossfade trigger zone
@@ -219,39 +404,739 @@ static bool is_in_crossfade_zone(uint64_t phase, uint32_t loop_start, uint32_t l
     }
 }
  
-// Setup secondary voice for crossfade
-// Initializes the incoming voice with new loop boundaries and position
-static void setup_crossfade(uint32_t xfade_len, uint32_t xfade_samples, bool is_reverse) {
-    // Secondary voice gets new loop boundaries from pending parameters
-    secondary_voice->loop_start = pending_start;
-    secondary_voice->loop_end = pending_end;
-    secondary_voice->active = true;
-    
-    // Position secondary voice at the start of the new loop region
+// ── Loop Length Snapping ─────────────────────────────────────────────────────
+// Division lengths from the tempo clock, in source samples at the playback
+// increment. Rebuilt only when the clock's table, the increment or the buffer
+// changes; per block the length knob just picks one of the divisions that fit.
+static uint32_t s_snap_len[TC_DIVISIONS];
+static uint32_t s_snap_count = 0;            // Divisions that fit the buffer
+static uint32_t s_snap_generation = 0xFFFFFFFFu;
+static int64_t  s_snap_inc = 0;
+static uint32_t s_snap_total = 0;
+
+static uint32_t snap_loop_length(uint16_t adc_len_q12, int64_t base_inc_q32_32, uint32_t total_samples) {
+    if (!tc_snap_enabled() || !tc_locked()) return 0;
+    const uint32_t gen = tc_generation();
+    if (gen != s_snap_generation || base_inc_q32_32 != s_snap_inc || total_samples != s_snap_total) {
+        const uint32_t* out_len = tc_division_samples();
+        s_snap_count = 0;
+        for (uint32_t i = 0; i < TC_DIVISIONS; ++i) {
+            const uint64_t len = ((uint64_t)out_len[i] * (uint64_t)base_inc_q32_32) >> 32;
+            if (len < 64u) continue;              // Shorter than the engine's minimum loop
+            if (len > total_samples) break;       // Longer ones won't fit either
+            s_snap_len[s_snap_count++] = (uint32_t)len;
+        }
+        s_snap_generation = gen;
+        s_snap_inc = base_inc_q32_32;
+        s_snap_total = total_samples;
+    }
+    if (s_snap_count == 0) return 0;
+    return s_snap_len[((uint32_t)adc_len_q12 * s_snap_count) >> 12];
+}
+
+// Zero-crossing snap of a raw (start, end) pair. calculate_boundaries() runs
+// several times per block on the same knob values, so the last result is
+// reused while its inputs hold.
+struct ZcSnapMemo {
+    const uint32_t* bits;          // Index the result came from
+    uint32_t raw_start, raw_end, start_hi, min_len;
+    uint32_t start, end;
+};
+static ZcSnapMemo s_zc_memo = {nullptr, 0, 0, 0, 0, 0, 0};
+
+// start snaps within [0, start_hi); the end (exclusive, 0 = keep the length
+// from the raw pair) at least min_len after the snapped start
+static void zc_snap_bounds(uint32_t raw_start, uint32_t raw_end, uint32_t start_hi, uint32_t min_len,
+                           uint32_t total_samples) {
+    ZcSnapMemo& m = s_zc_memo;
+    if (m.bits != g_zero_cross.bits || m.raw_start != raw_start || m.raw_end != raw_end ||
+        m.start_hi != start_hi || m.min_len != min_len) {
+        m.bits = g_zero_cross.bits;
+        m.raw_start = raw_start;
+        m.raw_end = raw_end;
+        m.start_hi = start_hi;
+        m.min_len = min_len;
+        m.start = zc_nearest(&g_zero_cross, raw_start, 0, start_hi);
+        m.end = m.start + (raw_end - raw_start);
+        if (m.end > total_samples) m.end = total_samples;
+        // The end is exclusive: landing it on a crossing makes the wrap from
+        // end - 1 to start repeat the step from end - 1 to end
+        if (min_len) m.end = zc_nearest(&g_zero_cross, m.end, m.start + min_len, total_samples);
+    }
+    pending_start = m.start;
+    pending_end = m.end;
+}
+
+// ── Slice Selection ──────────────────────────────────────────────────────────
+// In slice mode the start knob picks an onset from the published slice map
+// and the length knob how many slices the loop spans. The knob keeps the
+// current slice until it moves a quarter slice past the slice's edges, so a
+// noisy pot sitting on a boundary does not flip between two onsets.
+static uint32_t s_slice_idx = 0;
+
+static void select_slice(RenderCtx& ctx) {
+    ctx.slice_start = 0;
+    ctx.slice_end = 0;
+    if (!sm_slice_mode()) return;
+    const SliceMap* m = sm_current();
+    if (!m || m->samples != ctx.samples || m->frames != ctx.total_samples || m->channels != ctx.channels) return;
+
+    const uint32_t count = m->count;
+    const uint32_t at = (uint32_t)ctx.adc_start_q12 * count;   // Each slice spans 4096
+    const uint32_t lo = s_slice_idx * 4096u;
+    if (s_slice_idx >= count || at + 1024u < lo || at >= lo + 4096u + 1024u) s_slice_idx = at >> 12;
+
+    const uint32_t left = count - s_slice_idx;
+    const uint32_t span = 1u + (((uint32_t)ctx.adc_len_q12 * left) >> 12);
+    ctx.slice_start = m->pos[s_slice_idx];
+    ctx.slice_end = (span < left) ? m->pos[s_slice_idx + span] : ctx.total_samples;
+}
+
+// Calculate new loop start/end positions from the loop knobs into pending_*
+// In slice mode the selected slices set both (a snapped length still
+// replaces theirs, counted from the onset). A snapped length (ctx.snap_len) replaces the length knob; the start knob
+// then places that whole loop inside the buffer. With ctx.zc_snap both points
+// move to the nearest rising zero crossing (a tempo-snapped length is kept,
+// so only its start moves).
+static void knob_boundaries(const RenderCtx& ctx) {
+    if (ctx.slice_end) {
+        pending_start = ctx.slice_start;
+        pending_end = ctx.slice_end;
+        if (ctx.snap_len) {
+            pending_end = (ctx.snap_len < ctx.total_samples - pending_start) ? pending_start + ctx.snap_len
+                                                                              : ctx.total_samples;
+        }
+        return;
+    }
+    if (ctx.snap_len) {
+        const uint32_t snap_span = ctx.total_samples - ctx.snap_len;
+        pending_start = (uint32_t)(((uint64_t)ctx.adc_start_q12 * snap_span) / 4095u);
+        pending_end = pending_start + ctx.snap_len;
+        if (ctx.zc_snap) zc_snap_bounds(pending_start, pending_end, snap_span + 1u, 0, ctx.total_samples);
+        return;
+    }
+    const uint32_t MIN_LOOP = 2048u;  // Minimum loop length (samples)
+    const uint32_t span = (ctx.total_samples > MIN_LOOP) ? (ctx.total_samples - MIN_LOOP) : 0;
+    
+    // Map ADC values to sample positions within available range
+    pending_start = span ? (uint32_t)(((uint64_t)ctx.adc_start_q12 * span) / 4095u) : 0u;
+    uint32_t len = MIN_LOOP + (span ? (uint32_t)(((uint64_t)ctx.adc_len_q12 * span) / 4095u) : 0u);
+    pending_end = pending_start + len;
+    if (ctx.zc_snap) {
+        zc_snap_bounds(pending_start, pending_end, span + 1u, MIN_LOOP / 2u, ctx.total_samples);
+        return;
+    }
+    if (pending_end > ctx.total_samples) pending_end = ctx.total_samples;  // Clamp to buffer end
+}
+
+// Loop bounds for the knobs; a streamed sample's loop must also fit its window
+static void calculate_boundaries(const RenderCtx& ctx) {
+    knob_boundaries(ctx);
+    if (ctx.loop_cap && pending_end - pending_start > ctx.loop_cap) pending_end = pending_start + ctx.loop_cap;
+}
+ 
+// Output samples until a voice reaches the loop edge it is travelling towards
+// Used as the release time of a retriggered voice, so its current pass rings out
+static uint32_t samples_to_loop_edge(const RenderCtx& ctx, uint8_t k, bool travelling_reverse) {
+    const VoicePool& p = s_pool;
+    const int64_t phase = (int64_t)p.phase_q32_32[k];
+    const int64_t edge_q = travelling_reverse ? ((int64_t)p.loop_start[k] << 32)
+                                              : ((int64_t)p.loop_end[k] << 32);
+    int64_t dist_q = travelling_reverse ? (phase - edge_q) : (edge_q - phase);
+    if (dist_q < 0) dist_q = 0;
+
+    const uint64_t samples = (uint64_t)dist_q / (uint64_t)ctx.safe_inc_q32_32;
+    if (samples < ctx.xfade_samples) return ctx.xfade_samples;
+    return (samples > 0xFFFFFFFFull) ? 0xFFFFFFFFu : (uint32_t)samples;
+}
+
+// Move a voice to the release stage
+// A voice that is still fading in turns around on the same curve from its
+// current gain; a voice that is already releasing keeps its envelope.
+static void release_voice(uint8_t k, uint32_t release_samples, xfade_curve_t curve) {
+    VoicePool& p = s_pool;
+    XfadeRamp* env = &p.env[k];
+    if (p.stage[k] == VS_ATTACK) {
+        const uint32_t done = env->pos_q32 / (env->step_q32 ? env->step_q32 : 1u);
+        env->pos_q32 = 0u - env->pos_q32;  // Mirrored: fade-out gain here equals the current fade-in gain
+        env->remaining = done ? done : 1u;
+    } else if (p.stage[k] == VS_STEADY) {
+        xfade_start(env, release_samples, curve);
+    }
+    p.stage[k] = VS_RELEASE;
+}
+
+// Start a new primary voice at sample n of this block
+// The incoming voice fades in over the crossfade time from the pending loop
+// bounds; the old primary is released over release_samples and keeps playing.
+static void start_primary(RenderCtx& ctx, uint32_t n, bool start_reverse, uint32_t release_samples) {
+    VoicePool& p = s_pool;
+    release_voice(p.primary, release_samples, ctx.xfade_curve);
+
+    const uint8_t k = vp_alloc(&p);  // Never steals the (old) primary
+    p.primary = k;
+    p.loop_start[k] = pending_start;
+    p.loop_end[k] = pending_end;
+    p.dir[k] = start_reverse ? -1 : 1;
+    
+    // Position the voice at the start of the new loop region
     // In reverse mode, start from the end of the loop (last sample)
-    if (is_reverse) {
-        secondary_voice->phase_q32_32 = ((uint64_t)(pending_end - 1)) << 32;
+    if (start_reverse) {
+        p.phase_q32_32[k] = ((uint64_t)(pending_end - 1)) << 32;
     } else {
-        secondary_voice->phase_q32_32 = ((uint64_t)pending_start) << 32;
+        p.phase_q32_32[k] = ((uint64_t)pending_start) << 32;
     }
      
-     // Start crossfade
-     crossfading = true;
-     crossfade_samples_total = xfade_samples;
-     crossfade_samples_remaining = xfade_samples;
+     // Fade in - the ramp step is computed once here, not per sample
+     p.stage[k] = VS_ATTACK;
+     xfade_start(&p.env[k], ctx.xfade_samples, ctx.xfade_curve);
+     
+     // Render the new voice from sample n (it may already have been visited this block)
+     ctx.start_n[k] = (uint8_t)n;
+     ctx.todo_mask |= 1u << k;
      
      // Clear reset trigger
      g_reset_trigger_pending = false;
  }
- 
+
+// ── Sample Cache Spans ───────────────────────────────────────────────────────
+// Level-L sample indices [lo, hi) voice k may read over the next `ahead`
+// output samples. A looping voice near its loop edge may wrap, turn around or
+// (ping-pong) adopt the pending bounds, so its loop region is included; a
+// released voice that can run off the buffer may clamp or wrap anywhere.
+static void voice_span(const RenderCtx& ctx, uint8_t k, uint32_t ahead, uint32_t L, PlayDir dir,
+                       uint32_t& lo, uint32_t& hi) {
+    const VoicePool& p = s_pool;
+    const uint32_t total = ctx.mip_total[L];
+    const uint64_t travel_q = (uint64_t)ctx.max_inc_q32_32 * ahead;
+    const uint32_t travel = (uint32_t)(travel_q >> (32 + L)) + 1u + SC_TAP_MARGIN;
+    const uint32_t i = (uint32_t)(p.phase_q32_32[k] >> (32 + L));
+    lo = (i > travel) ? i - travel : 0u;
+    hi = (i < total) ? i + travel + 1u : total;
+
+    if (p.stage[k] != VS_RELEASE || dir == DIR_PINGPONG) {
+        const uint32_t ls = p.loop_start[k] >> L;
+        const uint32_t le = p.loop_end[k] >> L;
+        if (lo < ls || hi > le) {
+            if (ls < lo) lo = ls;
+            if (le > hi) hi = le;
+            if (dir == DIR_PINGPONG && !ctx.stream) {  // A stream reads them once the window holds them
+                if ((pending_start >> L) < lo) lo = pending_start >> L;
+                if ((pending_end >> L) > hi) hi = pending_end >> L;
+            }
+        }
+    } else if (lo == 0 || hi >= total) {
+        lo = 0;
+        hi = total;
+    }
+    if (hi > total) hi = total;
+}
+
+// Point the kernels at SRAM copies of what voice k reads this block
+// (the cache counts int16 values, so stereo spans are doubled)
+// A streamed sample reads its PSRAM window, or nothing while the span is
+// still loading (voice_base[0] = nullptr)
+static void cache_voice_bases(RenderCtx& ctx, uint8_t k, uint32_t n, PlayDir dir, uint32_t mipx) {
+    if (ctx.stream) {
+        uint32_t lo, hi;
+        voice_span(ctx, k, AUDIO_BLOCK_SIZE - n, 0, dir, lo, hi);
+        ctx.voice_base[0] = ss_voice_base(lo, hi);
+        return;
+    }
+    for (uint32_t s = 0; s <= mipx; ++s) {
+        const uint32_t L = ctx.mip_level + s;
+        uint32_t lo, hi;
+        voice_span(ctx, k, AUDIO_BLOCK_SIZE - n, L, dir, lo, hi);
+        ctx.voice_base[s] = sc_voice_base(k, (uint8_t)s, ctx.mip_samples[L], lo * ctx.channels, hi * ctx.channels);
+    }
+}
+
+// Queue copies for the blocks after this one
+static void prefetch_voice(const RenderCtx& ctx, uint8_t k, PlayDir dir, uint32_t mipx) {
+    const bool reverse = (dir == DIR_PINGPONG) ? (s_pool.dir[k] < 0) : (ctx.inc_q32_32 < 0);
+    for (uint32_t s = 0; s <= mipx; ++s) {
+        const uint32_t L = ctx.mip_level + s;
+        uint32_t lo, hi;
+        voice_span(ctx, k, AUDIO_BLOCK_SIZE * SC_PREFETCH_BLOCKS, L, dir, lo, hi);
+        sc_prefetch(k, (uint8_t)s, ctx.mip_samples[L], ctx.mip_total[L] * ctx.channels,
+                    lo * ctx.channels, hi * ctx.channels, reverse);
+    }
+}
+
+// ── Seam Cache ───────────────────────────────────────────────────────────────
+// A FWD/REV seam whose key matches the recording is replayed: its two voices
+// are stepped without reading samples and the recording is mixed in their
+// place. Anything that changes their output mid-seam cancels the replay and
+// they carry on live.
+
+// Drop a seam recording or replay in progress
+static void seam_cancel(void) {
+    if (s_seam_mode == SEAM_OFF) return;
+    if (s_seam_mode == SEAM_RECORD) seam_record_abandon();
+    s_seam_mode = SEAM_OFF;
+    s_seam_mask = 0;
+    seam_note_cancel();
+}
+
+// Record or replay the seam start_primary() just started at sample n
+// k is the outgoing voice and phase its phase at zone entry
+static void seam_begin(const RenderCtx& ctx, uint8_t k, uint64_t phase, uint32_t n, PlayDir dir) {
+    if (s_seam_mode != SEAM_OFF) return;  // Previous seam still finishing in this block - render live
+    const VoicePool& p = s_pool;
+    const uint8_t kn = p.primary;
+    if (!ctx.seam_ok || p.loop_start[k] != p.loop_start[kn] || p.loop_end[k] != p.loop_end[kn]) return;
+    if (ctx.xfade_samples > SEAM_CACHE_SAMPLES) return;
+
+    SeamKey& key = s_seam_key;
+    memset(&key, 0, sizeof(key));
+    key.src = ctx.samples;
+    key.total_samples = ctx.total_samples;
+    key.loop_start = p.loop_start[kn];
+    key.loop_end = p.loop_end[kn];
+    key.xfade_len = ctx.xfade_len;
+    key.xfade_samples = ctx.xfade_samples;
+    key.inc_q32_32 = ctx.inc_q32_32;
+    key.entry_phase_q32_32 = phase;
+    key.mip_blend_q15 = ctx.mip_blend_q15;
+    key.dir = (uint8_t)dir;
+    key.curve = (uint8_t)ctx.xfade_curve;
+    key.interp = ctx.interp;
+    key.mip_level = ctx.mip_level;
+
+    s_seam_mask = (1u << k) | (1u << kn);
+    s_seam_pos = 0;
+    s_seam_from = n;
+    if (seam_match(&key)) {
+        s_seam_mode = SEAM_PLAY;
+        seam_note_replay();
+    } else {
+        seam_record_begin(&key);
+        s_seam_mode = SEAM_RECORD;
+    }
+}
+
+// True while this block renders the seam voices exactly as they were keyed
+static bool seam_block_matches(const RenderCtx& ctx, PlayDir dir) {
+    const SeamKey& key = s_seam_key;
+    return ctx.seam_ok && key.dir == (uint8_t)dir && key.inc_q32_32 == ctx.inc_q32_32 &&
+           key.src == ctx.samples && key.interp == ctx.interp &&
+           key.mip_level == ctx.mip_level && key.mip_blend_q15 == ctx.mip_blend_q15;
+}
+
+// Step a replayed seam voice from sample n without rendering it
+// Same phase / envelope arithmetic as the kernels, in one go. Returns the
+// next sample to render (the incoming voice continues live once faded in).
+static uint32_t seam_skip_voice(const RenderCtx& ctx, uint8_t k, uint32_t n) {
+    VoicePool& p = s_pool;
+    XfadeRamp* env = &p.env[k];
+    const bool release = (p.stage[k] == VS_RELEASE);
+    uint32_t m = AUDIO_BLOCK_SIZE - n;
+    const bool done = (env->remaining <= m);
+    if (done) m = env->remaining;
+
+    p.phase_q32_32[k] += (uint64_t)(ctx.inc_q32_32 * (int64_t)m);
+    if (!release) wrap_phase(p.phase_q32_32[k], p.loop_start[k], p.loop_end[k]);
+    env->pos_q32 += env->step_q32 * m;
+    env->remaining -= m;
+    if (!done) {
+        p.gain_q15[k] = xfade_gain(env, release);
+        return AUDIO_BLOCK_SIZE;
+    }
+
+    s_seam_mask &= ~(1u << k);
+    if (release) {
+        vp_free(&p, k);
+    } else {
+        // Faded in - the last seam sample already holds it at unity
+        p.stage[k] = VS_STEADY;
+        p.gain_q15[k] = XF_GAIN_UNITY;
+        g_loop_boundaries_calculated = false;  // Force boundary recalculation
+    }
+    return n + m;
+}
+
+// ── Stream Underrun ──────────────────────────────────────────────────────────
+// Step voice k from sample n without reading samples, when its span of a
+// streamed sample is not in the window yet. It wraps or turns around at its
+// loop edges and runs its envelope as the kernels would, silently; a steady
+// voice does not start its seam while skipped. Returns the next sample to
+// render.
+static uint32_t stream_skip_voice(const RenderCtx& ctx, uint8_t k, uint32_t n, PlayDir dir, bool fm) {
+    VoicePool& p = s_pool;
+    XfadeRamp* env = &p.env[k];
+    const bool steady = (p.stage[k] == VS_STEADY);
+    const bool release = (p.stage[k] == VS_RELEASE);
+    uint32_t m = AUDIO_BLOCK_SIZE - n;
+    const bool done = !steady && env->remaining <= m;
+    if (done) m = env->remaining;
+
+    int64_t travel = 0;
+    if (fm) {
+        for (uint32_t i = n; i < n + m; ++i) travel += ctx.inc[i];
+    } else {
+        travel = ctx.inc_q32_32 * (int64_t)m;
+    }
+    if (dir == DIR_PINGPONG) {
+        p.phase_q32_32[k] += (uint64_t)((p.dir[k] < 0) ? -travel : travel);
+        reflect_phase(p.phase_q32_32[k], p.dir[k], p.loop_start[k], p.loop_end[k]);
+    } else {
+        p.phase_q32_32[k] += (uint64_t)travel;
+        if (!release) wrap_phase(p.phase_q32_32[k], p.loop_start[k], p.loop_end[k]);
+    }
+    if (steady) return AUDIO_BLOCK_SIZE;
+
+    env->pos_q32 += env->step_q32 * m;
+    env->remaining -= m;
+    if (!done) {
+        p.gain_q15[k] = xfade_gain(env, release);
+        return AUDIO_BLOCK_SIZE;
+    }
+    if (release) {
+        vp_free(&p, k);
+    } else {
+        p.stage[k] = VS_STEADY;
+        p.gain_q15[k] = XF_GAIN_UNITY;
+        g_loop_boundaries_calculated = false;  // Force boundary recalculation
+    }
+    return n + m;
+}
+
+// ── Render Kernels ───────────────────────────────────────────────────────────
+// Each kernel renders voice k into ctx.acc[n..] until the block ends or the
+// voice changes stage, and returns the next sample index to render. The
+// dispatcher then picks the kernel for the new stage.
+//  - DIR:   forward / reverse / ping-pong, resolved at compile time
+//  - FM:    per-sample increment ramp (TZFM) vs. block-constant increment
+//  - STAGE: steady primary (unity, wraps), attack (envelope, wraps),
+//           release (envelope, plays out unwrapped)
+//  - MIPX:  crossfade between two mip levels vs. read one level
+//  - IM:    interpolation kernel (interp_kernel.h)
+//  - ST:    interleaved stereo frames into acc / acc_r vs. mono into acc
+
+// Increment for sample n: ramped per sample with FM, constant otherwise
+template <bool FM>
+static inline int64_t next_increment(const RenderCtx& ctx, uint32_t n) {
+    return FM ? ctx.inc[n] : ctx.inc_q32_32;
+}
+
+// Playback direction used for interpolation, given the signed step actually applied
+template <PlayDir DIR, bool FM>
+static inline bool step_is_reverse(int64_t step) {
+    if (DIR == DIR_PINGPONG || FM) return step < 0;  // Runtime sign (TZFM can go through zero)
+    return DIR == DIR_REVERSE;
+}
+
+template <PlayDir DIR, bool FM, voice_stage_t STAGE, bool MIPX, interp_mode_t IM, bool ST>
+static uint32_t render_voice(RenderCtx& ctx, uint8_t k, uint32_t n) {
+    VoicePool& p = s_pool;
+    uint64_t phase = p.phase_q32_32[k];
+    uint32_t loop_start = p.loop_start[k];
+    uint32_t loop_end = p.loop_end[k];
+    int8_t dir = p.dir[k];
+    int32_t gain = XF_GAIN_UNITY;
+    uint32_t next = AUDIO_BLOCK_SIZE;
+    bool was_in_zone = was_in_zone_last_sample;
+
+    // Block constants in locals - the accumulator stores would otherwise force reloads
+    const uint32_t level = ctx.mip_level;
+    const int16_t* const samples = ctx.voice_base[0];
+    const uint32_t total_samples = ctx.mip_total[level];
+    const int16_t* const samples_up = MIPX ? ctx.voice_base[1] : nullptr;
+    const uint32_t total_up = MIPX ? ctx.mip_total[level + 1] : 0u;
+    const int32_t blend = ctx.mip_blend_q15;
+    const uint32_t xfade_len = ctx.xfade_len;
+    int32_t* const acc = ctx.mix;
+    int32_t* const acc_r = ST ? ctx.mix_r : nullptr;
+
+    for (; n < AUDIO_BLOCK_SIZE; ++n) {
+        if (STAGE == VS_STEADY && DIR != DIR_PINGPONG) {
+            // Check for crossfade trigger BEFORE advancing the phase
+            // This prevents premature wrapping that would interrupt crossfades
+            const bool in_zone = is_in_crossfade_zone(phase, loop_start, loop_end,
+                                                      xfade_len, DIR == DIR_REVERSE);
+            if (in_zone && !was_in_zone) {
+                was_in_zone = true;              // Prevent retriggering
+                calculate_boundaries(ctx);       // Get fresh boundaries for the incoming voice
+                start_primary(ctx, n, DIR == DIR_REVERSE, ctx.xfade_samples);
+                seam_begin(ctx, k, phase, n, DIR);
+                audio_engine_loop_led_blink();   // Visual feedback
+                next = n;                        // Release kernel renders this sample
+                break;
+            }
+            was_in_zone = in_zone;
+        }
+
+        const int64_t inc = next_increment<FM>(ctx, n);
+        int64_t step = (DIR == DIR_PINGPONG && dir < 0) ? -inc : inc;
+        phase += step;
+
+        // Ping-pong turns around at the edges; otherwise only looping voices wrap
+        bool turned = false;
+        if (DIR == DIR_PINGPONG) {
+            turned = reflect_phase(phase, dir, loop_start, loop_end);
+            if (turned) step = (dir < 0) ? -inc : inc;
+        } else if (STAGE != VS_RELEASE) {
+            wrap_phase(phase, loop_start, loop_end);
+        }
+
+        // Envelope gain, read before stepping (same order as a crossfade ramp)
+        bool stage_changed = false;
+        if (STAGE != VS_STEADY) {
+            gain = xfade_gain(&p.env[k], STAGE == VS_RELEASE);
+            if (xfade_advance(&p.env[k])) {
+                if (STAGE == VS_RELEASE) {
+                    vp_free(&p, k);  // Faded out - this sample is already silent
+                    break;
+                }
+                // Faded in - the voice plays alone at unity from this sample on
+                gain = XF_GAIN_UNITY;
+                p.stage[k] = VS_STEADY;
+                g_loop_boundaries_calculated = false;  // Force boundary recalculation
+                stage_changed = true;
+            }
+        }
+
+        const bool rev = step_is_reverse<DIR, FM>(step);
+        StereoQ15 s = get_level_sample<DIR, STAGE == VS_RELEASE && DIR != DIR_PINGPONG, IM, ST>(
+            samples, total_samples, level, phase, loop_start, loop_end, gain, rev);
+        if (MIPX) {
+            const StereoQ15 s_up = get_level_sample<DIR, STAGE == VS_RELEASE && DIR != DIR_PINGPONG, IM, ST>(
+                samples_up, total_up, level + 1, phase, loop_start, loop_end, gain, rev);
+            s.l = (int16_t)(s.l + ((((int32_t)s_up.l - s.l) * blend) >> 15));
+            if (ST) s.r = (int16_t)(s.r + ((((int32_t)s_up.r - s.r) * blend) >> 15));
+        }
+        acc[n] += (STAGE == VS_STEADY) ? (int32_t)s.l : (((int32_t)s.l * gain) >> 15);
+        if (ST) acc_r[n] += (STAGE == VS_STEADY) ? (int32_t)s.r : (((int32_t)s.r * gain) >> 15);
+
+        if (DIR == DIR_PINGPONG && STAGE != VS_RELEASE && turned) {
+            // Pick up loop knob changes at each turnaround
+            audio_engine_loop_led_blink();
+            calculate_boundaries(ctx);
+            if (pending_start != loop_start || pending_end != loop_end) {
+                const uint32_t idx = (uint32_t)(phase >> 32);
+                if (idx >= pending_start && idx < pending_end) {
+                    // Playhead is inside the new region - adopt it without a seam
+                    loop_start = pending_start;
+                    loop_end = pending_end;
+                } else {
+                    // Playhead is outside the new region - fade into it from the matching edge
+                    start_primary(ctx, n + 1, dir < 0, ctx.xfade_samples);
+                    stage_changed = true;
+                }
+            }
+        }
+
+        if (stage_changed) {
+            next = n + 1;
+            break;
+        }
+    }
+
+    // Write back the voice state
+    if (STAGE == VS_STEADY && DIR != DIR_PINGPONG) was_in_zone_last_sample = was_in_zone;
+    p.phase_q32_32[k] = phase;
+    p.loop_start[k] = loop_start;
+    p.loop_end[k] = loop_end;
+    p.dir[k] = dir;
+    if (p.active_mask & (1u << k)) p.gain_q15[k] = gain;
+    return next;
+}
+
+typedef uint32_t (*render_kernel_t)(RenderCtx& ctx, uint8_t k, uint32_t n);
+
+// With AE_INTERP_MODE fixed at compile time only that interpolator is built
+#if AE_INTERP_MODE == INTERP_AUTO
+#define AE_INTERP_SLOTS INTERP_COUNT
+#define AE_INTERP_KERNELS(DIR, STAGE, FM, ST) \
+    {{render_voice<DIR, FM, STAGE, false, INTERP_LINEAR8, ST>,  render_voice<DIR, FM, STAGE, false, INTERP_LINEAR16, ST>, \
+      render_voice<DIR, FM, STAGE, false, INTERP_HERMITE4, ST>, render_voice<DIR, FM, STAGE, false, INTERP_SINC8, ST>}, \
+     {render_voice<DIR, FM, STAGE, true, INTERP_LINEAR8, ST>,   render_voice<DIR, FM, STAGE, true, INTERP_LINEAR16, ST>, \
+      render_voice<DIR, FM, STAGE, true, INTERP_HERMITE4, ST>,  render_voice<DIR, FM, STAGE, true, INTERP_SINC8, ST>}}
+#else
+#define AE_INTERP_SLOTS 1
+#define AE_INTERP_KERNELS(DIR, STAGE, FM, ST) \
+    {{render_voice<DIR, FM, STAGE, false, (interp_mode_t)AE_INTERP_MODE, ST>}, \
+     {render_voice<DIR, FM, STAGE, true, (interp_mode_t)AE_INTERP_MODE, ST>}}
+#endif
+
+#define AE_VOICE_KERNELS(DIR, ST) \
+    {{AE_INTERP_KERNELS(DIR, VS_STEADY, false, ST),  AE_INTERP_KERNELS(DIR, VS_STEADY, true, ST)}, \
+     {AE_INTERP_KERNELS(DIR, VS_ATTACK, false, ST),  AE_INTERP_KERNELS(DIR, VS_ATTACK, true, ST)}, \
+     {AE_INTERP_KERNELS(DIR, VS_RELEASE, false, ST), AE_INTERP_KERNELS(DIR, VS_RELEASE, true, ST)}}
+
+#define AE_CHANNEL_KERNELS(ST) \
+    {AE_VOICE_KERNELS(DIR_FORWARD, ST), AE_VOICE_KERNELS(DIR_REVERSE, ST), AE_VOICE_KERNELS(DIR_PINGPONG, ST)}
+
+// With AE_STEREO at 0 only the mono kernel set is built
+#define AE_CHANNEL_SLOTS (AE_STEREO ? 2 : 1)
+
+// Kernel table indexed by [stereo][direction][voice stage][fm][mip crossfade][interpolation]
+static const render_kernel_t s_render_kernels[AE_CHANNEL_SLOTS][DIR_COUNT][VS_COUNT][2][2][AE_INTERP_SLOTS] = {
+    AE_CHANNEL_KERNELS(false),
+#if AE_STEREO
+    AE_CHANNEL_KERNELS(true),
+#endif
+};
+
+// ── Grain Kernels ────────────────────────────────────────────────────────────
+// Each grain renders from its start sample until the block or the grain
+// ends, into ctx.grain_acc. It reads the whole buffer as one forward region
+// (the scheduler keeps it inside), so the loop carries only the window,
+// the fetch and the multiply-add.
+template <interp_mode_t IM, bool ST>
+static void render_grains(RenderCtx& ctx, GrainPool& g) {
+    const uint32_t level = ctx.mip_level;
+    const int16_t* const level_samples = ctx.mip_samples[level];
+    const uint32_t total_samples = ctx.mip_total[level];
+    const uint32_t region_end = ctx.total_samples;
+    const uint32_t ch = ctx.channels;
+    int32_t* const acc = ctx.grain_acc;
+    int32_t* const acc_r = ST ? ctx.grain_acc_r : nullptr;
+
+    for (uint32_t m = g.active_mask; m; m &= m - 1u) {
+        const uint32_t k = (uint32_t)__builtin_ctz(m);
+        uint64_t phase = g.phase_q32_32[k];
+        uint32_t env = g.env_q32[k];
+        const int64_t inc = g.inc_q32_32[k];
+        const uint32_t step = g.env_step[k];
+        const uint32_t n0 = g.start_n[k];
+        const uint32_t count = (g.left[k] < AUDIO_BLOCK_SIZE - n0) ? g.left[k] : AUDIO_BLOCK_SIZE - n0;
+        const bool rev = inc < 0;
+
+        // The loop mirror when it holds this grain's reads, else PSRAM
+        const uint64_t travel_q = (uint64_t)(rev ? -inc : inc) * count;
+        const uint32_t travel = (uint32_t)(travel_q >> (32 + level)) + 1u + SC_TAP_MARGIN;
+        const uint32_t i = (uint32_t)(phase >> (32 + level));
+        const uint32_t lo = (i > travel) ? i - travel : 0u;
+        const uint32_t hi = (i + travel + 1u < total_samples) ? i + travel + 1u : total_samples;
+        const int16_t* const samples = sc_voice_base(0, 0, level_samples, lo * ch, hi * ch);
+
+        for (uint32_t n = n0; n < n0 + count; ++n) {
+            const int32_t gain = gr_window_q15(env);
+            const StereoQ15 s = get_level_sample<DIR_FORWARD, false, IM, ST>(
+                samples, total_samples, level, phase, 0, region_end, gain, rev);
+            acc[n] += ((int32_t)s.l * gain) >> 15;
+            if (ST) acc_r[n] += ((int32_t)s.r * gain) >> 15;
+            phase += (uint64_t)inc;
+            env += step;
+        }
+
+        g.phase_q32_32[k] = phase;
+        g.env_q32[k] = env;
+        g.start_n[k] = 0;
+        g.left[k] -= count;
+        if (!g.left[k]) g.active_mask &= ~(1u << k);
+    }
+}
+
+typedef void (*grain_kernel_t)(RenderCtx& ctx, GrainPool& g);
+
+#define GR_MIRROR_STEP  4096u   // Grain mirror bounds granularity (level frames, power of two)
+
+#if AE_INTERP_MODE == INTERP_AUTO
+#define AE_GRAIN_KERNELS(ST) \
+    {render_grains<INTERP_LINEAR8, ST>,  render_grains<INTERP_LINEAR16, ST>, \
+     render_grains<INTERP_HERMITE4, ST>, render_grains<INTERP_SINC8, ST>}
+#else
+#define AE_GRAIN_KERNELS(ST) {render_grains<(interp_mode_t)AE_INTERP_MODE, ST>}
+#endif
+
+// Grain kernel table indexed by [stereo][interpolation]
+static const grain_kernel_t s_grain_kernels[AE_CHANNEL_SLOTS][AE_INTERP_SLOTS] = {
+    AE_GRAIN_KERNELS(false),
+#if AE_STEREO
+    AE_GRAIN_KERNELS(true),
+#endif
+};
+
+// Schedule and render this block's grains, then mix them with the voices in
+// acc: a linear crossfade from fade0 to fade1 (of GR_FADE_BLOCKS) across the
+// block. `mirror` plans the cache mirror over the grain region (the voices
+// plan their own while they still play).
+static void render_granular(RenderCtx& ctx, const GrainBlock& b, uint32_t fade0, uint32_t fade1, bool mirror) {
+    GrainPool& g = s_grains;
+    const uint32_t st = ctx.channels - 1u;
+    const uint32_t reach = gr_schedule(&g, b);
+
+    if (mirror) {
+        // The region plus how far spray and grain travel reach past it, on a
+        // GR_MIRROR_STEP grid so a moving knob reloads the mirror only when
+        // it crosses a grid line. Without the reach when that is too long; a
+        // region longer than the mirror is read from PSRAM.
+        const uint32_t L = ctx.mip_level;
+        const uint32_t ch = ctx.channels;
+        const uint32_t fit = (SC_MIRROR_BYTES / sizeof(int16_t) / ch - 2u) << L;
+        const uint32_t step = GR_MIRROR_STEP << L;
+        uint32_t lo = ((b.region_start > reach) ? b.region_start - reach : 0u) & ~(step - 1u);
+        uint32_t hi = (b.region_end + reach + step - 1u) & ~(step - 1u);
+        if (hi - lo > fit) {
+            lo = b.region_start & ~(step - 1u);
+            hi = (b.region_end + step - 1u) & ~(step - 1u);
+        }
+        if (hi - lo > fit) {
+            lo = b.region_start;
+            hi = b.region_end;
+        }
+        lo >>= L;
+        hi = (hi >> L) + 1u;
+        if (hi > ctx.mip_total[L]) hi = ctx.mip_total[L];
+        sc_plan_mirror(ctx.mip_samples[L], lo * ch, hi * ch, nullptr, 0, 0);
+    }
+
+    // Interpolation follows the grain count the way it follows the voice count
+    interp_mode_t interp = interp_mode_for_block(b.inc_q32_32 >> ctx.mip_level, gr_active_count(&g));
+    if (g_ae_load_shed && interp > INTERP_LINEAR16) interp = INTERP_LINEAR16;
+    const uint32_t im = (AE_INTERP_MODE == INTERP_AUTO) ? (uint32_t)interp : 0u;
+
+    memset(ctx.grain_acc, 0, sizeof(ctx.grain_acc));
+    if (st) memset(ctx.grain_acc_r, 0, sizeof(ctx.grain_acc_r));
+    s_grain_kernels[st][im](ctx, g);
+
+    if (fade0 == GR_FADE_BLOCKS && fade1 == GR_FADE_BLOCKS) {
+        // Grains only - the voices left acc silent
+        memcpy(ctx.acc, ctx.grain_acc, sizeof(ctx.acc));
+        if (st) memcpy(ctx.acc_r, ctx.grain_acc_r, sizeof(ctx.acc_r));
+        return;
+    }
+    const int32_t m0 = (int32_t)((fade0 << 15) / GR_FADE_BLOCKS);
+    const int32_t m1 = (int32_t)((fade1 << 15) / GR_FADE_BLOCKS);
+    for (uint32_t i = 0; i < AUDIO_BLOCK_SIZE; ++i) {
+        const int64_t m = m0 + (m1 - m0) * (int32_t)i / (int32_t)AUDIO_BLOCK_SIZE;
+        ctx.acc[i] = (int32_t)((ctx.acc[i] * (32768 - m) + ctx.grain_acc[i] * m) >> 15);
+        if (st) ctx.acc_r[i] = (int32_t)((ctx.acc_r[i] * (32768 - m) + ctx.grain_acc_r[i] * m) >> 15);
+    }
+}
+
+// ── Load Shedding ────────────────────────────────────────────────────────────
+// Raised by audio_engine.cpp after a missed render deadline (AE_SHED_MAX)
+
+// Level 2: keep only the newest released voice ringing out
+static void shed_released_voices(VoicePool& pool) {
+    uint32_t released = 0;
+    uint8_t newest = 0;
+    for (uint32_t m = pool.active_mask; m; m &= m - 1u) {
+        const uint8_t k = (uint8_t)__builtin_ctz(m);
+        if (pool.stage[k] != VS_RELEASE) continue;
+        if (!released || (int32_t)(pool.stamp[k] - pool.stamp[newest]) > 0) newest = k;
+        released |= 1u << k;
+    }
+    released &= ~(1u << newest);
+    if (!released) return;
+    if (s_seam_mask & released) seam_cancel();
+    for (; released; released &= released - 1u) vp_free(&pool, (uint8_t)__builtin_ctz(released));
+}
+
 // ── Main Render Function ─────────────────────────────────────────────────────
-// Processes one audio block (AUDIO_BLOCK_SIZE samples) with dual-voice crossfading
+// Processes one audio block (AUDIO_BLOCK_SIZE samples) of all active voices
 
 void ae_render_block(const int16_t* samples,
                      uint32_t total_samples,
+                     uint8_t channels,
                      ae_state_t engine_state,
                      volatile uint64_t* io_phase_q32_32)
 {
+    ss_render_tick();  // A stream window may be overwritten from the next block on
+    
     // Early exit for silence - output center PWM value (no audio)
     if (engine_state != AE_STATE_PLAYING || !samples || total_samples < 2) {
         const uint16_t silence_pwm = PWM_RESOLUTION / 2;  // Center PWM value
@@ -259,8 +1144,23 @@ void ae_render_block(const int16_t* samples,
             out_buf_ptr_L[i] = silence_pwm;
             out_buf_ptr_R[i] = silence_pwm;
         }
+        rt_flush();  // Edges while stopped would all land late on the first block
+        if (rec_active()) {
+            // A take records with nothing playing too
+            RecBlock rb = {};
+            rb.input = adc_capture_next_block(REC_INPUT_CH);
+            rb.input_hold = adc_results_buf[REC_INPUT_CH];
+            rec_render_block(&rb);
+        }
         return;
     }
+    prof_block_begin();
+    
+    if (!s_pool_ready) {
+        vp_init(&s_pool);
+        s_pool_ready = true;
+    }
+    VoicePool& pool = s_pool;
     
     // ── Read Control Inputs ──────────────────────────────────────────────────
     // All ADC inputs are filtered except FM (needs fast response for TZFM)
@@ -271,11 +1171,16 @@ void ae_render_block(const int16_t* samples,
     const uint16_t adc_tzfm_depth_q12 = adc_filter_get(ADC_TZFM_DEPTH_CH); // FM depth
     const uint16_t adc_lowpass_q12 = adc_filter_get(ADC_FX1_CH);         // Lowpass filter
     const uint16_t adc_saturation_q12 = adc_filter_get(ADC_FX2_CH);      // Saturation effect
-    const uint16_t adc_fm_raw = adc_results_buf[ADC_PM_CH];  // Unfiltered for TZFM
+    // PM input at audio rate when the ADC stream is running (one sample per
+    // output sample), else the latest conversion once per block.
+    const uint16_t* pm_block = adc_capture_next_block(ADC_PM_CH);
+    const uint16_t adc_fm_raw = pm_block ? pm_block[AUDIO_BLOCK_SIZE - 1]   // Unfiltered for TZFM
+                                         : adc_results_buf[ADC_PM_CH];
      
     // ── Calculate Pitch Once ─────────────────────────────────────────────────
     // Convert ADC values to playback speed ratio (1.0 = normal speed)
     const uint8_t octave_pos = sf::ui_get_octave_position();
+    float base_ratio;
     float t_norm = ((float)adc_tune_q12 - 2048.0f) / 2048.0f;  // Convert to -1..+1
     t_norm = fmaxf(-1.0f, fminf(1.0f, t_norm));  // Clamp to valid range
     
@@ -292,181 +1197,385 @@ void ae_render_block(const int16_t* samples,
         base_ratio = octave_ratio * tune_ratio;
     }
      
-    // Update TZFM depth (0.0 = no modulation, 1.0 = full depth)
-    tzfm_depth = (float)adc_tzfm_depth_q12 / 4095.0f;
+    // Convert to Q32.32 once per block - everything per-sample is integer from here on
+    const int64_t base_inc_q32_32 = (int64_t)((double)base_ratio * (double)(1ULL << 32));
     
     // Get playback direction from UI state
+    // Ping-pong runs a positive increment; each voice's dir field supplies the sign
     const ae_mode_t mode = audio_engine_get_mode();
-    const bool is_reverse = (mode == AE_MODE_REVERSE);
+    const PlayDir dir = (mode == AE_MODE_REVERSE) ? DIR_REVERSE :
+                        (mode == AE_MODE_ALTERNATE) ? DIR_PINGPONG : DIR_FORWARD;
+    const bool fm = vk_adc_to_depth_q15(adc_tzfm_depth_q12) >= VK_TZFM_DEPTH_MIN;
     
-    // ── Calculate Loop Boundaries ────────────────────────────────────────────
-    // Lambda function to calculate new loop start/end positions from ADC values
-    auto calculate_boundaries = [&]() {
-        const uint32_t MIN_LOOP = 2048u;  // Minimum loop length (samples)
-        const uint32_t span = (total_samples > MIN_LOOP) ? (total_samples - MIN_LOOP) : 0;
-        
-        // Map ADC values to sample positions within available range
-        pending_start = span ? (uint32_t)(((uint64_t)adc_start_q12 * span) / 4095u) : 0u;
-        uint32_t len = MIN_LOOP + (span ? (uint32_t)(((uint64_t)adc_len_q12 * span) / 4095u) : 0u);
-        pending_end = pending_start + len;
-        if (pending_end > total_samples) pending_end = total_samples;  // Clamp to buffer end
-    };
+    // Retarget the per-sample increment ramp (snap on direction switch so
+    // FWD/REV changes stay instant rather than gliding through zero)
+    const int64_t target_inc = calculate_target_increment(base_inc_q32_32, adc_fm_raw,
+                                                          adc_tzfm_depth_q12, dir == DIR_REVERSE);
+    if (mode != last_mode) {
+        // Ping-pong continues in the direction the previous mode was playing
+        const int8_t pp_dir = (last_mode == AE_MODE_REVERSE) ? -1 : 1;
+        for (uint32_t k = 0; k < VP_MAX_VOICES; ++k) pool.dir[k] = pp_dir;
+        vk_inc_snap(&inc_ramp, target_inc);
+        last_mode = mode;
+    } else if (fm) {
+        vk_inc_retarget(&inc_ramp, target_inc, AUDIO_BLOCK_SIZE);
+    } else {
+        vk_inc_snap(&inc_ramp, target_inc);  // No modulation: constant increment per block
+    }
+    
+    // Static, like the fx scratch below: the render runs in an IRQ on the
+    // core-0 stack, and ctx alone is ~4 KB at 128-sample blocks. Every field
+    // is set again each block, and only one render is ever in flight.
+    static RenderCtx ctx;
+    ctx.samples = samples;
+    ctx.total_samples = total_samples;
+    ctx.channels = (AE_STEREO && channels == 2) ? 2u : 1u;
+    const uint32_t st = ctx.channels - 1u;
+    ctx.stream = ss_streaming(samples);
+    ctx.loop_cap = ctx.stream ? ss_loop_capacity() : 0u;
+    
+    // Mip levels for this buffer (level 0 only if none were built for it)
+    const SampleMipmap& mips = g_sample_mipmap;
+    const uint8_t mip_levels = (!ctx.stream && mips.level[0] == samples && mips.count[0] == total_samples &&
+                                mips.channels == ctx.channels) ? mips.levels : 1u;
+    ctx.mip_samples[0] = samples;
+    ctx.mip_total[0] = total_samples;
+    for (uint32_t l = 1; l < MIP_LEVELS; ++l) {
+        ctx.mip_samples[l] = (l < mip_levels) ? mips.level[l] : nullptr;
+        ctx.mip_total[l] = (l < mip_levels) ? mips.count[l] : 0u;
+    }
+    mip_select_level((target_inc < 0) ? -target_inc : target_inc, mip_levels, &ctx.mip_level, &ctx.mip_blend_q15);
+    const uint32_t mipx = (ctx.mip_blend_q15 > 0) ? 1u : 0u;
+    ctx.adc_start_q12 = adc_start_q12;
+    ctx.adc_len_q12 = adc_len_q12;
+    ctx.inc_q32_32 = target_inc;
+    ctx.max_inc_q32_32 = (target_inc < 0) ? -target_inc : target_inc;
+    if (fm && pm_block) {
+        // Audio-rate TZFM: one increment per captured PM sample, no ramp. The
+        // ramp ends on the last one so a fall back to block-rate stays smooth.
+        const int64_t base_inc = (dir == DIR_REVERSE) ? -base_inc_q32_32 : base_inc_q32_32;
+        const int32_t depth_q15 = vk_adc_to_depth_q15(adc_tzfm_depth_q12);
+        for (uint32_t i = 0; i < AUDIO_BLOCK_SIZE; ++i) {
+            ctx.inc[i] = vk_tzfm_increment(base_inc, vk_adc_to_bipolar_q15(pm_block[i]), depth_q15);
+            const int64_t mag = (ctx.inc[i] < 0) ? -ctx.inc[i] : ctx.inc[i];
+            if (mag > ctx.max_inc_q32_32) ctx.max_inc_q32_32 = mag;
+        }
+        vk_inc_snap(&inc_ramp, ctx.inc[AUDIO_BLOCK_SIZE - 1]);
+    } else if (fm) {
+        // One ramp for the whole pool - every voice plays at the same pitch
+        for (uint32_t i = 0; i < AUDIO_BLOCK_SIZE; ++i) {
+            ctx.inc[i] = vk_inc_next(&inc_ramp);
+            const int64_t mag = (ctx.inc[i] < 0) ? -ctx.inc[i] : ctx.inc[i];
+            if (mag > ctx.max_inc_q32_32) ctx.max_inc_q32_32 = mag;
+        }
+    }
+    
+    // Reset trigger for this block: a timestamped GPIO edge starts on its own
+    // sample; a software request (g_reset_trigger_pending) on sample 0
+    // Every GPIO edge also clocks the tempo tracker, whose divisions (when
+    // snapping) replace the free loop length from here on
+    uint32_t trig_n = 0, edge_us = 0;
+    const bool edge = !g_reset_trigger_pending && rt_take(&trig_n, &edge_us);
+    if (edge) tc_edge(edge_us);
+    const bool trig = edge || g_reset_trigger_pending;
+    ctx.snap_len = snap_loop_length(adc_len_q12, base_inc_q32_32, total_samples);
+    select_slice(ctx);  // Onsets are exact already; they are not moved to crossings
+    ctx.zc_snap = !ctx.slice_end && zc_snap_enabled() && g_zero_cross.valid &&
+                  g_zero_cross.frames == total_samples;
     
+    // ── Calculate Loop Boundaries ────────────────────────────────────────────
     // Calculate boundaries if needed (first run or manual reset)
-    if (!g_loop_boundaries_calculated || g_reset_trigger_pending) {
-        calculate_boundaries();
+    if (!g_loop_boundaries_calculated || trig) {
+        calculate_boundaries(ctx);
         g_loop_boundaries_calculated = true;
         
         // Initialize primary voice if first run (cold start)
-        if (primary_voice->loop_end == 0) {
-            primary_voice->loop_start = pending_start;
-            primary_voice->loop_end = pending_end;
-            primary_voice->phase_q32_32 = ((uint64_t)pending_start) << 32;
-            *io_phase_q32_32 = primary_voice->phase_q32_32;  // Sync global phase
+        const uint8_t k = pool.primary;
+        if (pool.loop_end[k] == 0) {
+            pool.loop_start[k] = pending_start;
+            pool.loop_end[k] = pending_end;
+            pool.phase_q32_32[k] = ((uint64_t)pending_start) << 32;
+            *io_phase_q32_32 = pool.phase_q32_32[k];  // Sync global phase
         }
     }
      
     // ── Calculate Crossfade Length ───────────────────────────────────────────
     // Crossfade length is calculated in samples, then converted to time at current pitch
     uint32_t xfade_len = 0;
-    if (primary_voice->loop_end > primary_voice->loop_start) {
-        uint32_t loop_len = primary_voice->loop_end - primary_voice->loop_start;
+    if (pool.loop_end[pool.primary] > pool.loop_start[pool.primary]) {
+        uint32_t loop_len = pool.loop_end[pool.primary] - pool.loop_start[pool.primary];
         uint32_t max_xfade = loop_len / 2;  // Maximum crossfade is half the loop length
         xfade_len = (uint32_t)((uint64_t)max_xfade * adc_xfade_q12 >> 12);  // Scale by ADC value
-        if (xfade_len < 8) xfade_len = 8;  // Minimum crossfade length
+        // Minimum crossfade length; seams at zero crossings need only one sample
+        const uint32_t min_xfade = ctx.zc_snap ? 1u : 8u;
+        if (xfade_len < min_xfade) xfade_len = min_xfade;
         if (xfade_len > max_xfade) xfade_len = max_xfade;  // Clamp to maximum
     }
     
    // Convert crossfade length to actual samples at current playback speed
    // This accounts for pitch changes - slower playback = longer crossfade time
    // Add safety check to prevent division by near-zero values
-   float safe_ratio = fmaxf(0.0001f, fabs(base_ratio));  // Prevent near-zero division
-   uint32_t xfade_samples_unclamped = (uint32_t)((((uint64_t)xfade_len) << 32) / (uint64_t)(safe_ratio * (1ULL << 32)));
+   const int64_t safe_inc = (base_inc_q32_32 > VK_XFADE_INC_MIN) ? base_inc_q32_32 : VK_XFADE_INC_MIN;
+   uint32_t xfade_samples_unclamped = (uint32_t)((((uint64_t)xfade_len) << 32) / (uint64_t)safe_inc);
    uint32_t xfade_samples = xfade_samples_unclamped;
-   if (xfade_samples < 16) xfade_samples = 16;  // Minimum crossfade duration
+   const uint32_t min_xfade_samples = ctx.zc_snap ? 1u : 16u;
+   if (xfade_samples < min_xfade_samples) xfade_samples = min_xfade_samples;  // Minimum crossfade duration
    // Note: Upper clamp removed to allow long crossfades when needed
-     
-    // ── Process Audio Samples ────────────────────────────────────────────────
-    // Main audio processing loop - processes one sample at a time for real-time response
+
+   ctx.safe_inc_q32_32 = safe_inc;
+   ctx.xfade_len = xfade_len;
+   ctx.xfade_samples = xfade_samples;
+   // Curve follows the same knob: short = linear, medium = S-curve, long = equal-power
+   ctx.xfade_curve = xfade_curve_from_adc(adc_xfade_q12);
     
+    // ── Granular Mode ────────────────────────────────────────────────────────
+    // Step the voices <-> grains crossfade one block towards the switch. The
+    // grains start from the primary's playhead; the voice pool holds still
+    // while only the grains play.
+    const uint32_t gr_fade0 = s_gr_fade;
+    const bool gr_on = gr_enabled() && !ctx.stream;
+    if (gr_on && gr_fade0 == 0) gr_reset(&s_grains, *io_phase_q32_32);
+    if (gr_on) s_gr_fade = (gr_fade0 < GR_FADE_BLOCKS) ? gr_fade0 + 1u : GR_FADE_BLOCKS;
+    else s_gr_fade = (gr_fade0 > 0) ? gr_fade0 - 1u : 0u;
+    const bool grains_run = gr_fade0 || s_gr_fade;
+    const bool voices_run = gr_fade0 < GR_FADE_BLOCKS || s_gr_fade < GR_FADE_BLOCKS;
+     
+    // ── Render Voices ────────────────────────────────────────────────────────
     // Sync phase from primary voice (in case it was updated externally)
-    primary_voice->phase_q32_32 = *io_phase_q32_32;
+    pool.phase_q32_32[pool.primary] = *io_phase_q32_32;
     
-    for (uint32_t n = 0; n < AUDIO_BLOCK_SIZE; ++n) {
-       // Calculate phase increment with TZFM modulation
-       int64_t inc = calculate_increment(adc_fm_raw, is_reverse);
-       
-       // Get current position BEFORE advancing phase (for crossfade detection)
-       uint32_t current_idx = (uint32_t)(primary_voice->phase_q32_32 >> 32);
-
-       // Check for crossfade trigger BEFORE wrapping phase
-       // This prevents premature wrapping that would interrupt crossfades
-       if (!crossfading && !g_reset_trigger_pending && xfade_len > 0) {
-           bool in_zone = is_in_crossfade_zone(primary_voice->phase_q32_32,
-                                              primary_voice->loop_start,
-                                              primary_voice->loop_end,
-                                              xfade_len, is_reverse);
-           
-           if (in_zone && !was_in_zone_last_sample) {
-               calculate_boundaries();  // Get fresh boundaries for the incoming voice
-               setup_crossfade(xfade_len, xfade_samples, is_reverse);
-               audio_engine_loop_led_blink();  // Visual feedback
-           }
-           was_in_zone_last_sample = in_zone;  // Prevent retriggering
-       }
-
-       // Advance primary voice's phase accumulator
-       primary_voice->phase_q32_32 += inc;
-
-       // Only wrap phase when not crossfading - allows primary voice to play out during fade
-       if (!crossfading) {
-           wrap_phase(primary_voice);
-       }
-        
-        // Manual trigger check (user-initiated crossfade)
-        if (g_reset_trigger_pending && !crossfading) {
-             calculate_boundaries();
-             setup_crossfade(xfade_len, xfade_samples, is_reverse);
-             audio_engine_loop_led_blink();
-         }
-         
-         // Handle crossfading between voices
-         if (crossfading) {
-             // Advance secondary voice with same increment as primary
-             secondary_voice->phase_q32_32 += inc;
-             wrap_phase(secondary_voice);  // Secondary voice always wraps normally
-             
-             // Calculate crossfade amplitudes using constant-power curves
-             // This maintains consistent loudness during the transition
-             float t = (float)(crossfade_samples_total - crossfade_samples_remaining) / 
-                      (float)crossfade_samples_total;  // Progress: 0.0 to 1.0
-             primary_voice->amplitude = cosf(M_PI_2 * t);    // Fade out: 1.0 → 0.0
-             secondary_voice->amplitude = sinf(M_PI_2 * t);  // Fade in: 0.0 → 1.0
-             
-             if (--crossfade_samples_remaining == 0) {
-                 // Crossfade complete - swap voices and clean up
-                 crossfading = false;
-                 Voice* temp = primary_voice;
-                 primary_voice = secondary_voice;  // New voice becomes primary
-                 secondary_voice = temp;           // Old voice becomes secondary
-                 secondary_voice->active = false;  // Silence old voice
-                 secondary_voice->amplitude = 0.0f;
-                 primary_voice->amplitude = 1.0f;  // Full volume for new voice
-                 g_loop_boundaries_calculated = false;  // Force boundary recalculation
-             }
-         }
-         
-         // Mix both voices with their current amplitudes
-         // Use int32_t for accumulation to prevent overflow during crossfade
-         int32_t sample = 0;
-         bool is_rev_now = (inc < 0);  // Determine actual playback direction
-         
-         if (primary_voice->active && primary_voice->amplitude > 0.0f) {
-             int16_t s = get_sample(primary_voice, samples, total_samples, is_rev_now);
-             sample += (int32_t)(s * primary_voice->amplitude);
-         }
-         
-         if (secondary_voice->active && secondary_voice->amplitude > 0.0f) {
-             int16_t s = get_sample(secondary_voice, samples, total_samples, is_rev_now);
-             sample += (int32_t)(s * secondary_voice->amplitude);
-         }
-         
-         // Clamp accumulated sample to prevent int16_t overflow
-         if (sample > 32767) sample = 32767;
-         if (sample < -32768) sample = -32768;
-         int16_t sample_clamped = (int16_t)sample;
-         
-        // Apply effects (mono path - both channels get same processed signal)
-        // Apply saturation first to add harmonics, then lowpass to shape them
-        uint16_t sat_coeff = adc_to_ladder_coefficient(adc_saturation_q12);
-        sample_clamped = s_saturation_effect.process(sample_clamped, sat_coeff);
-        
-        uint16_t lp_coeff = adc_to_ladder_coefficient(adc_lowpass_q12);
-        sample_clamped = s_lowpass_filter.process(sample_clamped, lp_coeff);
-        
-        // Convert final sample to PWM and output to both channels
-        uint16_t pwm = q15_to_pwm_u(sample_clamped);
-        out_buf_ptr_L[n] = pwm;  // Left channel
-        out_buf_ptr_R[n] = pwm;  // Right channel (mono)
+    memset(ctx.acc, 0, sizeof(ctx.acc));
+    if (st) memset(ctx.acc_r, 0, sizeof(ctx.acc_r));
+    memset(ctx.seam_acc, 0, sizeof(ctx.seam_acc));
+    ctx.mix_r = ctx.acc_r;
+    memset(ctx.start_n, 0, sizeof(ctx.start_n));
+    ctx.todo_mask = 0;
+    
+    // Reset trigger - starts a fresh primary on sample trig_n. The old one
+    // rings out to the end of its current pass instead of being cut, so fast
+    // retriggers overlap. It still renders from sample 0, so its release is
+    // lengthened by trig_n to end where it would have from the trigger.
+    // With only the grains playing, the trigger restarts their cursor instead.
+    if (trig && !voices_run) {
+        g_reset_trigger_pending = false;
+        audio_engine_loop_led_blink();
+    } else if (trig) {
+        seam_cancel();  // Seam voices go back to rendering live before one is released
+        const uint8_t k = pool.primary;
+        const bool travelling_reverse = (dir == DIR_PINGPONG) ? (pool.dir[k] < 0) : (dir == DIR_REVERSE);
+        calculate_boundaries(ctx);
+        start_primary(ctx, trig_n, dir == DIR_REVERSE, samples_to_loop_edge(ctx, k, travelling_reverse) + trig_n);
+        audio_engine_loop_led_blink();
+    }
+    
+    // Behind on deadlines: drop the older voices still ringing out
+    if (g_ae_load_shed >= 2) shed_released_voices(pool);
+    
+    // Recorder: a take, or an overdub of the primary's loop from where it
+    // starts this block (before the loop is mirrored, which an overdub
+    // ending here invalidates)
+    if (rec_active()) {
+        const uint8_t k = pool.primary;
+        const int64_t unity_err = target_inc - ((int64_t)1 << 32);
+        RecBlock rb;
+        rb.input = adc_capture_block(REC_INPUT_CH);
+        rb.input_hold = adc_results_buf[REC_INPUT_CH];
+        rb.samples = (ctx.stream || !voices_run) ? nullptr : samples;  // No overdub into a window or under grains
+        rb.total_samples = total_samples;
+        rb.channels = ctx.channels;
+        rb.play_pos = (uint32_t)(pool.phase_q32_32[k] >> 32);
+        rb.loop_start = pool.loop_start[k];
+        rb.loop_end = pool.loop_end[k];
+        rb.unity = dir == DIR_FORWARD && !fm && unity_err <= REC_UNITY_TOLERANCE && unity_err >= -REC_UNITY_TOLERANCE;
+        rec_render_block(&rb);
+    }
+    
+    // Render every active voice for the whole block; voices started mid-block
+    // are added to todo_mask with their first sample in start_n
+    if (voices_run) ctx.todo_mask |= pool.active_mask;
+    
+    // Keep the primary's loop in SRAM when it fits (plus one block of travel
+    // either side for the voices crossing its edges). A stream window's
+    // chunks come and go, so a copy of them could go stale.
+    calculate_boundaries(ctx);  // Ping-pong spans include the bounds a turnaround may adopt
+    if (!ctx.stream && voices_run) {
+        const uint8_t k = pool.primary;
+        const uint32_t edge = (uint32_t)(((uint64_t)ctx.max_inc_q32_32 * AUDIO_BLOCK_SIZE) >> 32) + SC_TAP_MARGIN;
+        const uint32_t lo = (pool.loop_start[k] > edge) ? pool.loop_start[k] - edge : 0u;
+        const uint32_t hi = pool.loop_end[k] + edge;
+        const uint32_t L = ctx.mip_level;
+        const uint32_t L1 = mipx ? L + 1 : L;
+        uint32_t hi0 = (hi >> L) + 1u;
+        uint32_t hi1 = (hi >> L1) + 1u;
+        if (hi0 > ctx.mip_total[L]) hi0 = ctx.mip_total[L];
+        if (hi1 > ctx.mip_total[L1]) hi1 = ctx.mip_total[L1];
+        const uint32_t ch = ctx.channels;
+        sc_plan_mirror(ctx.mip_samples[L], (lo >> L) * ch, hi0 * ch,
+                       mipx ? ctx.mip_samples[L1] : nullptr, (lo >> L1) * ch, hi1 * ch);
     }
     
+    // Interpolation quality for this block - drops as speed and voice count rise
+    // (rated on the mip level's read speed, not the raw increment)
+    // (capped at linear while shedding load)
+    interp_mode_t interp = interp_mode_for_block(target_inc >> ctx.mip_level, vp_active_count(&pool));
+    if (g_ae_load_shed && interp > INTERP_LINEAR16) interp = INTERP_LINEAR16;
+    const uint32_t im = (AE_INTERP_MODE == INTERP_AUTO) ? (uint32_t)interp : 0u;
+    ctx.interp = (uint8_t)interp;
+    ctx.seam_ok = !fm && dir != DIR_PINGPONG && !st && !ctx.stream && !grains_run;  // Seam recordings are mono
+    
+    // A seam in progress stays recorded / replayed only while nothing that
+    // shapes it has changed
+    if (!seam_block_matches(ctx, dir)) seam_cancel();
+    prof_mark(PROF_PARAMS);
+    bool starved = false;  // Streamed primary had nothing to read
+    while (ctx.todo_mask) {
+        const uint8_t k = (uint8_t)__builtin_ctz(ctx.todo_mask);
+        const uint32_t bit = 1u << k;
+        ctx.todo_mask &= ~bit;
+        uint32_t n = ctx.start_n[k];
+        ctx.start_n[k] = 0;
+        cache_voice_bases(ctx, k, n, dir, mipx);
+        while (n < AUDIO_BLOCK_SIZE && (pool.active_mask & bit)) {
+            if (ctx.stream && !ctx.voice_base[0]) {
+                if (k == pool.primary) starved = true;
+                n = stream_skip_voice(ctx, k, n, dir, fm);
+                continue;
+            }
+            if (s_seam_mask & bit) {
+                if (s_seam_mode == SEAM_PLAY) {
+                    const uint32_t t0 = prof_now();
+                    n = seam_skip_voice(ctx, k, n);
+                    prof_add(PROF_XFADE, prof_now() - t0);
+                    continue;
+                }
+                ctx.mix = ctx.seam_acc;
+            } else {
+                ctx.mix = ctx.acc;
+            }
+            if (AE_PROFILE && pool.stage[k] != VS_STEADY) {
+                const uint32_t t0 = prof_now();
+                n = s_render_kernels[st][dir][pool.stage[k]][fm ? 1 : 0][mipx][im](ctx, k, n);
+                prof_add(PROF_XFADE, prof_now() - t0);
+            } else {
+                n = s_render_kernels[st][dir][pool.stage[k]][fm ? 1 : 0][mipx][im](ctx, k, n);
+            }
+            if (pool.stage[k] == VS_STEADY) s_seam_mask &= ~bit;  // Incoming voice faded in
+        }
+        if (!(pool.active_mask & bit)) {
+            s_seam_mask &= ~bit;
+        } else if (!ctx.stream && !((s_seam_mask & bit) && s_seam_mode == SEAM_PLAY)) {
+            prefetch_voice(ctx, k, dir, mipx);
+        }
+    }
+    
+    // Seam voices: append to the recording, or mix the recording in their place
+    if (s_seam_mode == SEAM_RECORD) {
+        if (seam_record(ctx.seam_acc + s_seam_from, AUDIO_BLOCK_SIZE - s_seam_from)) s_seam_mode = SEAM_OFF;
+    } else if (s_seam_mode == SEAM_PLAY) {
+        const int16_t* seam = seam_data() + s_seam_pos;
+        uint32_t count = s_seam_key.xfade_samples - s_seam_pos;
+        if (count > AUDIO_BLOCK_SIZE - s_seam_from) count = AUDIO_BLOCK_SIZE - s_seam_from;
+        for (uint32_t i = 0; i < count; ++i) ctx.acc[s_seam_from + i] += seam[i];
+        s_seam_pos += count;
+        if (s_seam_pos >= s_seam_key.xfade_samples) s_seam_mode = SEAM_OFF;
+    }
+    for (uint32_t i = 0; i < AUDIO_BLOCK_SIZE; ++i) ctx.acc[i] += ctx.seam_acc[i];
+    s_seam_from = 0;
+    
+    // Grains over the loop knobs' region, mixed with (or instead of) the voices
+    if (grains_run) {
+        GrainBlock gb;
+        gb.region_start = pending_start;
+        gb.region_end = pending_end;
+        gb.total = total_samples;
+        gb.inc_q32_32 = target_inc;
+        gb.alternate = dir == DIR_PINGPONG;
+        gb.spray_q12 = adc_xfade_q12;
+        gb.trig = trig;
+        gb.trig_n = trig_n;
+        gb.sample_rate = audio_rate;
+        render_granular(ctx, gb, gr_fade0, s_gr_fade, !voices_run);
+    }
+    prof_mark(PROF_VOICE);
+    
+    // ── Effects + Output ─────────────────────────────────────────────────────
+    // The clamped mix goes through the effect slots a block at a time
+    // (fx_chain.h), then to PWM in one pass. Mono buffers run the chain once
+    // and send the result to both channels.
+    FxBlockParams fxp;
+    fx_chain_prepare(&fxp, adc_lowpass_q12, adc_saturation_q12, audio_rate);
+    static int16_t fx[AUDIO_BLOCK_SIZE];
+    static int16_t fx_r[AUDIO_BLOCK_SIZE];
+    for (uint32_t i = 0; i < AUDIO_BLOCK_SIZE; ++i) {
+        // Clamp accumulated voices to prevent int16_t overflow
+        int32_t mixed = ctx.acc[i];
+        if (mixed > 32767) mixed = 32767;
+        if (mixed < -32768) mixed = -32768;
+        fx[i] = (int16_t)mixed;
+    }
+    if (st) {
+        for (uint32_t i = 0; i < AUDIO_BLOCK_SIZE; ++i) {
+            int32_t mixed = ctx.acc_r[i];
+            if (mixed > 32767) mixed = 32767;
+            if (mixed < -32768) mixed = -32768;
+            fx_r[i] = (int16_t)mixed;
+        }
+    }
+    fx_chain_run(fx, st ? fx_r : nullptr, AUDIO_BLOCK_SIZE, &fxp);
+    if (st) {
+        for (uint32_t i = 0; i < AUDIO_BLOCK_SIZE; ++i) {
+            out_buf_ptr_L[i] = q15_to_pwm_u(fx[i]);
+            out_buf_ptr_R[i] = q15_to_pwm_u(fx_r[i]);
+        }
+    } else {
+        for (uint32_t i = 0; i < AUDIO_BLOCK_SIZE; ++i) {
+            // Convert final sample to PWM and output to both channels
+            const uint16_t pwm = q15_to_pwm_u(fx[i]);
+            out_buf_ptr_L[i] = pwm;  // Left channel
+            out_buf_ptr_R[i] = pwm;  // Right channel (mono)
+        }
+    }
+    prof_mark(PROF_PWM);
+    
     // Update global phase for external access (UI, etc.)
-    *io_phase_q32_32 = primary_voice->phase_q32_32;
+    const uint8_t primary = pool.primary;
+    *io_phase_q32_32 = pool.phase_q32_32[primary];
+    if (ctx.stream) {
+        // Where core 1 fills the window next
+        const bool reverse = (dir == DIR_PINGPONG) ? (pool.dir[primary] < 0) : (dir == DIR_REVERSE);
+        ss_note_block((uint32_t)(pool.phase_q32_32[primary] >> 32), reverse,
+                      pool.loop_start[primary], pool.loop_end[primary], starved);
+    }
     
     // ── Update Display State ─────────────────────────────────────────────────
     // Prepare visualization data for the UI display
-    uint32_t vis_primary = (uint32_t)(primary_voice->phase_q32_32 >> 32);
+    // The secondary playhead shows the most recently started other voice
+    // (the grains' cursor and region while only they play)
+    uint32_t vis_primary = (uint32_t)(pool.phase_q32_32[primary] >> 32);
     uint32_t vis_secondary = 0;
     uint8_t vis_xfading = 0;
+    uint32_t vis_start = pool.loop_start[primary];
+    uint32_t vis_end = pool.loop_end[primary];
     
-    if (crossfading) {
+    const uint32_t others = pool.active_mask & ~(1u << primary);
+    if (!voices_run) {
+        vis_primary = gr_cursor();
+        vis_start = pending_start;
+        vis_end = pending_end;
+    } else if (others) {
         vis_xfading = 1;  // Show crossfade indicator
-        vis_secondary = (uint32_t)(secondary_voice->phase_q32_32 >> 32);
+        uint8_t newest = (uint8_t)__builtin_ctz(others);
+        for (uint8_t k = newest + 1; k < VP_MAX_VOICES; ++k) {
+            if ((others & (1u << k)) && (int32_t)(pool.stamp[k] - pool.stamp[newest]) > 0) newest = k;
+        }
+        vis_secondary = (uint32_t)(pool.phase_q32_32[newest] >> 32);
     }
     
     // Convert loop boundaries to 12-bit values for display scaling
-    const uint16_t start_q12 = (uint16_t)(((uint64_t)primary_voice->loop_start * 4095u) / total_samples);
-    const uint16_t len_q12 = (uint16_t)(((uint64_t)(primary_voice->loop_end - primary_voice->loop_start) * 4095u) / total_samples);
+    const uint16_t start_q12 = (uint16_t)(((uint64_t)vis_start * 4095u) / total_samples);
+    const uint16_t len_q12 = (uint16_t)(((uint64_t)(vis_end - vis_start) * 4095u) / total_samples);
      
      publish_display_state2(start_q12, len_q12, vis_primary, total_samples, vis_xfading, vis_secondary);
- }
\ No newline at end of file
+     prof_mark(PROF_PARAMS);
+     prof_block_end();
+ }
@@ -0,0 +1,31 @@
+/**
+ * @file crossfade.cpp
+ * @brief Crossfade gain table generation
+ * 
+ * @author Brian Varren
+ * @version 1.0
+ * @date 2025
+ */
+
+#include <math.h>
+#include "crossfade.h"
+
+uint16_t g_xfade_tables[XF_CURVE_COUNT][XF_TABLE_SIZE + 1];
+
+void xfade_init_tables(void) {
+  for (uint32_t i = 0; i <= XF_TABLE_SIZE; ++i) {
+    const float t = (float)i / (float)XF_TABLE_SIZE;   // 0..1
+    const float lin = t;
+    const float s   = t * t * (3.0f - 2.0f * t);
+    const float ep  = sinf(1.57079632679f * t);
+
+    g_xfade_tables[XF_CURVE_LINEAR][i]      = (uint16_t)lrintf(lin * XF_GAIN_UNITY);
+    g_xfade_tables[XF_CURVE_SCURVE][i]      = (uint16_t)lrintf(s   * XF_GAIN_UNITY);
+    g_xfade_tables[XF_CURVE_EQUAL_POWER][i] = (uint16_t)lrintf(ep  * XF_GAIN_UNITY);
+  }
+  // Pin the endpoints exactly so a finished fade is bit-exact unity/silence
+  for (uint32_t c = 0; c < XF_CURVE_COUNT; ++c) {
+    g_xfade_tables[c][0]             = 0;
+    g_xfade_tables[c][XF_TABLE_SIZE] = XF_GAIN_UNITY;
+  }
+}
@@ -0,0 +1,109 @@
+/**
+ * @file crossfade.h
+ * @brief Integer-only crossfade gain curves for voice transitions
+ * 
+ * Crossfades between the outgoing and incoming voice are driven by a Q0.32
+ * progress accumulator that is stepped once per output sample. The step is
+ * computed once when the crossfade starts, so the per-sample cost is an add,
+ * two table reads and two small multiplies - no float, no divide, no trig.
+ * 
+ * ## Curves
+ * 
+ * Each curve is a 257-entry fade-in table of unsigned Q15 gains (32768 = 1.0).
+ * The fade-out gain is read from the same table mirrored, so one table
+ * serves both voices:
+ * 
+ * - **LINEAR**: g(t) = t. Constant amplitude; best for very short seams
+ *   where the material on both sides is nearly identical.
+ * - **SCURVE**: g(t) = 3t^2 - 2t^3 (smoothstep). Constant amplitude with
+ *   soft start/end; good general purpose curve for medium fades.
+ * - **EQUAL_POWER**: g(t) = sin(pi/2 * t). Constant power; best for long
+ *   fades between uncorrelated material.
+ * 
+ * ## XFADE Knob Mapping
+ * 
+ * The XFADE knob already sets the crossfade length. The curve follows the
+ * same knob so turning it up moves from linear (short) through S-curve to
+ * equal-power (long). The zone thresholds are below.
+ * 
+ * @author Brian Varren
+ * @version 1.0
+ * @date 2025
+ */
+
+#pragma once
+#include <stdint.h>
+
+// ── Curve Selection ──────────────────────────────────────────────────────────
+typedef enum {
+  XF_CURVE_LINEAR      = 0,
+  XF_CURVE_SCURVE      = 1,
+  XF_CURVE_EQUAL_POWER = 2,
+  XF_CURVE_COUNT
+} xfade_curve_t;
+
+// XFADE knob (0..4095) zones: below LINEAR_MAX -> linear, below SCURVE_MAX -> S-curve
+#define XF_KNOB_LINEAR_MAX   256u
+#define XF_KNOB_SCURVE_MAX   1536u
+
+// ── Gain Tables ─────────────────────────────────────────────────────────────
+#define XF_TABLE_BITS   8
+#define XF_TABLE_SIZE   (1u << XF_TABLE_BITS)   // 256 segments, 257 entries
+#define XF_GAIN_UNITY   32768                   // unsigned Q15 1.0
+
+extern uint16_t g_xfade_tables[XF_CURVE_COUNT][XF_TABLE_SIZE + 1];
+
+// Build all curve tables. Call once at init (uses float; not in the hot path).
+void xfade_init_tables(void);
+
+// Map the XFADE knob to a curve.
+static inline xfade_curve_t xfade_curve_from_adc(uint16_t adc_q12) {
+  if (adc_q12 < XF_KNOB_LINEAR_MAX) return XF_CURVE_LINEAR;
+  if (adc_q12 < XF_KNOB_SCURVE_MAX) return XF_CURVE_SCURVE;
+  return XF_CURVE_EQUAL_POWER;
+}
+
+// ── Crossfade Ramp ──────────────────────────────────────────────────────────
+// Progress runs 0 -> 2^32 over `remaining` samples. Read gains, then advance.
+struct XfadeRamp {
+  uint32_t pos_q32;        // progress, Q0.32 (0 = all outgoing)
+  uint32_t step_q32;       // progress per sample, Q0.32
+  uint32_t remaining;      // samples left, 0 = idle
+  const uint16_t* table;   // fade-in curve (fade-out reads it mirrored)
+};
+
+static inline void xfade_start(XfadeRamp* r, uint32_t samples, xfade_curve_t curve) {
+  if (samples == 0) samples = 1;
+  r->pos_q32   = 0;
+  r->step_q32  = (uint32_t)(0x100000000ull / samples);   // one divide per crossfade
+  r->remaining = samples;
+  r->table     = g_xfade_tables[curve];
+}
+
+// Current gains in unsigned Q15 (XF_GAIN_UNITY = 1.0).
+static inline void xfade_gains(const XfadeRamp* r, int32_t* out_gain, int32_t* in_gain) {
+  const uint32_t i = r->pos_q32 >> (32 - XF_TABLE_BITS);            // segment
+  const int32_t  f = (int32_t)((r->pos_q32 >> (16 - XF_TABLE_BITS)) & 0xFFFFu); // Q16 fraction
+  const uint16_t* t = r->table;
+
+  const int32_t a_in  = t[i],                 b_in  = t[i + 1];
+  const int32_t a_out = t[XF_TABLE_SIZE - i], b_out = t[XF_TABLE_SIZE - i - 1];
+  *in_gain  = a_in  + (((b_in  - a_in)  * f) >> 16);
+  *out_gain = a_out + (((b_out - a_out) * f) >> 16);
+}
+
+// Gain of one side only, for voices that carry their own envelope.
+static inline int32_t xfade_gain(const XfadeRamp* r, bool fade_out) {
+  const uint32_t i = r->pos_q32 >> (32 - XF_TABLE_BITS);
+  const int32_t  f = (int32_t)((r->pos_q32 >> (16 - XF_TABLE_BITS)) & 0xFFFFu);
+  const uint16_t* t = r->table;
+  const int32_t a = fade_out ? t[XF_TABLE_SIZE - i]     : t[i];
+  const int32_t b = fade_out ? t[XF_TABLE_SIZE - i - 1] : t[i + 1];
+  return a + (((b - a) * f) >> 16);
+}
+
+// Step one sample. Returns true when the crossfade has just finished.
+static inline bool xfade_advance(XfadeRamp* r) {
+  r->pos_q32 += r->step_q32;
+  return --r->remaining == 0;
+}
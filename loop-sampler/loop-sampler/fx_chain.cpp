@@ -0,0 +1,133 @@
+/**
+ * @file fx_chain.cpp
+ * @brief Output effect slots and the block loop that runs them
+ *
+ * @author Brian Varren
+ * @version 1.0
+ * @date 2025
+ */
+
+#include <string.h>
+#include "fx_chain.h"
+
+// ── Saturation ──────────────────────────────────────────────────────────────
+static Waveshaper s_shaper[2];
+
+static bool shaper_prepare(FxBlockParams* p) {
+  p->shaper = ws_update(p->fx2_q12);
+  return p->shaper.table != nullptr;
+}
+
+static void shaper_process(void* state, int16_t* buf, uint32_t n, const FxBlockParams* p) {
+  static_cast<Waveshaper*>(state)->process_block(buf, n, p->shaper);
+}
+
+static void shaper_reset(void* state) {
+  static_cast<Waveshaper*>(state)->reset();
+}
+
+// ── Lowpass ─────────────────────────────────────────────────────────────────
+static Ladder4PoleFilter s_lowpass[2];
+
+static bool lowpass_prepare(FxBlockParams* p) {
+  ladder4_coeffs(p->fx1_q12, LADDER_RESONANCE_Q12, p->sample_rate, &p->lowpass);
+  return !p->lowpass.bypass;
+}
+
+static void lowpass_process(void* state, int16_t* buf, uint32_t n, const FxBlockParams* p) {
+  Ladder4PoleFilter* f = static_cast<Ladder4PoleFilter*>(state);
+  f->set_target(p->lowpass, n);  // Ramped in over the block
+  f->process_block(buf, n);
+}
+
+static void lowpass_reset(void* state) {
+  static_cast<Ladder4PoleFilter*>(state)->reset();
+}
+
+// ── Delay ───────────────────────────────────────────────────────────────────
+static DelayLine s_delay[2];
+
+static bool delay_prepare(FxBlockParams* p) {
+  return dly_update(p->sample_rate, &p->delay);
+}
+
+static void delay_process(void* state, int16_t* buf, uint32_t n, const FxBlockParams* p) {
+  static_cast<DelayLine*>(state)->process_block(buf, n, p->delay);
+}
+
+static void delay_reset(void* state) {
+  static_cast<DelayLine*>(state)->reset();
+}
+
+static void delay_end(void* const* state, uint32_t n, const FxBlockParams* p) {
+  dly_end_block(static_cast<DelayLine*>(state[0]), static_cast<DelayLine*>(state[1]), n, p->sample_rate);
+}
+
+// ── Slot Table ──────────────────────────────────────────────────────────────
+static const FxSlot s_slots[] = {
+  {"saturation", shaper_prepare, shaper_process, shaper_reset, nullptr, {&s_shaper[0], &s_shaper[1]}, PROF_SATURATION},
+  {"lowpass", lowpass_prepare, lowpass_process, lowpass_reset, nullptr, {&s_lowpass[0], &s_lowpass[1]}, PROF_FILTER},
+  {"delay", delay_prepare, delay_process, delay_reset, delay_end, {&s_delay[0], &s_delay[1]}, PROF_FILTER},
+};
+#define FX_SLOT_COUNT  (sizeof(s_slots) / sizeof(s_slots[0]))
+static_assert(FX_SLOT_COUNT <= FX_MAX_SLOTS, "more slots than FX_MAX_SLOTS");
+
+static volatile uint32_t s_enabled = (1u << FX_SLOT_COUNT) - 1u;  // Set from core 1
+static uint32_t s_active = 0;           // Slots running this block
+static uint32_t s_was_active = 0;       // Slots that ran last block (reset when they stop)
+
+// ── Render ──────────────────────────────────────────────────────────────────
+void fx_chain_prepare(FxBlockParams* p, uint16_t fx1_q12, uint16_t fx2_q12, float sample_rate) {
+  p->fx1_q12 = fx1_q12;
+  p->fx2_q12 = fx2_q12;
+  p->sample_rate = sample_rate;
+  const uint32_t enabled = s_enabled;
+  uint32_t active = 0;
+  for (uint32_t s = 0; s < FX_SLOT_COUNT; ++s) {
+    if (((enabled >> s) & 1u) && s_slots[s].prepare(p)) active |= 1u << s;
+  }
+  s_active = active;
+}
+
+void fx_chain_run(int16_t* l, int16_t* r, uint32_t n, const FxBlockParams* p) {
+  const uint32_t stopped = s_was_active & ~s_active;
+  for (uint32_t s = 0; s < FX_SLOT_COUNT; ++s) {
+    const FxSlot& slot = s_slots[s];
+    if ((s_active >> s) & 1u) {
+      slot.process(slot.state[0], l, n, p);
+      if (r) slot.process(slot.state[1], r, n, p);
+      if (slot.end) slot.end(slot.state, n, p);
+    } else if ((stopped >> s) & 1u) {
+      slot.reset(slot.state[0]);
+      slot.reset(slot.state[1]);
+    }
+    prof_mark(slot.prof);
+  }
+  s_was_active = s_active;
+}
+
+// ── Control ─────────────────────────────────────────────────────────────────
+uint32_t fx_slot_count(void) {
+  return FX_SLOT_COUNT;
+}
+
+const char* fx_slot_name(uint32_t slot) {
+  return (slot < FX_SLOT_COUNT) ? s_slots[slot].name : "";
+}
+
+int fx_find_slot(const char* name) {
+  for (uint32_t s = 0; s < FX_SLOT_COUNT; ++s) {
+    if (!strcmp(s_slots[s].name, name)) return (int)s;
+  }
+  return -1;
+}
+
+void fx_set_enabled(uint32_t slot, bool on) {
+  if (slot >= FX_SLOT_COUNT) return;
+  if (on) s_enabled = s_enabled | (1u << slot);
+  else s_enabled = s_enabled & ~(1u << slot);
+}
+
+bool fx_enabled(uint32_t slot) {
+  return slot < FX_SLOT_COUNT && ((s_enabled >> slot) & 1u);
+}
@@ -0,0 +1,107 @@
+/**
+ * @file fx_chain.h
+ * @brief Block effects chain of the output stage
+ *
+ * The voices mix into an int32 block, which the renderer clamps into a Q15
+ * scratch block per channel. The chain then runs its slots over the whole
+ * block, one slot at a time, and the renderer converts the result to PWM in
+ * a single pass. Each slot's loop keeps its state and coefficients in
+ * registers for the whole block instead of interleaving every stage per
+ * sample.
+ *
+ * ## Slots
+ *
+ * The chain is a fixed array of FxSlot, in signal order:
+ *
+ * | Slot       | Effect                                    | Profiler stage |
+ * |------------|-------------------------------------------|----------------|
+ * | saturation | table waveshaper on FX2 (waveshaper.h)    | sat            |
+ * | lowpass    | resonant 4-pole ladder on FX1             | filter         |
+ * | delay      | stereo delay in PSRAM (stereo_delay.h)    | filter         |
+ *
+ * A slot has one state per channel and three hooks, plus an optional fourth:
+ *
+ * - `prepare` runs once per block, before any audio is touched. It reads the
+ *   knobs from the snapshot, works out the block's coefficients into it,
+ *   and returns false when the effect would pass the block unchanged.
+ * - `process` filters n Q15 samples of one channel in place. It reads only
+ *   the snapshot, so both channels get the same coefficients.
+ * - `reset` clears a channel's state when the slot stops running, so it
+ *   starts clean when it comes back.
+ * - `end` (or nullptr) runs once per block after both channels, for work
+ *   shared by the channels, such as the delay's line transfers.
+ *
+ * ## Bypass
+ *
+ * A slot is skipped for the block when it is disabled (fx_set_enabled()) or
+ * its prepare returns false. Neither its process hook nor, when disabled,
+ * its prepare hook is called, so a bypassed slot costs a flag test per
+ * block. Its reset hook runs once when it stops. The delay's prepare also
+ * returns false until dly_set_enabled() has allocated its lines, so the
+ * slot costs nothing at boot.
+ *
+ * Adding an effect takes a state per channel, the hooks, its fields in
+ * FxBlockParams and an entry in the slot table (fx_chain.cpp).
+ *
+ * @author Brian Varren
+ * @version 1.0
+ * @date 2025
+ */
+
+#pragma once
+#include <stdint.h>
+#include "ladder_filter.h"
+#include "waveshaper.h"
+#include "stereo_delay.h"
+#include "render_profiler.h"
+
+// ── Configuration ───────────────────────────────────────────────────────────
+#define FX_MAX_SLOTS  4u
+
+/**
+ * @brief Everything the effects read this block, taken once before the chain
+ */
+struct FxBlockParams {
+  uint16_t fx1_q12;           // Lowpass cutoff knob
+  uint16_t fx2_q12;           // Saturation drive knob
+  float    sample_rate;       // Output rate (Hz)
+  WsBlockParams shaper;       // Saturation table (prepare)
+  Ladder4Coeffs lowpass;      // Lowpass coefficients (prepare)
+  DlyBlockParams delay;       // Delay taps and levels (prepare)
+};
+
+typedef bool (*fx_prepare_fn)(FxBlockParams* p);
+typedef void (*fx_process_fn)(void* state, int16_t* buf, uint32_t n, const FxBlockParams* p);
+typedef void (*fx_reset_fn)(void* state);
+typedef void (*fx_end_fn)(void* const* state, uint32_t n, const FxBlockParams* p);
+
+struct FxSlot {
+  const char*   name;
+  fx_prepare_fn prepare;
+  fx_process_fn process;
+  fx_reset_fn   reset;
+  fx_end_fn     end;          // After both channels, or nullptr
+  void*         state[2];     // Left / right (the right one runs for stereo only)
+  prof_stage_t  prof;         // Stage the slot's time is charged to
+};
+
+// ── Render (core 0) ─────────────────────────────────────────────────────────
+
+/**
+ * @brief Take the block's parameters and prepare every enabled slot
+ */
+void fx_chain_prepare(FxBlockParams* p, uint16_t fx1_q12, uint16_t fx2_q12, float sample_rate);
+
+/**
+ * @brief Run the active slots over one block
+ * @param l Left (or mono) Q15 block, in place
+ * @param r Right Q15 block, or nullptr for a mono buffer
+ */
+void fx_chain_run(int16_t* l, int16_t* r, uint32_t n, const FxBlockParams* p);
+
+// ── Control (any core) ──────────────────────────────────────────────────────
+uint32_t fx_slot_count(void);
+const char* fx_slot_name(uint32_t slot);
+int fx_find_slot(const char* name);      // Index, or -1
+void fx_set_enabled(uint32_t slot, bool on);
+bool fx_enabled(uint32_t slot);
@@ -0,0 +1,161 @@
+/**
+ * @file granular.cpp
+ * @brief Grain scheduling and the granular mode switch
+ *
+ * The grain kernels live in audio_engine_render.cpp, next to the voice
+ * kernels whose fetch they share.
+ *
+ * @author Brian Varren
+ * @version 1.0
+ * @date 2025
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include "granular.h"
+#include "DACless.h"   // AUDIO_BLOCK_SIZE
+
+int16_t g_gr_window[GR_WIN_SIZE + 1];
+
+// ── State ───────────────────────────────────────────────────────────────────
+// Core 1 posts the switch. The render owns everything else.
+static volatile bool s_enabled = GR_ENABLED;
+
+static uint64_t s_cursor_q32_32 = 0;   // Spawn cursor (level-0 Q32.32, inside the region)
+static uint32_t s_countdown = 0;       // Samples from this block's start to the next spawn
+static uint32_t s_rng = 0x2545F491u;   // Spray (xorshift32)
+static bool s_flip = false;            // Alternate mode: direction of the last grain
+static gr_stats_t s_stats;
+
+// ── Setup ───────────────────────────────────────────────────────────────────
+
+void gr_init_tables(void) {
+  for (uint32_t i = 0; i <= GR_WIN_SIZE; ++i) {
+    const float w = 0.5f - 0.5f * cosf(6.2831853f * (float)i / (float)GR_WIN_SIZE);
+    g_gr_window[i] = (int16_t)lrintf(w * (float)GR_GAIN_Q15);
+  }
+  g_gr_window[GR_WIN_SIZE] = 0;
+}
+
+// ── Scheduling ──────────────────────────────────────────────────────────────
+
+static inline uint32_t gr_random(void) {
+  uint32_t x = s_rng;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  s_rng = x;
+  return x;
+}
+
+// Offset into a region of `len` frames, wrapped (Q32.32, either sign)
+static inline int64_t gr_wrap(int64_t rel, uint32_t len) {
+  const int64_t span = (int64_t)len << 32;
+  rel %= span;
+  return (rel < 0) ? rel + span : rel;
+}
+
+// Start a grain at sample n of the block, reading from pos (may be off the buffer)
+static void gr_spawn(GrainPool* g, uint32_t n, int64_t pos_q32_32, int64_t inc,
+                     uint32_t length, uint32_t reach, uint32_t total) {
+  const uint32_t free_mask = ~g->active_mask &
+                             ((GR_MAX_GRAINS == 32) ? 0xFFFFFFFFu : ((1u << GR_MAX_GRAINS) - 1u));
+  if (!free_mask) {
+    s_stats.dropped++;
+    return;
+  }
+
+  // Keep the whole grain inside the buffer (interpolation taps included)
+  const bool reverse = inc < 0;
+  int64_t i = pos_q32_32 >> 32;
+  const int64_t lo = reverse ? (int64_t)reach + 1 : 0;
+  const int64_t hi = reverse ? (int64_t)total - 1 : (int64_t)total - (int64_t)reach - 2;
+  if (hi < lo) i = reverse ? (int64_t)total - 1 : 0;  // Grain longer than the buffer - it plays out into silence
+  else if (i < lo) i = lo;
+  else if (i > hi) i = hi;
+
+  const uint8_t k = (uint8_t)__builtin_ctz(free_mask);
+  g->phase_q32_32[k] = ((uint64_t)i << 32) | ((uint64_t)pos_q32_32 & 0xFFFFFFFFull);
+  g->inc_q32_32[k] = inc;
+  g->env_q32[k] = 0;
+  g->env_step[k] = 0xFFFFFFFFu / length;
+  g->left[k] = length;
+  g->start_n[k] = (uint8_t)n;
+  g->active_mask |= 1u << k;
+
+  s_stats.spawned++;
+  const uint32_t count = gr_active_count(g);
+  if (count > s_stats.peak) s_stats.peak = count;
+}
+
+void gr_reset(GrainPool* g, uint64_t cursor_q32_32) {
+  g->active_mask = 0;
+  s_cursor_q32_32 = cursor_q32_32;
+  s_countdown = 0;
+}
+
+uint32_t gr_schedule(GrainPool* g, const GrainBlock& b) {
+  const uint32_t start = b.region_start;
+  const uint32_t len = (b.region_end > start) ? b.region_end - start : 1u;
+  const int64_t inc = b.inc_q32_32;
+  const uint64_t mag = (inc < 0) ? (uint64_t)-inc : (inc ? (uint64_t)inc : 1u);
+
+  // One pass of the region in output samples, split into grains
+  const uint32_t min_len = (uint32_t)(b.sample_rate * (GR_MIN_MS / 1000.0f));
+  const uint32_t max_len = (uint32_t)(b.sample_rate * (GR_MAX_MS / 1000.0f));
+  uint64_t length = (((uint64_t)len << 32) / mag) / GR_GRAINS_PER_PASS;
+  if (length < min_len) length = min_len;
+  if (length > max_len) length = max_len;
+  if (length < 1u) length = 1u;
+  uint32_t interval = (uint32_t)length / GR_OVERLAP;
+  if (interval < 1u) interval = 1u;
+  const uint32_t travel = (uint32_t)((length * mag) >> 32) + 1u;  // Frames one grain reads
+  const uint32_t spray = (uint32_t)(((uint64_t)len * b.spray_q12) >> 12);
+
+  if (b.trig) {
+    s_cursor_q32_32 = (uint64_t)((inc < 0) ? b.region_end - 1u : start) << 32;
+    s_countdown = b.trig_n;
+  }
+  int64_t rel = gr_wrap((int64_t)(s_cursor_q32_32 - ((uint64_t)start << 32)), len);
+
+  for (; s_countdown < AUDIO_BLOCK_SIZE; s_countdown += interval) {
+    const uint32_t n = s_countdown;
+    int64_t pos = ((int64_t)start << 32) + gr_wrap(rel + inc * (int64_t)n, len);
+    if (spray) pos += ((int64_t)(gr_random() % spray) - (int64_t)(spray / 2u)) * ((int64_t)1 << 32);
+    int64_t grain_inc = (inc < 0) ? -(int64_t)mag : (int64_t)mag;
+    if (b.alternate) {
+      s_flip = !s_flip;
+      if (s_flip) grain_inc = -grain_inc;
+    }
+    gr_spawn(g, n, pos, grain_inc, (uint32_t)length, travel, b.total);
+  }
+  s_countdown -= AUDIO_BLOCK_SIZE;
+
+  rel = gr_wrap(rel + inc * (int64_t)AUDIO_BLOCK_SIZE, len);
+  s_cursor_q32_32 = ((uint64_t)start << 32) + (uint64_t)rel;
+  s_stats.length = (uint32_t)length;
+  return spray / 2u + travel;
+}
+
+uint32_t gr_cursor(void) {
+  return (uint32_t)(s_cursor_q32_32 >> 32);
+}
+
+// ── Control ─────────────────────────────────────────────────────────────────
+
+void gr_set_enabled(bool on) {
+  s_enabled = on;
+}
+
+void gr_serial_command(char c) {
+  if (c == 'G') gr_set_enabled(!s_enabled);
+}
+
+bool gr_enabled(void) {
+  return s_enabled;
+}
+
+void gr_get_stats(gr_stats_t* out) {
+  *out = s_stats;
+}
@@ -0,0 +1,167 @@
+/**
+ * @file granular.h
+ * @brief Granular playback over the loaded sample
+ *
+ * With granular mode on, the render replaces the voice pool with a pool of
+ * up to GR_MAX_GRAINS short grains. Each grain plays a piece of the sample
+ * under a Hann window and then frees its slot. Grains read through the same
+ * interpolated fetch as the voices (get_sample() in audio_engine_render.cpp),
+ * at the same pitch and from the same mip level.
+ *
+ * ## Scheduling
+ *
+ * The loop knobs (and slice mode, snapping, zero crossings) set the region
+ * as usual. A spawn cursor sweeps that region at the playback speed, the way
+ * the primary voice would play it. Once per block gr_schedule():
+ *
+ * - sizes the grains: one pass of the region / GR_GRAINS_PER_PASS, clamped
+ *   to GR_MIN_MS..GR_MAX_MS
+ * - spawns a grain every grain length / GR_OVERLAP output samples, each on
+ *   its own sample within the block, at the cursor plus a random spray
+ * - advances the cursor, wrapping it in the region
+ *
+ * The crossfade knob sets the spray, from none up to the whole region.
+ * Reverse plays every grain backwards; alternate mode flips the direction
+ * from one grain to the next. A reset trigger restarts the cursor and
+ * spawns a grain on the trigger's sample. When the pool is full, a spawn is
+ * dropped, never stolen.
+ *
+ * ## Pool Layout
+ *
+ * Grain state is stored as parallel arrays, and the set of sounding grains
+ * is a bitmask. The render runs each grain over its samples of the block in
+ * a loop with no branches beyond the fetch: one window lookup, one
+ * interpolated read and one multiply-add per sample.
+ *
+ * ## Cost
+ *
+ * Sixteen grains select LINEAR16 interpolation (interp_mode_for_block()).
+ * On the host, a full pool (GR_OVERLAP 15) costs about 2.1x one looping
+ * voice per sample, and the default overlap of 4 about 1.5x. Grains read
+ * the loop mirror (sample_cache.h), planned over the region and the spray
+ * around it, and go to PSRAM only past it. Grains are charged to the
+ * profiler's voice stage.
+ *
+ * ## Control
+ *
+ * The mode is off at boot unless GR_ENABLED is set. Over serial, 'G' toggles
+ * it. Switching crossfades between the voices and the grains over
+ * GR_FADE_BLOCKS blocks. The voice pool holds still while the grains play,
+ * and picks up where it stopped. A streamed sample (sample_stream.h) keeps
+ * playing on the voices, because its PSRAM window only holds the primary's
+ * loop.
+ *
+ * @author Brian Varren
+ * @version 1.0
+ * @date 2025
+ */
+
+#pragma once
+#include <stdint.h>
+
+// ── Configuration ───────────────────────────────────────────────────────────
+#ifndef GR_ENABLED
+#define GR_ENABLED          0          // 1 = start in granular mode
+#endif
+#ifndef GR_MAX_GRAINS
+#define GR_MAX_GRAINS       16         // Grain slots (one interpolated read per sample each)
+#endif
+#define GR_GRAINS_PER_PASS  8u         // Grain length = one region pass / this
+#define GR_MIN_MS           10u        // Shortest grain
+#define GR_MAX_MS           200u       // Longest grain
+#ifndef GR_OVERLAP
+#define GR_OVERLAP          4u         // Grains sounding at once (spawn interval = length / this)
+#endif
+#define GR_GAIN_Q15         16384      // Window peak: GR_OVERLAP Hann windows sum to 2x this
+#define GR_WIN_BITS         8          // Window table: 2^GR_WIN_BITS segments
+#define GR_FADE_BLOCKS      32u        // Voices <-> grains crossfade (~14 ms at 16-sample blocks)
+
+#define GR_WIN_SIZE         (1u << GR_WIN_BITS)
+
+static_assert(GR_MAX_GRAINS >= 1 && GR_MAX_GRAINS <= 32, "GR_MAX_GRAINS must be 1..32");
+
+// ── Pool State (SoA) ────────────────────────────────────────────────────────
+struct GrainPool {
+  uint64_t phase_q32_32[GR_MAX_GRAINS];   // Level-0 Q32.32 read position
+  int64_t  inc_q32_32[GR_MAX_GRAINS];     // Signed step per output sample
+  uint32_t env_q32[GR_MAX_GRAINS];        // Window position, 0..2^32 over the grain
+  uint32_t env_step[GR_MAX_GRAINS];       // Window step per sample
+  uint32_t left[GR_MAX_GRAINS];           // Samples still to play
+  uint8_t  start_n[GR_MAX_GRAINS];        // First sample this block (spawned mid-block)
+
+  uint32_t active_mask;                   // Bit k set = grain k is sounding
+};
+
+// Hann window scaled to GR_GAIN_Q15, GR_WIN_SIZE + 1 entries (gr_init_tables())
+extern int16_t g_gr_window[GR_WIN_SIZE + 1];
+
+// Window gain at position pos (linear between table entries)
+static inline int32_t gr_window_q15(uint32_t pos_q32) {
+  const uint32_t i = pos_q32 >> (32 - GR_WIN_BITS);
+  const int32_t frac = (int32_t)((pos_q32 >> (17 - GR_WIN_BITS)) & 0x7FFFu);
+  const int32_t a = g_gr_window[i];
+  return a + (((g_gr_window[i + 1] - a) * frac) >> 15);
+}
+
+static inline uint32_t gr_active_count(const GrainPool* g) {
+  return (uint32_t)__builtin_popcount(g->active_mask);
+}
+
+/**
+ * @brief What the scheduler needs for this block
+ */
+struct GrainBlock {
+  uint32_t region_start;      // Loop region (level-0 frames)
+  uint32_t region_end;        // Exclusive
+  uint32_t total;             // Frames in the buffer
+  int64_t  inc_q32_32;        // Playback increment (negative = reverse)
+  bool     alternate;         // Ping-pong: grains alternate direction
+  uint16_t spray_q12;         // Position scatter, 4095 = the whole region
+  bool     trig;              // Reset trigger this block
+  uint32_t trig_n;            // Its sample
+  float    sample_rate;
+};
+
+// ── Setup ───────────────────────────────────────────────────────────────────
+
+/**
+ * @brief Build the window table (from audio_init())
+ */
+void gr_init_tables(void);
+
+// ── Render (core 0) ─────────────────────────────────────────────────────────
+
+/**
+ * @brief Silence the pool and move the cursor (level-0 Q32.32); the next block spawns at once
+ */
+void gr_reset(GrainPool* g, uint64_t cursor_q32_32);
+
+/**
+ * @brief Spawn this block's grains and advance the spawn cursor
+ * @return How far grains may read outside the region (frames), for the cache
+ */
+uint32_t gr_schedule(GrainPool* g, const GrainBlock& b);
+
+/**
+ * @brief Spawn cursor (level-0 frame), for the display playhead
+ */
+uint32_t gr_cursor(void);
+
+// ── Control (core 1) ────────────────────────────────────────────────────────
+void gr_set_enabled(bool on);
+
+/**
+ * @brief Serial key: 'G' toggles granular mode
+ */
+void gr_serial_command(char c);
+
+// ── Readout (any core) ──────────────────────────────────────────────────────
+typedef struct {
+  uint32_t spawned;           // Grains started
+  uint32_t dropped;           // Spawns lost to a full pool
+  uint32_t peak;              // Most grains sounding at once
+  uint32_t length;            // Last grain length (output samples)
+} gr_stats_t;
+
+bool gr_enabled(void);
+void gr_get_stats(gr_stats_t* out);
@@ -0,0 +1,48 @@
+/**
+ * @file interp_kernel.cpp
+ * @brief Polyphase windowed-sinc table generation
+ * 
+ * @author Brian Varren
+ * @version 1.0
+ * @date 2025
+ */
+
+#include <math.h>
+#include "interp_kernel.h"
+
+int16_t g_interp_sinc_table[INTERP_SINC_PHASES][INTERP_SINC_TAPS];
+
+void interp_init_tables(void) {
+  const float PI = 3.14159265359f;
+  const float CUTOFF = 0.90f;                       // Fraction of Nyquist, leaves room for the window
+  const float HALF_WIDTH = INTERP_SINC_TAPS / 2.0f; // Window spans the 8 taps
+
+  for (uint32_t p = 0; p < INTERP_SINC_PHASES; ++p) {
+    // Phase p is the fractional position between tap 3 (x[0]) and tap 4 (x[1]),
+    // rounded to the centre of its bin so nearest-phase lookup is unbiased
+    const float frac = ((float)p + 0.5f) / (float)INTERP_SINC_PHASES;
+    float c[INTERP_SINC_TAPS];
+    float sum = 0.0f;
+    for (uint32_t k = 0; k < INTERP_SINC_TAPS; ++k) {
+      const float x = (float)k - (float)INTERP_SINC_HALF - frac;   // Distance from read position
+      const float sx = CUTOFF * PI * x;
+      const float sinc = (fabsf(x) < 1e-6f) ? 1.0f : sinf(sx) / sx;
+      // Blackman window over [-HALF_WIDTH, HALF_WIDTH]
+      const float w = (x + HALF_WIDTH) / (2.0f * HALF_WIDTH);
+      const float win = 0.42f - 0.5f * cosf(2.0f * PI * w) + 0.08f * cosf(4.0f * PI * w);
+      c[k] = sinc * win;
+      sum += c[k];
+    }
+    // Normalize to unity DC gain and quantize; put the rounding residue on the
+    // largest tap so every phase sums to exactly 32768
+    int32_t total = 0;
+    uint32_t big = 0;
+    for (uint32_t k = 0; k < INTERP_SINC_TAPS; ++k) {
+      const int32_t q = (int32_t)lrintf(c[k] / sum * 32768.0f);
+      g_interp_sinc_table[p][k] = (int16_t)(q > 32767 ? 32767 : q);
+      total += g_interp_sinc_table[p][k];
+      if (fabsf(c[k]) > fabsf(c[big])) big = k;
+    }
+    g_interp_sinc_table[p][big] = (int16_t)(g_interp_sinc_table[p][big] + (32768 - total));
+  }
+}
@@ -1,20 +1,130 @@
 /**
  * @file ladder_filter.cpp
- * @brief 8-pole ladder filters using fixed-point math
- * 
- * This file implements the 8-pole ladder filter classes defined in ladder_filter.h.
- * The implementation uses only integer arithmetic for real-time performance
- * and is designed to be lightweight and efficient for audio processing.
- * 
+ * @brief Resonant 4-pole ladder (block processing) and its coefficients
+ *
+ * The 8-pole filters are implemented inline in ladder_filter.h. The 4-pole
+ * ladder runs whole blocks, so its loop lives here; its coefficients are
+ * worked out in float once per block.
+ *
  * @author Brian Varren
  * @version 1.0
  * @date 2024
  */
 
+#include <math.h>
 #include "ladder_filter.h"
 
-// The filter classes are implemented inline in the header file for efficiency.
-// This file exists for future expansion if needed (e.g., more complex filter types).
+#define LADDER_ONE       ((int32_t)1 << 28)   // 1.0 in Q28 coefficients
+#define LADDER_SIG_SHIFT 12                   // Q15 samples to Q27 signals
 
-// Currently, all functionality is implemented as inline functions in the header
-// to maximize performance in the audio interrupt context.
+static inline int32_t mul_q28(int32_t a, int32_t b) {
+    return (int32_t)(((int64_t)a * b) >> 28);
+}
+
+// tanh(y) for a Q27 signal, as the cubic y - 4/27 y^3: it meets +-1 with zero
+// slope at |y| = 1.5 and is clamped beyond. The cubic's gain is taken from a
+// Q12 copy of y and applied to y itself, so quiet signals keep their bits.
+static inline int32_t tanh_q27(int32_t y) {
+    const int32_t yq = y >> 15;  // Q12
+    if (yq >= 6144) return (int32_t)1 << 27;
+    if (yq <= -6144) return -((int32_t)1 << 27);
+    const int32_t y2 = (yq * yq) >> 12;
+    const int32_t r_q14 = 16384 - ((2427 * y2) >> 12);  // 2427 = 4/27 in Q14
+    return (int32_t)(((int64_t)y * r_q14) >> 14);
+}
+
+void ladder4_coeffs(uint16_t cutoff_q12, uint16_t resonance_q12, float sample_rate_hz, Ladder4Coeffs* out) {
+    const float one = (float)LADDER_ONE;
+    float fc = LADDER_MIN_HZ * exp2f((float)cutoff_q12 * (10.0f / 4096.0f));
+    if (fc > 0.45f * sample_rate_hz) fc = 0.45f * sample_rate_hz;
+    const float g = tanf(3.14159265f * fc / sample_rate_hz);
+    const float G = g / (1.0f + g);
+    const float G4 = (G * G) * (G * G);
+    const float k = 4.0f * (float)resonance_q12 / 4096.0f;
+    out->g = (int32_t)(G * one);
+    out->g4 = (int32_t)(G4 * one);
+    out->inv = (int32_t)(one / (1.0f + k * G4));
+    out->k = (int32_t)(k * one);
+    out->makeup = (int32_t)((1.0f + 0.5f * k) * one);  // Half the DC loss of 1 / (1 + k)
+    out->bypass = cutoff_q12 >= LADDER_OPEN_Q12;
+}
+
+// One trapezoidal (TPT) one-pole lowpass stage; s is its integrator state
+static inline int32_t tpt_stage(int32_t in, int32_t g, int32_t& s) {
+    const int32_t v = mul_q28(g, in - s);
+    const int32_t y = v + s;
+    s = y + v;
+    return y;
+}
+
+// ── Ladder4PoleFilter ───────────────────────────────────────────────────────
+void Ladder4PoleFilter::reset() {
+    s1 = s2 = s3 = s4 = 0;
+    cur = Ladder4Coeffs();
+    cur.bypass = true;
+    d_g = d_g4 = d_inv = 0;
+    active = false;
+}
+
+void Ladder4PoleFilter::set_target(const Ladder4Coeffs& c, uint32_t n) {
+    if (c.bypass) {
+        if (active) reset();  // Next use starts from its own input again
+        return;
+    }
+    if (!active || n == 0) {
+        cur = c;  // Coming out of bypass: no ramp from stale coefficients
+        d_g = d_g4 = d_inv = 0;
+        return;
+    }
+    // The resonance is block-constant; the cutoff terms glide to the target
+    d_g = (c.g - cur.g) / (int32_t)n;
+    d_g4 = (c.g4 - cur.g4) / (int32_t)n;
+    d_inv = (c.inv - cur.inv) / (int32_t)n;
+    cur.k = c.k;
+    cur.makeup = c.makeup;
+    cur.bypass = false;
+}
+
+void Ladder4PoleFilter::process_block(int16_t* buf, uint32_t n) {
+    if (cur.bypass || n == 0) return;
+    if (!active) {
+        // Start settled on the first input (the DC steady state: every stage
+        // holds x * makeup / (1 + k)), so leaving bypass does not click
+        const int32_t x = mul_q28((int32_t)buf[0] * (1 << LADDER_SIG_SHIFT), cur.makeup);
+        s1 = s2 = s3 = s4 = (int32_t)(((int64_t)x * LADDER_ONE) / (LADDER_ONE + cur.k));
+        active = true;
+    }
+
+    int32_t g = cur.g, g4 = cur.g4, inv = cur.inv;
+    const int32_t k = cur.k, makeup = cur.makeup;
+    int32_t a = s1, b = s2, c = s3, d = s4;
+    for (uint32_t i = 0; i < n; ++i) {
+        int32_t u = (int32_t)buf[i] * (1 << LADDER_SIG_SHIFT);
+        if (k) {
+            const int32_t x = mul_q28(u, makeup);
+
+            // Solve the loop: y4 = (G^4 x + S) / (1 + k G^4), where S is each
+            // stage's (1 - G) s carried through the stages after it
+            int32_t sigma = mul_q28(a, g) + b;
+            sigma = mul_q28(sigma, g) + c;
+            sigma = mul_q28(sigma, g) + d;
+            sigma = mul_q28(sigma, LADDER_ONE - g);
+            const int32_t y4 = mul_q28(mul_q28(g4, x) + sigma, inv);
+            u = x - mul_q28(k, LADDER_TANH_FEEDBACK ? tanh_q27(y4) : y4);
+        }
+
+        const int32_t y = tpt_stage(tpt_stage(tpt_stage(tpt_stage(u, g, a), g, b), g, c), g, d);
+
+        int32_t out = (y + (1 << (LADDER_SIG_SHIFT - 1))) >> LADDER_SIG_SHIFT;
+        if (out > 32767) out = 32767;
+        if (out < -32768) out = -32768;
+        buf[i] = (int16_t)out;
+
+        g += d_g;
+        g4 += d_g4;
+        inv += d_inv;
+    }
+    s1 = a; s2 = b; s3 = c; s4 = d;
+    cur.g = g; cur.g4 = g4; cur.inv = inv;
+    d_g = d_g4 = d_inv = 0;  // Hold the target until the next set_target()
+}
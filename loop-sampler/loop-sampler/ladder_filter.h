@@ -1,17 +1,20 @@
 /**
  * @file ladder_filter.h
- * @brief 8-pole ladder filters and saturation using fixed-point math
+ * @brief Ladder filters using fixed-point math
  * 
- * This header provides 8-pole ladder lowpass and highpass filters plus
- * a saturation effect implemented using fixed-point arithmetic for real-time audio processing.
+ * This header provides a resonant 4-pole ladder lowpass (the output filter),
+ * and 8-pole ladder lowpass and highpass filters, all implemented using
+ * fixed-point arithmetic for real-time audio processing.
  * The filters are based on the classic Moog ladder filter design but extended
  * to 8 poles for more aggressive filtering characteristics.
  * 
  * ## Filter Types
  * 
+ * **4-Pole Resonant Ladder**: Zero-delay-feedback (TPT) Moog ladder with
+ * resonance, optionally through a tanh approximation. Processes whole blocks
+ * with coefficients set once per block and ramped per sample.
  * **8-Pole Lowpass Filter**: Cascaded 8-pole ladder filter that attenuates high frequencies
  * **8-Pole Highpass Filter**: Cascaded 8-pole ladder filter that attenuates low frequencies
- * **Saturation Effect**: Soft clipping saturation that adds harmonic distortion
  * 
  * ## Fixed-Point Math
  * 
@@ -22,8 +25,8 @@
  * 
  * ## Usage
  * 
- * The filters are designed to be controlled by ADC inputs (ADC5 for lowpass,
- * ADC6 for saturation) and applied to the audio output in real-time.
+ * The output lowpass is controlled by ADC5 and applied to the audio output
+ * in real-time. Saturation (ADC6) is the table waveshaper in waveshaper.h.
  * 
  * @author Brian Varren
  * @version 1.1
@@ -33,6 +36,16 @@
 #pragma once
 #include <stdint.h>
 
+// ── Configuration ───────────────────────────────────────────────────────────
+#ifndef LADDER_RESONANCE_Q12
+#define LADDER_RESONANCE_Q12  0u       // Output filter resonance, 0..4095 = feedback k 0..4 (no panel control)
+#endif
+#ifndef LADDER_TANH_FEEDBACK
+#define LADDER_TANH_FEEDBACK  1        // 1 = resonance feeds back through a tanh approximation
+#endif
+#define LADDER_OPEN_Q12       4064u    // Cutoff knob at or above this bypasses the filter
+#define LADDER_MIN_HZ         20.0f    // Cutoff at knob 0; each 4096 / 10 steps up is an octave
+
 /**
  * @class Ladder8PoleLowpassFilter
  * @brief 8-pole ladder lowpass filter using fixed-point math
@@ -248,85 +261,71 @@ private:
 };
 
 /**
- * @class SaturationEffect
- * @brief Soft clipping saturation effect using fixed-point math
- * 
- * Implements a soft clipping saturation effect that adds harmonic distortion
- * and warmth to the audio signal. The saturation amount is controlled by
- * the effect coefficient (0-32767). Higher values = more saturation.
- * 
- * Uses a tanh-like soft clipping curve implemented with fixed-point arithmetic
- * for real-time performance.
+ * @brief Block coefficients of Ladder4PoleFilter (Q28: 1.0 = 1 << 28)
+ */
+struct Ladder4Coeffs {
+    int32_t g;        // One-pole gain G = g / (1 + g), g = tan(pi fc / fs)
+    int32_t g4;       // G^4
+    int32_t inv;      // 1 / (1 + k G^4): solves the zero-delay feedback loop
+    int32_t k;        // Feedback (0..4)
+    int32_t makeup;   // Input gain making up part of the passband lost to k
+    bool bypass;      // Cutoff fully open: pass the block through
+};
+
+/**
+ * @brief Coefficients for a cutoff knob, resonance and sample rate
+ *
+ * The cutoff knob maps exponentially from LADDER_MIN_HZ over ten octaves
+ * (clamped below Nyquist), and at LADDER_OPEN_Q12 and above the filter is
+ * bypassed. Float math, once per block.
+ *
+ * @param cutoff_q12 Cutoff knob (0-4095)
+ * @param resonance_q12 Resonance (0-4095 = k 0..4, self-oscillation at the top)
+ * @param sample_rate_hz Output rate
+ */
+void ladder4_coeffs(uint16_t cutoff_q12, uint16_t resonance_q12, float sample_rate_hz, Ladder4Coeffs* out);
+
+/**
+ * @class Ladder4PoleFilter
+ * @brief Resonant 4-pole ladder lowpass, zero-delay feedback, Q27 state
+ *
+ * Four trapezoidal one-pole stages (v = G (x - s), y = v + s, s' = y + v)
+ * with the output fed back to the input. The feedback loop is solved each
+ * sample without a unit delay: y4 = (G^4 x + S) / (1 + k G^4), where S
+ * collects the stage states. With LADDER_TANH_FEEDBACK the fed-back signal
+ * goes through a cubic tanh approximation, which bounds self-oscillation and
+ * compresses loud resonant peaks. Otherwise the loop is linear. With k = 0
+ * the loop is skipped and only the four stages run.
+ *
+ * Signals are Q15 samples scaled to Q27 in 32-bit words (16x headroom).
+ * Coefficients are Q28. set_target() takes a block's coefficients, and
+ * process_block() ramps them linearly over the block, so no divide or
+ * transcendental runs per sample.
  */
-class SaturationEffect {
+class Ladder4PoleFilter {
 public:
-    SaturationEffect() : 
-        initialized(false), last_coefficient(0) {}
-    
+    Ladder4PoleFilter() { reset(); }
+
     /**
-     * @brief Process one audio sample through the saturation effect
-     * @param input Input sample in Q15 format (-32768 to +32767)
-     * @param coefficient Saturation coefficient (0-32767, higher = more saturation)
-     * @return Saturated output sample in Q15 format
+     * @brief Coefficients to reach by the end of the next n samples
      */
-    inline int16_t process(int16_t input, uint16_t coefficient) {
-        // If coefficient is 0, bypass the effect
-        if (coefficient == 0) {
-            last_coefficient = 0;
-            return input;
-        }
-        
-        // Convert input to float for easier math
-        float input_f = (float)input / 32768.0f;
-        
-        // Calculate saturation amount (0.0 to 1.0)
-        float saturation_amount = (float)coefficient / 32767.0f;
-        
-        // Apply soft clipping using a tanh-like curve
-        // Scale input by saturation amount, then apply soft clipping
-        float scaled_input = input_f * (1.0f + saturation_amount * 2.0f);
-        
-        // Soft clipping using a polynomial approximation of tanh
-        float output_f;
-        if (scaled_input > 1.0f) {
-            output_f = 1.0f;
-        } else if (scaled_input < -1.0f) {
-            output_f = -1.0f;
-        } else {
-            // Polynomial approximation of tanh for soft clipping
-            // tanh(x) ≈ x - x³/3 + 2x⁵/15 (for small x)
-            float x = scaled_input;
-            float x3 = x * x * x;
-            float x5 = x3 * x * x;
-            output_f = x - (x3 / 3.0f) + (2.0f * x5 / 15.0f);
-        }
-        
-        // Mix original and saturated signal based on coefficient
-        float mix_factor = saturation_amount;
-        output_f = input_f * (1.0f - mix_factor) + output_f * mix_factor;
-        
-        // Convert back to Q15 format
-        int32_t output_i32 = (int32_t)(output_f * 32768.0f);
-        
-        // Clamp to prevent overflow
-        if (output_i32 > 32767) output_i32 = 32767;
-        if (output_i32 < -32768) output_i32 = -32768;
-        
-        last_coefficient = coefficient;
-        return (int16_t)output_i32;
-    }
-    
+    void set_target(const Ladder4Coeffs& c, uint32_t n);
+
     /**
-     * @brief Reset the effect state
+     * @brief Filter n Q15 samples in place
      */
-    inline void reset() {
-        initialized = false;
-        last_coefficient = 0;
-    }
-    
+    void process_block(int16_t* buf, uint32_t n);
+
+    /**
+     * @brief Reset the filter state
+     */
+    void reset();
+
 private:
-    bool initialized;
-    uint16_t last_coefficient;  // Track coefficient changes for proper bypass
+    int32_t s1, s2, s3, s4;           // Stage states, Q27
+    Ladder4Coeffs cur;                // Coefficients at the next sample
+    int32_t d_g, d_g4, d_inv;         // Per-sample ramp steps
+    bool active;                      // Coefficients / state hold a filtered signal
 };
 
 /**
@@ -19,6 +19,10 @@
  * - Handles file browsing and waveform visualization
  * - Processes encoder and button inputs
  * - Updates display at ~60Hz independently of audio processing
+ * - Scans each loaded sample for onsets and publishes its slice map
+ * - Publishes recorder takes and refreshes the loop after an overdub
+ * - Streams files larger than PSRAM from the SD card into a window around
+ *   the playhead (sample_stream.h)
  * 
  * ## Key Features
  * 
@@ -27,7 +31,17 @@
  * - **Pitch Shifting**: Octave switching + fine tune control
  * - **LFO Mode**: Ultra-slow playback for creating evolving textures
  * - **Reset Trigger**: GPIO18 input for tempo sync and loop reset with crossfading
- * - **PSRAM Storage**: Large sample buffers (up to 8MB) for long recordings
+ * - **PSRAM Storage**: Large sample buffers (up to 8MB) for long recordings;
+ *   longer files stream from the SD card, the playing loop held in PSRAM
+ * - **Live Recording**: Takes from the audio input straight into PSRAM, and
+ *   overdubs onto the playing loop ('R' / 'O' over serial, recorder.h)
+ * - **Saturation Curves**: Table waveshaper on FX2 with tanh, tube and fold
+ *   curves and optional 2x oversampling ('W' / 'X' over serial, waveshaper.h)
+ * - **Stereo Delay**: Lines in PSRAM moved by DMA a block at a time, synced
+ *   to the reset-trigger tempo, with filtered feedback ('D' / 'T' over
+ *   serial, stereo_delay.h)
+ * - **Granular Mode**: Up to 16 windowed grains sprayed over the loop
+ *   region in place of the looping voice ('G' over serial, granular.h)
  * - **Q15 Audio Processing**: Fixed-point DSP for consistent performance
  * 
  * ## Hardware Requirements
@@ -53,6 +67,12 @@
  * 
  * The reset trigger on GPIO18 provides tempo sync functionality:
  * - Active-high trigger (rising edge to reset)
+ * - Edges are timestamped in a GPIO IRQ and start on the matching output
+ *   sample, a constant AUDIO_BUFFER_DEPTH blocks later (reset_trigger.h)
+ * - The edges also drive a tempo tracker; with loop snap on, the length
+ *   knob picks 1/16 note .. 4 bars of the detected tempo (tempo_clock.h)
+ * - In slice mode the start knob picks an onset and a trigger restarts the
+ *   loop exactly on it (slice_map.h)
  * - Resets phase accumulator to loop start position
  * - Forces re-read of all ADC inputs for current loop parameters
  * - Recalculates loop region based on current knob positions
@@ -82,6 +102,16 @@
 #include "storage_wav_meta.h"
 #include "sf_globals_bridge.h"
 #include "audio_engine.h"
+#include "render_profiler.h"
+#include "serial_commands.h"
+#include "reset_trigger.h"
+#include "tempo_clock.h"
+#include "slice_map.h"
+#include "recorder.h"
+#include "sample_stream.h"
+#include "waveshaper.h"
+#include "stereo_delay.h"
+#include "granular.h"
 
 using namespace sf;
 
@@ -96,11 +126,14 @@ uint8_t* audioData = nullptr;         // PSRAM buffer containing Q15 audio sampl
                                     // for consistent fixed-point arithmetic
 
 uint32_t audioDataSize = 0;           // Total bytes allocated in PSRAM buffer
-                                    // Should equal audioSampleCount * 2 (2 bytes per Q15 sample)
+                                    // Should equal audioSampleCount * audioChannels * 2 (2 bytes per Q15 value)
 
-uint32_t audioSampleCount = 0;        // Number of Q15 samples in the buffer
+uint32_t audioSampleCount = 0;        // Number of sample frames in the buffer
                                     // This is the length of the loaded audio file
-                                    // after conversion to mono and normalization
+                                    // after conversion to Q15 and normalization
+
+uint8_t audioChannels = 1;            // Q15 values per frame: 1 = mono (default),
+                                    // 2 = interleaved L/R (SF_LOAD_STEREO)
 
 WavInfo currentWav;                    // Metadata from the original WAV file
                                     // Contains sample rate, bit depth, channels, etc.
@@ -245,16 +278,13 @@ void setup1(){
  * - Maintains timing for audio callbacks
  * 
  * The loop is intentionally simple to maintain real-time performance.
- * All heavy processing is done in the audio_tick() function.
+ * Blocks are rendered from the DMA-pended render IRQ (AE_RENDER_IRQ), so
+ * nothing here can delay them; audio_tick() only renders with polling.
  */
 void loop() {
-  // Process audio engine - this handles the main audio processing loop
-  // including sample playback, crossfading, and control input processing
+  // Render a pending block when AE_RENDER_IRQ is off (no-op otherwise)
   audio_tick();
   
-  // Poll for reset trigger on GPIO18
-  audio_engine_reset_trigger_poll();
-  
   // Update loop LED state
   audio_engine_loop_led_update();
 
@@ -275,6 +305,111 @@ void loop() {
     last_mode = current_mode;
   }
   
+  // Report missed render deadlines (at most once a second)
+  static uint32_t last_deadline_report = 0;
+  static uint32_t last_late_blocks = 0;
+  if (millis() - last_deadline_report >= 1000) {
+    last_deadline_report = millis();
+    ae_deadline_stats_t dl;
+    audio_engine_get_deadline_stats(&dl);
+    if (dl.deadline_misses + dl.underruns != last_late_blocks) {
+      last_late_blocks = dl.deadline_misses + dl.underruns;
+      Serial.printf("[AE] Render late: %lu misses, %lu underruns, worst %lu/%lu us, shed %u\n",
+                    (unsigned long)dl.deadline_misses, (unsigned long)dl.underruns,
+                    (unsigned long)dl.worst_us, (unsigned long)dl.deadline_us, (unsigned)dl.shed_level);
+    }
+    
+    // Reset trigger latency distribution, when new triggers have arrived
+    static uint32_t last_triggers = 0;
+    rt_stats_t rt;
+    rt_get_stats(&rt);
+    if (rt.triggers != last_triggers) {
+      last_triggers = rt.triggers;
+      Serial.printf("[AE] Trigger latency: %lu trig, %lu/%lu/%lu us min/avg/max (nominal %lu), %lu late, %lu dropped\n",
+                    (unsigned long)rt.triggers, (unsigned long)rt.min_us, (unsigned long)rt.avg_us,
+                    (unsigned long)rt.max_us, (unsigned long)rt.nominal_us, (unsigned long)rt.late,
+                    (unsigned long)rt.dropped);
+      Serial.printf("[AE]   late by 0/1/2-3/4-7/8-15/16-31/32-63/64+ samples: %lu %lu %lu %lu %lu %lu %lu %lu\n",
+                    (unsigned long)rt.hist[0], (unsigned long)rt.hist[1], (unsigned long)rt.hist[2],
+                    (unsigned long)rt.hist[3], (unsigned long)rt.hist[4], (unsigned long)rt.hist[5],
+                    (unsigned long)rt.hist[6], (unsigned long)rt.hist[7]);
+    }
+    
+    // Tempo from the trigger clock, when it locks or moves
+    static uint32_t last_clock_gen = 0;
+    if (tc_generation() != last_clock_gen) {
+      last_clock_gen = tc_generation();
+      if (tc_locked()) {
+        Serial.printf("[AE] Clock: %.1f BPM, loop snap %s\n", tc_bpm(), tc_snap_enabled() ? "on" : "off");
+      } else {
+        Serial.println(F("[AE] Clock: stopped"));
+      }
+    }
+    
+    // Slice map of a newly loaded sample, once core 1 has published it
+    static uint32_t last_slice_gen = 0;
+    if (sm_generation() != last_slice_gen) {
+      last_slice_gen = sm_generation();
+      const SliceMap* m = sm_current();
+      if (m) {
+        Serial.printf("[AE] Slices: %lu onsets, slice mode %s\n", (unsigned long)m->count,
+                      sm_slice_mode() ? "on" : "off");
+      }
+    }
+    
+    // Recorder takes and overdub passes as they complete
+    static uint32_t last_rec_count = 0;
+    rec_stats_t rs;
+    rec_get_stats(&rs);
+    if (rs.takes + rs.overdubs + rs.aborted != last_rec_count) {
+      last_rec_count = rs.takes + rs.overdubs + rs.aborted;
+      Serial.printf("[AE] Recorder: %lu takes (last %lu frames), %lu overdubs, %lu aborted, %lu stalls\n",
+                    (unsigned long)rs.takes, (unsigned long)rs.last_frames, (unsigned long)rs.overdubs,
+                    (unsigned long)rs.aborted, (unsigned long)rs.stalls);
+    }
+    
+    // Streamed sample: window moves and blocks the loop went silent waiting for the card
+    static uint32_t last_stream_events = 0;
+    ss_stats_t ss;
+    ss_get_stats(&ss);
+    if (ss.moves + ss.underruns + ss.read_errors != last_stream_events) {
+      last_stream_events = ss.moves + ss.underruns + ss.read_errors;
+      Serial.printf("[AE] Stream: %lu loads, %lu window moves, %lu underruns, %lu skips, %lu read errors\n",
+                    (unsigned long)ss.loads, (unsigned long)ss.moves, (unsigned long)ss.underruns,
+                    (unsigned long)ss.skips, (unsigned long)ss.read_errors);
+    }
+    
+    // Saturation curve and oversampling after a serial change
+    static const char* const curve_names[WS_CURVE_COUNT] = {"tanh", "tube", "fold"};
+    static uint8_t last_ws = 0xFF;
+    const uint8_t ws_now = (uint8_t)((ws_curve() << 1) | (ws_oversample() ? 1u : 0u));
+    if (ws_now != last_ws) {
+      last_ws = ws_now;
+      Serial.printf("[AE] Saturation: %s curve, %s\n", curve_names[ws_curve()], ws_oversample() ? "2x" : "1x");
+    }
+    
+    // Delay on/off and sync after a serial change
+    static uint8_t last_dly = 0xFF;
+    const uint8_t dly_now = (uint8_t)((dly_enabled() ? 2u : 0u) | (dly_sync() ? 1u : 0u));
+    if (dly_now != last_dly) {
+      last_dly = dly_now;
+      dly_stats_t ds;
+      dly_get_stats(&ds);
+      Serial.printf("[AE] Delay: %s, %lu ms, tempo sync %s, %lu stalls\n", dly_enabled() ? "on" : "off",
+                    (unsigned long)dly_time_ms(), dly_sync() ? "on" : "off", (unsigned long)ds.stalls);
+    }
+    
+    // Granular mode after a serial change
+    static int8_t last_gr = -1;
+    if ((int8_t)gr_enabled() != last_gr) {
+      last_gr = (int8_t)gr_enabled();
+      gr_stats_t gs;
+      gr_get_stats(&gs);
+      Serial.printf("[AE] Granular: %s, %lu grains dropped\n", gr_enabled() ? "on" : "off",
+                    (unsigned long)gs.dropped);
+    }
+  }
+  
   // if (millis() - last >= 250) {
   //   last += 250;
   //   Serial.print('.');
@@ -298,6 +433,7 @@ void loop() {
  * - Scans SD card for WAV files and enters browser mode
  * - Updates input handling (encoders, buttons, switches)
  * - Refreshes display at ~60Hz
+ * - Advances the onset scan of a freshly loaded sample (slice_map.h)
  * 
  * The two-phase approach (boot wait + main loop) ensures proper
  * initialization order between the cores.
@@ -330,4 +466,12 @@ void loop1() {
   // Phase 2: Main UI loop - update inputs and display
   ui_input_update();  // Process encoders, buttons, rotary switch
   display_tick();     // Update display at ~60Hz
+  sm_poll();          // Onset scan, SM_POLL_FRAMES per pass until the slice map is out
+  ss_poll();          // Streamed sample: one chunk around the playhead per pass
+  if (rec_poll()) {   // A finished take is now the loaded sample - play it
+    audio_engine_arm(true);
+    audio_engine_play(true);
+  }
+  serial_commands_poll(); // Single-key commands over serial (serial_commands.h)
+  prof_serial_poll();     // Profiler dump, once 'p' asks for one
 }
\ No newline at end of file
@@ -0,0 +1,86 @@
+/**
+ * @file psram_copy.cpp
+ * @brief Run-list DMA programming
+ *
+ * @author Brian Varren
+ * @version 1.0
+ * @date 2025
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <hardware/sync.h>
+#include "psram_copy.h"
+#ifdef ARDUINO_ARCH_RP2040
+#include <hardware/dma.h>
+#endif
+
+void pc_init(PsramCopy* c) {
+  c->run_count = 0;
+#ifdef ARDUINO_ARCH_RP2040
+  c->dma_data = dma_claim_unused_channel(true);
+  c->dma_ctrl = dma_claim_unused_channel(true);
+
+  dma_channel_config cfg = dma_channel_get_default_config((uint)c->dma_data);
+  channel_config_set_transfer_data_size(&cfg, DMA_SIZE_16);
+  channel_config_set_read_increment(&cfg, true);
+  channel_config_set_write_increment(&cfg, true);
+  channel_config_set_chain_to(&cfg, (uint)c->dma_data);         // Chaining to itself = none
+  c->ctrl_stop = channel_config_get_ctrl_value(&cfg);
+  channel_config_set_chain_to(&cfg, (uint)c->dma_ctrl);
+  c->ctrl_chain = channel_config_get_ctrl_value(&cfg);
+  dma_channel_set_config((uint)c->dma_data, &cfg, false);
+
+  dma_channel_config ctl = dma_channel_get_default_config((uint)c->dma_ctrl);
+  channel_config_set_transfer_data_size(&ctl, DMA_SIZE_32);
+  channel_config_set_read_increment(&ctl, true);
+  channel_config_set_write_increment(&ctl, true);
+  channel_config_set_ring(&ctl, true, 4);                       // Writes wrap over the 4 alias-1 registers
+  dma_channel_configure((uint)c->dma_ctrl, &ctl, &dma_hw->ch[c->dma_data].al1_ctrl, c->runs, 4, false);
+#else
+  c->dma_data = -1;
+  c->dma_ctrl = -1;
+  c->ctrl_stop = 0;
+  c->ctrl_chain = 0;
+#endif
+}
+
+void pc_add(PsramCopy* c, const int16_t* src, int16_t* dst, uint32_t n) {
+  if (n == 0) return;
+  PcRun& r = c->runs[c->run_count++];
+  r.read = (uintptr_t)src;
+  r.write = (uintptr_t)dst;
+  r.count = n;
+}
+
+void pc_start(PsramCopy* c) {
+  const uint32_t count = c->run_count;
+  if (count == 0) return;
+#ifdef ARDUINO_ARCH_RP2040
+  for (uint32_t j = 0; j < count; ++j) {
+    c->runs[j].ctrl = (j + 1u < count) ? c->ctrl_chain : c->ctrl_stop;
+  }
+  __compiler_memory_barrier();  // List before the control channel reads it
+  dma_channel_set_read_addr((uint)c->dma_ctrl, c->runs, true);
+#else
+  for (uint32_t j = 0; j < count; ++j) {
+    memcpy((void*)c->runs[j].write, (const void*)c->runs[j].read, c->runs[j].count * sizeof(int16_t));
+  }
+#endif
+  c->run_count = 0;
+}
+
+bool pc_busy(const PsramCopy* c) {
+#ifdef ARDUINO_ARCH_RP2040
+  return dma_channel_is_busy((uint)c->dma_data) || dma_channel_is_busy((uint)c->dma_ctrl);
+#else
+  (void)c;
+  return false;
+#endif
+}
+
+bool pc_wait(const PsramCopy* c) {
+  if (!pc_busy(c)) return false;
+  while (pc_busy(c)) {}
+  return true;
+}
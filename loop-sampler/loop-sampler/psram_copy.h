@@ -0,0 +1,71 @@
+/**
+ * @file psram_copy.h
+ * @brief Chained DMA copies between SRAM and PSRAM, off the render
+ *
+ * The recorder and the delay both move a block to or from PSRAM every
+ * render as a short list of runs (a staged block, a window split at a ring
+ * end). A PsramCopy owns two DMA channels. The control channel loads each
+ * run into the data channel's alias-1 registers (CTRL, READ, WRITE,
+ * COUNT_TRIG), which starts it. Every run but the last chains back to the
+ * control channel for the next one, so a list runs to the end without the
+ * core.
+ *
+ * Runs copy 16-bit values. The host build copies synchronously in
+ * pc_start() and claims no channels.
+ *
+ * @author Brian Varren
+ * @version 1.0
+ * @date 2025
+ */
+
+#pragma once
+#include <stdint.h>
+
+#define PC_MAX_RUNS  6u                // Longest list (the delay's, stereo_delay.cpp)
+
+struct PcRun {
+  uint32_t  ctrl;                      // Data channel CTRL: stop, or chain to the control channel
+  uintptr_t read;
+  uintptr_t write;
+  uint32_t  count;                     // 16-bit values
+};
+
+struct PsramCopy {
+  PcRun    runs[PC_MAX_RUNS] __attribute__((aligned(16)));   // Control channel reads wrap on 16 bytes
+  uint32_t run_count;                  // Runs added since the last start
+  int      dma_data;
+  int      dma_ctrl;
+  uint32_t ctrl_stop;                  // Data channel CTRL: stop when done
+  uint32_t ctrl_chain;                 // Data channel CTRL: then start the control channel
+};
+
+/**
+ * @brief Claim and configure the two channels (from audio_init(), once per engine)
+ */
+void pc_init(PsramCopy* c);
+
+/**
+ * @brief Queue n values from src to dst (render); an empty run is skipped
+ */
+void pc_add(PsramCopy* c, const int16_t* src, int16_t* dst, uint32_t n);
+
+/**
+ * @brief Start the queued runs, in order, and clear the list
+ */
+void pc_start(PsramCopy* c);
+
+/**
+ * @brief True while runs of the last pc_start() are still moving
+ */
+bool pc_busy(const PsramCopy* c);
+
+/**
+ * @brief Spin until the last list has landed
+ *
+ * A list holds about one block of samples per run, and it was started a
+ * whole block ago. By the time the render needs it again it is
+ * done or close to it, so waiting costs less than skipping the block.
+ *
+ * @return true when there was something to wait for (a stall)
+ */
+bool pc_wait(const PsramCopy* c);
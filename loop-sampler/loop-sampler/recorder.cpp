@@ -0,0 +1,253 @@
+/**
+ * @file recorder.cpp
+ * @brief Take / overdub state machine and input staging
+ *
+ * @author Brian Varren
+ * @version 1.0
+ * @date 2025
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <hardware/sync.h>
+#include <Arduino.h>   // pmalloc()
+#include "DACless.h"
+#include "audio_engine.h"
+#include "recorder.h"
+#include "storage_loader.h"
+#include "psram_copy.h"
+
+#define REC_MAX_CHANNELS  2u
+
+// ── State ───────────────────────────────────────────────────────────────────
+// Requests are posted by core 1 and taken by the render. Everything below
+// them belongs to the render until it sets REC_DONE, then to rec_poll()
+// until it goes back to REC_IDLE.
+static volatile uint8_t s_state = REC_IDLE;
+static volatile bool s_req_take = false;
+static volatile bool s_req_overdub = false;
+static volatile bool s_req_stop = false;
+static int16_t* s_take_buf = nullptr;          // Allocated by rec_start()
+static uint32_t s_take_max = 0;
+
+struct RecJob {
+  bool     take;                               // New take (else overdub)
+  int16_t* dst;                                // Buffer written
+  uint8_t  channels;
+  uint32_t lo, hi;                             // Region, frames [lo, hi)
+  uint32_t pos;                                // Next frame written
+  uint32_t remaining;                          // Frames left to write
+  uint32_t written;
+};
+static RecJob s_job;
+
+static int16_t s_stage[REC_STAGE_BLOCKS][AUDIO_BLOCK_SIZE * REC_MAX_CHANNELS] __attribute__((aligned(4)));
+static uint32_t s_stage_slot = 0;
+
+static rec_stats_t s_stats;
+static PsramCopy s_copy;                       // Staged block to the take: one run, two at the region end
+
+void rec_init(void) {
+  pc_init(&s_copy);
+  memset(&s_stats, 0, sizeof(s_stats));
+}
+
+// ── Control (core 1) ────────────────────────────────────────────────────────
+
+static uint32_t rec_min_frames(void) {
+  return (uint32_t)(audio_rate * (REC_MIN_MS / 1000.0f));
+}
+
+bool rec_start(uint32_t max_frames) {
+  if (s_state != REC_IDLE || s_req_take || s_req_overdub) return false;
+  uint32_t frames = max_frames ? max_frames : (uint32_t)(audio_rate * REC_MAX_SECONDS);
+#ifdef ARDUINO_ARCH_RP2040
+  const uint32_t room = rp2040.getFreePSRAMHeap() / sizeof(int16_t);
+  if (frames > room) frames = room;
+  if (frames < rec_min_frames()) return false;
+  int16_t* buf = (int16_t*)pmalloc(frames * sizeof(int16_t));
+#else
+  if (frames < rec_min_frames()) return false;
+  int16_t* buf = (int16_t*)malloc(frames * sizeof(int16_t));
+#endif
+  if (!buf) return false;
+  s_take_buf = buf;
+  s_take_max = frames;
+  __compiler_memory_barrier();  // Buffer before request
+  s_req_take = true;
+  return true;
+}
+
+void rec_stop(void) {
+  s_req_stop = true;
+}
+
+bool rec_overdub(void) {
+  if (s_state != REC_IDLE || s_req_take || s_req_overdub) return false;
+  s_req_overdub = true;
+  return true;
+}
+
+void rec_serial_command(char c) {
+  if (c == 'R') {
+    if (s_state == REC_RECORDING) rec_stop();
+    else rec_start();
+  } else if (c == 'O') {
+    if (s_state == REC_OVERDUB) rec_stop();
+    else rec_overdub();
+  }
+}
+
+bool rec_poll(void) {
+  if (s_state != REC_DONE) return false;
+  bool published = false;
+  if (s_job.take) {
+    if (s_job.written >= rec_min_frames()) {
+      published = sf::storage_adopt_sample_q15_psram(s_job.dst, s_job.written, 1u, (uint32_t)audio_rate);
+    }
+    if (published) {
+      g_reset_trigger_pending = true;  // Start the take from its first frame
+      s_stats.takes++;
+      s_stats.last_frames = s_job.written;
+    } else {
+      free(s_job.dst);
+    }
+    s_take_buf = nullptr;
+  } else {
+    sf::storage_refresh_sample_q15_psram();
+  }
+  __compiler_memory_barrier();
+  s_state = REC_IDLE;
+  return published;
+}
+
+// ── Render (core 0) ─────────────────────────────────────────────────────────
+
+static void rec_begin_take(void) {
+  RecJob& j = s_job;
+  j.take = true;
+  j.dst = s_take_buf;
+  j.channels = 1;
+  j.lo = 0;
+  j.hi = s_take_max;
+  j.pos = 0;
+  j.remaining = s_take_max;
+  j.written = 0;
+  s_state = REC_RECORDING;
+}
+
+// One pass of the primary's loop, starting where the input being captured
+// now was heard
+static bool rec_begin_overdub(const RecBlock* b) {
+  if (!b->samples || !b->unity || b->loop_end <= b->loop_start || b->loop_end > b->total_samples) return false;
+  RecJob& j = s_job;
+  const uint32_t len = b->loop_end - b->loop_start;
+  const uint32_t lat = REC_LATENCY_FRAMES % len;
+  uint32_t off = (b->play_pos >= b->loop_start && b->play_pos < b->loop_end) ? b->play_pos - b->loop_start : 0u;
+  off = (off >= lat) ? off - lat : off + len - lat;
+  j.take = false;
+  j.dst = (int16_t*)b->samples;
+  j.channels = (b->channels == 2) ? 2u : 1u;
+  j.lo = b->loop_start;
+  j.hi = b->loop_end;
+  j.pos = b->loop_start + off;
+  j.remaining = len;
+  j.written = 0;
+  s_state = REC_OVERDUB;
+  return true;
+}
+
+static inline int16_t rec_sat16(int32_t x) {
+  return (int16_t)((x > 32767) ? 32767 : (x < -32768) ? -32768 : x);
+}
+
+static inline int16_t rec_input_q15(const RecBlock* b, uint32_t i) {
+  const uint16_t raw = b->input ? b->input[i] : b->input_hold;
+  return (int16_t)(((int32_t)(raw & 0x0FFFu) - 2048) * 16);
+}
+
+// Stage n frames from the current position and hand them to the DMA
+static void rec_write_block(const RecBlock* b, uint32_t n) {
+  RecJob& j = s_job;
+  if (pc_wait(&s_copy)) s_stats.stalls++;
+  int16_t* st = s_stage[s_stage_slot];
+  s_stage_slot = (s_stage_slot + 1u) % REC_STAGE_BLOCKS;
+
+  const uint32_t ch = j.channels;
+  if (j.take) {
+    for (uint32_t i = 0; i < n; ++i) st[i] = rec_input_q15(b, i);
+  } else {
+    // Old loop (kept at REC_OVERDUB_KEEP_Q15) plus the input on every channel
+    uint32_t p = j.pos;
+    for (uint32_t i = 0; i < n; ++i) {
+      const int32_t in = rec_input_q15(b, i);
+      for (uint32_t c = 0; c < ch; ++c) {
+        const int32_t old = ((int32_t)b->samples[p * ch + c] * REC_OVERDUB_KEEP_Q15) >> 15;
+        st[i * ch + c] = rec_sat16(old + in);
+      }
+      if (++p == j.hi) p = j.lo;
+    }
+  }
+
+  const uint32_t first = (j.hi - j.pos < n) ? j.hi - j.pos : n;
+  pc_add(&s_copy, st, j.dst + j.pos * ch, first * ch);
+  pc_add(&s_copy, st + first * ch, j.dst + j.lo * ch, (n - first) * ch);
+  pc_start(&s_copy);
+  j.pos += n;
+  if (j.pos >= j.hi) j.pos -= j.hi - j.lo;
+  j.remaining -= n;
+  j.written += n;
+}
+
+void rec_render_block(const RecBlock* b) {
+  if (s_state == REC_DONE) return;  // rec_poll() has it
+
+  if (s_state == REC_IDLE) {
+    if (s_req_take) {
+      s_req_take = false;
+      rec_begin_take();
+    } else if (s_req_overdub) {
+      s_req_overdub = false;
+      if (!rec_begin_overdub(b)) s_stats.aborted++;
+    }
+  }
+
+  // An overdub pass only lines up with the loop while it plays unchanged
+  if (s_state == REC_OVERDUB &&
+      (b->samples != s_job.dst || !b->unity || b->loop_start != s_job.lo || b->loop_end != s_job.hi)) {
+    s_stats.aborted++;
+    s_state = REC_FINISHING;
+  }
+  if (s_req_stop) {
+    s_req_stop = false;
+    if (s_state == REC_RECORDING || s_state == REC_OVERDUB) s_state = REC_FINISHING;
+  }
+
+  if (s_state == REC_RECORDING || s_state == REC_OVERDUB) {
+    const uint32_t n = (s_job.remaining < AUDIO_BLOCK_SIZE) ? s_job.remaining : AUDIO_BLOCK_SIZE;
+    if (n) rec_write_block(b, n);
+    if (!s_job.remaining) {
+      if (s_state == REC_OVERDUB) s_stats.overdubs++;
+      s_state = REC_FINISHING;
+    }
+  }
+
+  // Last copy landed: hand over to rec_poll()
+  if (s_state == REC_FINISHING && !pc_busy(&s_copy)) {
+    __compiler_memory_barrier();
+    s_state = (s_job.take || s_job.written) ? REC_DONE : REC_IDLE;
+  }
+}
+
+bool rec_active(void) {
+  return s_req_take || s_req_overdub || (s_state != REC_IDLE && s_state != REC_DONE);
+}
+
+// ── Readout ─────────────────────────────────────────────────────────────────
+rec_state_t rec_state(void) {
+  return (rec_state_t)s_state;
+}
+
+void rec_get_stats(rec_stats_t* out) {
+  *out = s_stats;
+}
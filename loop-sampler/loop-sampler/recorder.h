@@ -0,0 +1,145 @@
+/**
+ * @file recorder.h
+ * @brief Live recording of the audio input into PSRAM, and loop overdub
+ *
+ * The recorder takes one ADC input (REC_INPUT_CH, the PM jack by default)
+ * at the output rate from the ADC capture ring. It does one of two things
+ * with it.
+ *
+ * - **Take**: rec_start() records a new sample of up to REC_MAX_SECONDS
+ *   into a fresh PSRAM buffer. When the take ends, rec_poll() hands it to
+ *   the loader path (storage_adopt_sample_q15_psram()). From there it plays
+ *   like a loaded file, with mip levels, zero crossings and a slice map.
+ * - **Overdub**: rec_overdub() mixes the input into the loop being played,
+ *   for one pass of it from the playhead on. The existing material is kept
+ *   at REC_OVERDUB_KEEP_Q15, and the sum saturates.
+ *
+ * ## Data Path
+ *
+ * The ADC fills one FIFO with all eight channels round robin, so DMA cannot
+ * pick a single input out of it. Once per block the renderer converts the
+ * input block to Q15 (mixing in the old loop when overdubbing) and writes it
+ * to an SRAM staging ring of REC_STAGE_BLOCKS blocks. The recorder's own
+ * pair of DMA channels (psram_copy.h) then move the block to PSRAM; the CPU
+ * never stores to PSRAM. A block that runs past the end of the region (the
+ * loop end, when overdubbing) is split into two runs, the second at the
+ * region start. The output PWM channels are not touched, and their DMA IRQs
+ * keep the highest priority.
+ *
+ * Input and loop are aligned for the latency of the path. The overdub
+ * writes REC_LATENCY_FRAMES behind the playhead: the output ring plays that
+ * far behind the render, and the capture reader trails the ADC.
+ *
+ * ## Threading
+ *
+ * rec_start(), rec_stop() and rec_overdub() post requests from core 1 (UI or
+ * serial). The render IRQ owns the state machine and the DMA channels. When
+ * a take or pass ends, the render waits for the last copy to land, then
+ * flags core 1. rec_poll() in loop1() rebuilds what is derived from the
+ * buffer, the SRAM loop copies (sample_cache, seam_cache) included, with the
+ * engine unbound. Overdub needs forward playback at one frame per output sample (no
+ * FM). A pass that loses that, or whose loop moves, ends early.
+ *
+ * @author Brian Varren
+ * @version 1.0
+ * @date 2025
+ */
+
+#pragma once
+#include <stdint.h>
+
+// ── Configuration ───────────────────────────────────────────────────────────
+#ifndef REC_INPUT_CH
+#define REC_INPUT_CH          3u       // ADC input recorded (ADC_PM_CH, the audio-rate one)
+#endif
+#define REC_MAX_SECONDS       30u      // Longest take
+#define REC_MIN_MS            100u     // Shorter takes are dropped
+#define REC_STAGE_BLOCKS      8u       // SRAM staging ring, in blocks
+#define REC_OVERDUB_KEEP_Q15  32767    // Gain on the existing loop per overdub pass
+#define REC_UNITY_TOLERANCE   ((int64_t)1 << 25)  // Increment error allowed when overdubbing (1/128)
+
+// Frames the overdub writes behind the playhead: the output ring plays
+// AUDIO_BUFFER_DEPTH - 1 blocks after the render, and the capture reader
+// trails the ADC by two blocks
+#define REC_LATENCY_FRAMES    ((AUDIO_BUFFER_DEPTH + 1u) * AUDIO_BLOCK_SIZE)
+
+enum rec_state_t : uint8_t {
+  REC_IDLE = 0,
+  REC_RECORDING,     // Writing a new take
+  REC_OVERDUB,       // Mixing into the playing loop
+  REC_FINISHING,     // Waiting for the last copy to land
+  REC_DONE           // Waiting for rec_poll()
+};
+
+// What the renderer knows about the block (samples = nullptr when stopped)
+struct RecBlock {
+  const uint16_t* input;      // AUDIO_BLOCK_SIZE 12-bit samples of REC_INPUT_CH, or nullptr
+  uint16_t input_hold;        // Latest conversion, used when input is nullptr
+  const int16_t* samples;     // Buffer playing
+  uint32_t total_samples;     // Its frames
+  uint8_t  channels;
+  uint32_t play_pos;          // Primary voice's frame at the first sample
+  uint32_t loop_start, loop_end;
+  bool     unity;             // Forward, one frame per output sample, no FM
+};
+
+struct rec_stats_t {
+  uint32_t takes;             // Takes published
+  uint32_t overdubs;          // Overdub passes completed
+  uint32_t aborted;           // Passes ended early (pitch, direction or loop changed)
+  uint32_t last_frames;       // Length of the last take
+  uint32_t stalls;            // Blocks that found the previous copy still running
+};
+
+// ── Control (core 1) ────────────────────────────────────────────────────────
+
+/**
+ * @brief Claim the DMA channels; called once from audio_init()
+ */
+void rec_init(void);
+
+/**
+ * @brief Start a new take
+ * @param max_frames Length limit (0 = REC_MAX_SECONDS, and no more than
+ *                   the free PSRAM)
+ * @return false when busy or out of PSRAM
+ */
+bool rec_start(uint32_t max_frames = 0);
+
+/**
+ * @brief End the take, or the overdub pass, at the next block
+ */
+void rec_stop(void);
+
+/**
+ * @brief Overdub one pass of the playing loop
+ * @return false when busy or nothing is playing
+ */
+bool rec_overdub(void);
+
+/**
+ * @brief Serial keys: 'R' starts / stops a take, 'O' starts an overdub pass
+ */
+void rec_serial_command(char c);
+
+/**
+ * @brief Publish a finished take, or refresh the buffer after an overdub
+ * @return true when a new take became the playing sample
+ */
+bool rec_poll(void);
+
+// ── Render (core 0) ─────────────────────────────────────────────────────────
+
+/**
+ * @brief Record or overdub one block; called once per block by the renderer
+ */
+void rec_render_block(const RecBlock* b);
+
+/**
+ * @brief True when the renderer must feed rec_render_block() while stopped
+ */
+bool rec_active(void);
+
+// ── Readout (any core) ──────────────────────────────────────────────────────
+rec_state_t rec_state(void);
+void rec_get_stats(rec_stats_t* out);
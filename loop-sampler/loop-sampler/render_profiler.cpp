@@ -0,0 +1,246 @@
+/**
+ * @file render_profiler.cpp
+ * @brief Render stage statistics, snapshot publishing and report lines
+ *
+ * @author Brian Varren
+ * @version 1.0
+ * @date 2025
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "render_profiler.h"
+#ifdef ARDUINO
+#include <Arduino.h>
+#include "hardware/clocks.h"
+#endif
+
+static const char* const s_stage_names[PROF_STAGES] = {
+  "params", "voice", "xfade", "sat", "filter", "pwm"
+};
+
+// ── Writer State (core 0) ───────────────────────────────────────────────────
+struct ProfAccum {
+  uint32_t min, max;
+  uint64_t sum;
+};
+
+#if AE_PROFILE
+uint32_t g_prof_block[PROF_STAGES];
+uint32_t g_prof_last = 0;
+uint32_t g_prof_nested = 0;
+#endif
+bool g_prof_use_dwt = false;
+
+static ProfAccum s_stage[PROF_STAGES];
+static ProfAccum s_total;
+static uint32_t s_hist[PROF_HIST_BINS];
+static uint32_t s_blocks = 0;
+static uint32_t s_overruns = 0;
+static uint32_t s_deadline_ticks = 1;
+static uint32_t s_tick_hz = 1000000u;
+static volatile bool s_reset_request = true;
+
+// ── Published Snapshot (seqlock, like the display bridge) ───────────────────
+static ProfSnapshot s_snap;
+static volatile uint32_t s_snap_seq = 0;
+
+static void prof_accum_clear(ProfAccum* a) {
+  a->min = 0xFFFFFFFFu;
+  a->max = 0;
+  a->sum = 0;
+}
+
+static inline void prof_accum_add(ProfAccum* a, uint32_t ticks) {
+  if (ticks < a->min) a->min = ticks;
+  if (ticks > a->max) a->max = ticks;
+  a->sum += ticks;
+}
+
+static ProfStat prof_accum_stat(const ProfAccum* a, uint32_t blocks) {
+  ProfStat s;
+  s.min = blocks ? a->min : 0u;
+  s.avg = blocks ? (uint32_t)(a->sum / blocks) : 0u;
+  s.max = a->max;
+  return s;
+}
+
+static void prof_clear(void) {
+  for (uint32_t s = 0; s < PROF_STAGES; ++s) prof_accum_clear(&s_stage[s]);
+  prof_accum_clear(&s_total);
+  memset(s_hist, 0, sizeof(s_hist));
+  s_blocks = 0;
+  s_overruns = 0;
+}
+
+static void prof_publish(void) {
+  s_snap_seq++;                       // Odd: writing
+  __asm__ volatile ("" : : : "memory");
+  for (uint32_t s = 0; s < PROF_STAGES; ++s) s_snap.stage[s] = prof_accum_stat(&s_stage[s], s_blocks);
+  s_snap.total = prof_accum_stat(&s_total, s_blocks);
+  memcpy(s_snap.hist, s_hist, sizeof(s_hist));
+  s_snap.blocks = s_blocks;
+  s_snap.overruns = s_overruns;
+  s_snap.deadline_ticks = s_deadline_ticks;
+  s_snap.tick_hz = s_tick_hz;
+  __asm__ volatile ("" : : : "memory");
+  s_snap_seq++;                       // Even: stable
+}
+
+#if AE_PROFILE
+void prof_block_end(void) {
+  if (s_reset_request) {
+    s_reset_request = false;
+    prof_clear();
+  }
+
+  uint32_t total = 0;
+  for (uint32_t s = 0; s < PROF_STAGES; ++s) {
+    prof_accum_add(&s_stage[s], g_prof_block[s]);
+    total += g_prof_block[s];
+  }
+  prof_accum_add(&s_total, total);
+
+  // 8 bins up to the deadline, the last one collects overruns
+  uint32_t bin = (uint32_t)(((uint64_t)total * (PROF_HIST_BINS - 1)) / s_deadline_ticks);
+  if (bin >= PROF_HIST_BINS - 1) {
+    bin = PROF_HIST_BINS - 1;
+    if (total > s_deadline_ticks) s_overruns++;
+  }
+  s_hist[bin]++;
+
+  if ((++s_blocks % PROF_PUBLISH_BLOCKS) == 0) prof_publish();
+}
+#endif
+
+// ── Setup / Readout ─────────────────────────────────────────────────────────
+
+void prof_init(float block_deadline_us) {
+#if defined(ARDUINO) && defined(PROF_DWT_CYCCNT)
+  // Enable the DWT cycle counter (DEMCR.TRCENA, DWT_CTRL.CYCCNTENA) unless
+  // the implementation reports it missing (DWT_CTRL.NOCYCCNT)
+  volatile uint32_t* const demcr = (volatile uint32_t*)0xE000EDFCu;
+  volatile uint32_t* const dwt_ctrl = (volatile uint32_t*)0xE0001000u;
+  *demcr |= (1u << 24);
+  g_prof_use_dwt = (*dwt_ctrl & (1u << 25)) == 0;
+  if (g_prof_use_dwt) {
+    PROF_DWT_CYCCNT = 0;
+    *dwt_ctrl |= 1u;
+  }
+#endif
+#if defined(ARDUINO)
+  s_tick_hz = g_prof_use_dwt ? clock_get_hz(clk_sys) : 1000000u;
+#else
+  s_tick_hz = 1000000000u;
+#endif
+  const float ticks = block_deadline_us * ((float)s_tick_hz / 1e6f);
+  s_deadline_ticks = (ticks < 1.0f) ? 1u : (uint32_t)ticks;
+  prof_clear();
+  s_reset_request = false;
+  prof_publish();
+}
+
+void prof_request_reset(void) {
+  s_reset_request = true;
+}
+
+void prof_get_snapshot(ProfSnapshot* out) {
+  for (;;) {
+    const uint32_t s0 = s_snap_seq;
+    if (s0 & 1u) continue;
+    __asm__ volatile ("" : : : "memory");
+    memcpy(out, &s_snap, sizeof(*out));
+    __asm__ volatile ("" : : : "memory");
+    if (s_snap_seq == s0) return;
+  }
+}
+
+// Ticks to tenths of a microsecond
+static uint32_t prof_tenths_us(const ProfSnapshot* snap, uint32_t ticks) {
+  return (uint32_t)(((uint64_t)ticks * 10u) / (snap->tick_hz / 1000000u ? snap->tick_hz / 1000000u : 1u));
+}
+
+static int prof_format_stat(char* buf, size_t n, const char* name, const ProfSnapshot* snap, const ProfStat* s) {
+  const uint32_t mn = prof_tenths_us(snap, s->min);
+  const uint32_t av = prof_tenths_us(snap, s->avg);
+  const uint32_t mx = prof_tenths_us(snap, s->max);
+  return snprintf(buf, n, "%-6s %4u.%u %4u.%u %4u.%u", name,
+                  (unsigned)(mn / 10), (unsigned)(mn % 10), (unsigned)(av / 10), (unsigned)(av % 10),
+                  (unsigned)(mx / 10), (unsigned)(mx % 10));
+}
+
+bool prof_format_line(const ProfSnapshot* snap, uint32_t line, char* buf, size_t n) {
+  const uint32_t deadline = snap->deadline_ticks ? snap->deadline_ticks : 1u;
+  if (line == 0) {
+    snprintf(buf, n, "us        min    avg    max");
+  } else if (line < PROF_PAGE_LINES) {
+    prof_format_stat(buf, n, s_stage_names[line - 1], snap, &snap->stage[line - 1]);
+  } else if (line == PROF_PAGE_LINES) {
+    prof_format_stat(buf, n, "total", snap, &snap->total);
+  } else if (line == PROF_PAGE_LINES + 1) {
+    snprintf(buf, n, "load avg %u%% max %u%% over %u",
+             (unsigned)(((uint64_t)snap->total.avg * 100u) / deadline),
+             (unsigned)(((uint64_t)snap->total.max * 100u) / deadline), (unsigned)snap->overruns);
+  } else if (line == PROF_PAGE_LINES + 2) {
+    // One character per bin: share of blocks in tenths ('.' = none, '+' = under 10%)
+    char bars[PROF_HIST_BINS + 2];
+    uint32_t j = 0;
+    for (uint32_t b = 0; b < PROF_HIST_BINS; ++b) {
+      if (b == PROF_HIST_BINS - 1) bars[j++] = '|';
+      const uint32_t tenths = snap->blocks ? (uint32_t)(((uint64_t)snap->hist[b] * 10u) / snap->blocks) : 0u;
+      bars[j++] = (snap->hist[b] == 0) ? '.' : (tenths == 0) ? '+' : (tenths >= 10) ? '#' : (char)('0' + tenths);
+    }
+    bars[j] = '\0';
+    snprintf(buf, n, "hist 0..100%% %s", bars);
+  } else if (line == PROF_PAGE_LINES + 3) {
+    snprintf(buf, n, "blocks %u  deadline %u.%u us", (unsigned)snap->blocks,
+             (unsigned)(prof_tenths_us(snap, deadline) / 10), (unsigned)(prof_tenths_us(snap, deadline) % 10));
+  } else if (line == PROF_PAGE_LINES + 4) {
+    int len = snprintf(buf, n, "bins");
+    for (uint32_t b = 0; b < PROF_HIST_BINS && len > 0 && (size_t)len < n; ++b) {
+      len += snprintf(buf + len, n - (size_t)len, " %u", (unsigned)snap->hist[b]);
+    }
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// ── Serial Dump ─────────────────────────────────────────────────────────────
+static int32_t s_line = -1;            // Next dump line to write (-1 = idle)
+
+void prof_serial_command(char c) {
+  if (c == 'r') prof_request_reset();
+  if (c == 'p' && s_line < 0) s_line = 0;
+}
+
+void prof_serial_poll(void) {
+#ifdef ARDUINO
+  static ProfSnapshot s_dump;
+  static uint32_t s_last_ms = 0;
+  static char s_buf[64];
+  static size_t s_len = 0;             // Pending bytes in s_buf
+
+  if (PROF_SERIAL_PERIOD_MS && s_line < 0 && (millis() - s_last_ms) >= PROF_SERIAL_PERIOD_MS) s_line = 0;
+
+  if (s_line == 0 && s_len == 0) {
+    prof_get_snapshot(&s_dump);
+    s_last_ms = millis();
+  }
+  while (s_line >= 0) {
+    if (s_len == 0) {
+      if (!prof_format_line(&s_dump, (uint32_t)s_line, s_buf, sizeof(s_buf) - 2)) {
+        s_line = -1;
+        return;
+      }
+      s_len = strlen(s_buf);
+      s_buf[s_len++] = '\r';
+      s_buf[s_len++] = '\n';
+    }
+    if ((size_t)Serial.availableForWrite() < s_len) return;  // Try again next poll
+    Serial.write((const uint8_t*)s_buf, s_len);
+    s_len = 0;
+    s_line++;
+  }
+#endif
+}
@@ -0,0 +1,161 @@
+/**
+ * @file render_profiler.h
+ * @brief Per-stage timing of ae_render_block()
+ *
+ * Splits every rendered block into stages and keeps min / avg / max per
+ * stage plus a histogram of the whole block against its deadline
+ * (AUDIO_BLOCK_SIZE / audio_rate). Core 0 updates the counters at the end
+ * of each block and publishes a seqlock snapshot every PROF_PUBLISH_BLOCKS
+ * blocks; the display page and the serial dump only ever read snapshots.
+ *
+ * ## Stages
+ *
+ * | Stage     | Covers                                                       |
+ * |-----------|--------------------------------------------------------------|
+ * | params    | knob reads, pitch, boundaries, cache planning, display state |
+ * | voice     | steady voice kernels, their dispatcher and the grain pool    |
+ * | xfade     | attack / release kernels and seam replay                     |
+ * | sat       | effect prepare, clamp + saturation slot (fx_chain.h)         |
+ * | filter    | ladder lowpass and delay slots                               |
+ * | pwm       | Q15 to PWM conversion into both output buffers               |
+ *
+ * ## Clock
+ *
+ * On RP2350 the Cortex-M33 DWT cycle counter is used (one tick per core
+ * cycle). If the DWT is absent or its counter is not implemented, the
+ * profiler falls back to time_us_32() (1 us ticks). The host build uses
+ * CLOCK_MONOTONIC nanoseconds. Reports are converted to microseconds.
+ *
+ * ## Reporting
+ *
+ * - Display page: `#define PROFILER_PAGE` in ui_display.h (next to ADC_DEBUG)
+ * - Serial: send 'p' to dump, 'r' to reset (serial_commands.h), and call
+ *   prof_serial_poll() from loop1(). Lines are written only while the USB
+ *   CDC buffer has room, so a dump never blocks.
+ *
+ * With AE_PROFILE set to 0 every hook compiles to nothing.
+ *
+ * @author Brian Varren
+ * @version 1.0
+ * @date 2025
+ */
+
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+// ── Configuration ───────────────────────────────────────────────────────────
+#ifndef AE_PROFILE
+#define AE_PROFILE  1
+#endif
+#define PROF_HIST_BINS        9      // 8 x 12.5% of the deadline, then "over deadline"
+#define PROF_PUBLISH_BLOCKS   256u   // Snapshot period (~0.1 s at 16-sample blocks)
+#ifndef PROF_SERIAL_PERIOD_MS
+#define PROF_SERIAL_PERIOD_MS 0u     // Periodic serial dump (0 = only on request)
+#endif
+
+typedef enum {
+  PROF_PARAMS = 0,
+  PROF_VOICE,
+  PROF_XFADE,
+  PROF_SATURATION,
+  PROF_FILTER,
+  PROF_PWM,
+  PROF_STAGES
+} prof_stage_t;
+
+struct ProfStat {
+  uint32_t min;     // Ticks
+  uint32_t avg;
+  uint32_t max;
+};
+
+struct ProfSnapshot {
+  ProfStat stage[PROF_STAGES];
+  ProfStat total;                  // Whole block
+  uint32_t hist[PROF_HIST_BINS];   // Blocks per deadline bin
+  uint32_t blocks;                 // Blocks since the last reset
+  uint32_t overruns;               // Blocks over the deadline
+  uint32_t deadline_ticks;
+  uint32_t tick_hz;
+};
+
+// ── Clock ───────────────────────────────────────────────────────────────────
+#if AE_PROFILE && defined(ARDUINO)
+#include <Arduino.h>
+#if defined(__ARM_ARCH_8M_MAIN__)
+#define PROF_DWT_CYCCNT  (*(volatile uint32_t*)0xE0001004u)
+#endif
+extern bool g_prof_use_dwt;
+static inline uint32_t prof_now(void) {
+#ifdef PROF_DWT_CYCCNT
+  if (g_prof_use_dwt) return PROF_DWT_CYCCNT;
+#endif
+  return time_us_32();
+}
+#elif AE_PROFILE
+#include <time.h>
+static inline uint32_t prof_now(void) {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t)((uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec);
+}
+#else
+static inline uint32_t prof_now(void) { return 0; }
+#endif
+
+// ── Render Hooks (core 0) ───────────────────────────────────────────────────
+#if AE_PROFILE
+extern uint32_t g_prof_block[PROF_STAGES];   // Ticks per stage, current block
+extern uint32_t g_prof_last;                 // Tick of the last mark
+extern uint32_t g_prof_nested;               // Ticks already attributed since the last mark
+
+void prof_block_end(void);
+
+// Start timing a block
+static inline void prof_block_begin(void) {
+  for (uint32_t s = 0; s < PROF_STAGES; ++s) g_prof_block[s] = 0;
+  g_prof_nested = 0;
+  g_prof_last = prof_now();
+}
+
+// Attribute the time since the last mark to `stage` (minus prof_add() time)
+static inline void prof_mark(prof_stage_t stage) {
+  const uint32_t now = prof_now();
+  g_prof_block[stage] += (now - g_prof_last) - g_prof_nested;
+  g_prof_nested = 0;
+  g_prof_last = now;
+}
+
+// Attribute `ticks` measured inside the current interval to `stage`
+static inline void prof_add(prof_stage_t stage, uint32_t ticks) {
+  g_prof_block[stage] += ticks;
+  g_prof_nested += ticks;
+}
+#else
+static inline void prof_block_begin(void) {}
+static inline void prof_mark(prof_stage_t) {}
+static inline void prof_add(prof_stage_t, uint32_t) {}
+static inline void prof_block_end(void) {}
+#endif
+
+// ── Setup / Readout ─────────────────────────────────────────────────────────
+// Start the clock and set the block deadline (from audio_init()).
+void prof_init(float block_deadline_us);
+
+// Ask core 0 to clear the counters at the next block end (any core).
+void prof_request_reset(void);
+
+// Copy the last published snapshot (any core, never blocks the writer).
+void prof_get_snapshot(ProfSnapshot* out);
+
+// Report line `line` of a snapshot into buf. Returns false past the last line.
+// Lines 0..PROF_PAGE_LINES-1 are the stage table; the rest are totals.
+#define PROF_PAGE_LINES  7
+bool prof_format_line(const ProfSnapshot* snap, uint32_t line, char* buf, size_t n);
+
+// Serial keys: 'p' starts a dump, 'r' resets the counters (core 1).
+void prof_serial_command(char c);
+
+// Non-blocking serial dump (device only; call from loop1()).
+void prof_serial_poll(void);
@@ -0,0 +1,128 @@
+/**
+ * @file reset_trigger.cpp
+ * @brief Reset-trigger edge queue, block window mapping and latency stats
+ *
+ * @author Brian Varren
+ * @version 1.0
+ * @date 2025
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <hardware/sync.h>
+#include "DACless.h"
+#include "reset_trigger.h"
+
+// ── Edge Queue (IRQ writes head, render writes tail) ────────────────────────
+static volatile uint32_t s_queue[RT_QUEUE_LEN];
+static volatile uint32_t s_head = 0;
+static volatile uint32_t s_tail = 0;
+static volatile uint32_t s_dropped = 0;
+
+// ── Block Window (core 0) ───────────────────────────────────────────────────
+static uint32_t s_samples_per_us_q16 = 0;  // Output samples per microsecond, Q16
+static uint32_t s_block_us_q16 = 0;        // One block in microseconds, Q16
+static uint32_t s_window_us = 0;           // Start of this block's edge window
+static uint32_t s_nominal_us = 0;          // Edge-to-audio latency when on time
+
+// ── Statistics (seqlock, like the profiler snapshot) ────────────────────────
+static rt_stats_t s_stats;
+static uint64_t s_latency_sum_us = 0;
+static volatile uint32_t s_stats_seq = 0;
+static volatile bool s_reset_request = true;
+
+void rt_record_edge(uint32_t t_us) {
+    const uint32_t head = s_head;
+    if (head - s_tail >= RT_QUEUE_LEN) {
+        s_dropped = s_dropped + 1;
+        return;
+    }
+    s_queue[head & (RT_QUEUE_LEN - 1)] = t_us;
+    __compiler_memory_barrier();  // Slot before head
+    s_head = head + 1;
+}
+
+void rt_init(float sample_rate_hz) {
+    s_samples_per_us_q16 = (uint32_t)(sample_rate_hz * 65536.0f / 1e6f + 0.5f);
+    s_block_us_q16 = (uint32_t)(AUDIO_BLOCK_SIZE * 1e6f * 65536.0f / sample_rate_hz + 0.5f);
+    s_nominal_us = (uint32_t)(((uint64_t)s_block_us_q16 * AUDIO_BUFFER_DEPTH) >> 16);
+}
+
+void rt_begin_block(uint32_t freed_us) {
+    s_window_us = freed_us - (s_block_us_q16 >> 16);
+}
+
+static void rt_record_latency(uint32_t latency_us, uint32_t late_samples) {
+    if (s_reset_request) {
+        memset(&s_stats, 0, sizeof(s_stats));
+        s_stats.min_us = 0xFFFFFFFFu;
+        s_latency_sum_us = 0;
+        s_reset_request = false;
+    }
+    uint32_t bin = 0;
+    while (late_samples && bin < RT_HIST_BINS - 1) {
+        late_samples >>= 1;
+        ++bin;
+    }
+
+    s_stats_seq = s_stats_seq + 1;  // Odd: update in progress
+    __compiler_memory_barrier();
+    s_stats.triggers++;
+    if (bin) s_stats.late++;
+    s_stats.hist[bin]++;
+    if (latency_us < s_stats.min_us) s_stats.min_us = latency_us;
+    if (latency_us > s_stats.max_us) s_stats.max_us = latency_us;
+    s_latency_sum_us += latency_us;
+    s_stats.avg_us = (uint32_t)(s_latency_sum_us / s_stats.triggers);
+    s_stats.nominal_us = s_nominal_us;
+    __compiler_memory_barrier();
+    s_stats_seq = s_stats_seq + 1;
+}
+
+bool rt_take(uint32_t* out_offset, uint32_t* out_edge_us) {
+    const uint32_t tail = s_tail;
+    if (s_head == tail || s_samples_per_us_q16 == 0) return false;
+    __compiler_memory_barrier();  // Head before slot
+    const uint32_t t_us = s_queue[tail & (RT_QUEUE_LEN - 1)];
+
+    // Microseconds into the window; negative means the window was missed
+    const int32_t into_us = (int32_t)(t_us - s_window_us);
+    uint32_t offset = 0;
+    uint32_t late_samples = 0;
+    if (into_us >= 0) {
+        offset = (uint32_t)(((uint64_t)(uint32_t)into_us * s_samples_per_us_q16) >> 16);
+        if (offset >= AUDIO_BLOCK_SIZE) return false;  // Belongs to the next block
+    } else {
+        late_samples = (uint32_t)(((uint64_t)(uint32_t)(-into_us) * s_samples_per_us_q16) >> 16);
+        if (late_samples == 0) late_samples = 1;  // Under a sample late still missed the window
+    }
+    s_tail = tail + 1;
+
+    // The block starts playing DEPTH blocks after its window opened
+    const uint32_t heard_us = s_window_us + s_nominal_us +
+                              (uint32_t)(((uint64_t)offset << 16) / s_samples_per_us_q16);
+    rt_record_latency(heard_us - t_us, late_samples);
+    *out_offset = offset;
+    if (out_edge_us) *out_edge_us = t_us;
+    return true;
+}
+
+void rt_flush(void) {
+    s_tail = s_head;
+}
+
+void rt_get_stats(rt_stats_t* out) {
+    uint32_t seq;
+    do {
+        seq = s_stats_seq;
+        __compiler_memory_barrier();
+        *out = s_stats;
+        __compiler_memory_barrier();
+    } while ((seq & 1u) || seq != s_stats_seq);
+    out->dropped = s_dropped;
+    if (out->triggers == 0) out->min_us = 0;
+}
+
+void rt_reset_stats(void) {
+    s_reset_request = true;
+}
@@ -0,0 +1,99 @@
+/**
+ * @file reset_trigger.h
+ * @brief Timestamped reset-trigger queue and sample-offset mapping
+ *
+ * Rising edges on RESET_TRIGGER_PIN are timestamped in a GPIO IRQ
+ * (time_us_32()) and pushed into a small single-producer / single-consumer
+ * queue. The renderer takes at most one trigger per block and starts the new
+ * primary voice on the sample that corresponds to the edge, instead of on
+ * whatever sample the next block happens to begin with.
+ *
+ * ## Timing model
+ *
+ * The buffer being rendered came free at DMA completion time T and starts
+ * playing AUDIO_BUFFER_DEPTH - 1 blocks later. Edges between T - block and T
+ * map linearly onto its samples, so every edge is heard a constant
+ * AUDIO_BUFFER_DEPTH blocks after it arrived (to within one sample):
+ *
+ *   offset = (t_edge - (T - block)) * audio_rate / 1e6
+ *
+ * An edge that lands after T (while the block is rendering) stays queued for
+ * the next block. An edge older than the window (the render fell behind, or
+ * a second edge in one block) starts at sample 0 and is counted as late.
+ *
+ * ## Latency report
+ *
+ * Each taken trigger records edge-to-audio latency, measured from the edge
+ * timestamp and the DMA completion timestamp of its block. rt_get_stats()
+ * gives min / avg / max and a histogram of lateness in samples beyond the
+ * nominal latency: 0, 1, 2-3, 4-7, ... 64+.
+ *
+ * @author Brian Varren
+ * @version 1.0
+ * @date 2025
+ */
+
+#pragma once
+#include <stdint.h>
+
+// ── Configuration ───────────────────────────────────────────────────────────
+#define RT_QUEUE_LEN   16u    // Pending edges (power of two)
+#define RT_HIST_BINS   8u     // Lateness bins: 0, 1, 2-3, 4-7, 8-15, 16-31, 32-63, 64+ samples
+#define RT_IRQ_PRIORITY 0x20  // GPIO bank IRQ: above the render IRQ so edges are stamped on time
+
+static_assert((RT_QUEUE_LEN & (RT_QUEUE_LEN - 1)) == 0, "RT_QUEUE_LEN must be a power of two");
+
+typedef struct {
+  uint32_t triggers;            // Taken by the renderer
+  uint32_t dropped;             // Edges lost to a full queue
+  uint32_t late;                // Started later than the nominal latency (window missed)
+  uint32_t min_us;              // Edge-to-audio latency
+  uint32_t avg_us;
+  uint32_t max_us;
+  uint32_t nominal_us;          // AUDIO_BUFFER_DEPTH blocks
+  uint32_t hist[RT_HIST_BINS];  // Triggers per lateness bin
+} rt_stats_t;
+
+// ── Producer (GPIO IRQ) ─────────────────────────────────────────────────────
+
+/**
+ * @brief Queue a rising edge seen at time_us_32() == t_us
+ *
+ * Safe to call from an IRQ that preempts the renderer on the same core.
+ */
+void rt_record_edge(uint32_t t_us);
+
+// ── Consumer (render, core 0) ───────────────────────────────────────────────
+
+/**
+ * @brief Set the sample rate the offsets are computed for
+ */
+void rt_init(float sample_rate_hz);
+
+/**
+ * @brief Open the edge window for the block about to render
+ *
+ * freed_us is the DMA completion time that freed its buffer; the window is
+ * the block period before it.
+ */
+void rt_begin_block(uint32_t freed_us);
+
+/**
+ * @brief Take the next edge that belongs to this block
+ *
+ * Returns true with the sample offset (0..AUDIO_BLOCK_SIZE-1) at which the
+ * trigger should start, and optionally the edge's timestamp. Edges that
+ * arrived after the window stay queued.
+ */
+bool rt_take(uint32_t* out_offset, uint32_t* out_edge_us = nullptr);
+
+/**
+ * @brief Drop queued edges (nothing is playing, so they cannot be honoured)
+ */
+void rt_flush(void);
+
+/**
+ * @brief Copy the latency statistics (any core)
+ */
+void rt_get_stats(rt_stats_t* out);
+void rt_reset_stats(void);
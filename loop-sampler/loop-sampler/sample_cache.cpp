@@ -0,0 +1,257 @@
+/**
+ * @file sample_cache.cpp
+ * @brief Loop mirror and per-voice prefetch windows (SRAM copies by DMA)
+ *
+ * @author Brian Varren
+ * @version 1.0
+ * @date 2025
+ */
+
+#include <string.h>
+#include "sample_cache.h"
+#ifdef ARDUINO_ARCH_RP2040
+#include <hardware/dma.h>
+#endif
+
+// ── State ───────────────────────────────────────────────────────────────────
+enum : uint8_t {
+  SC_EMPTY = 0,   // Nothing copied
+  SC_QUEUED,      // Waiting for the DMA channel
+  SC_LOADING,     // Copy in flight
+  SC_READY        // Copy landed - safe to read
+};
+
+// A run of level samples [lo, hi) of `src`, copied to `sram`
+struct CacheSeg {
+  const int16_t* src;
+  uint32_t lo, hi;
+  int16_t* sram;
+};
+
+struct CacheWindow {
+  CacheSeg front;     // Read by the kernels (valid when front.src != nullptr)
+  CacheSeg back;      // Being filled for the next blocks
+  uint8_t back_state;
+};
+
+#define SC_WINDOW_COUNT  (VP_MAX_VOICES * SC_LEVELS_PER_VOICE)
+#define SC_NONE          0xFFu
+
+static int16_t s_mirror_buf[SC_MIRROR_BYTES / 2u] __attribute__((aligned(4)));
+static int16_t s_window_buf[SC_WINDOW_COUNT][2][SC_WINDOW_SAMPLES] __attribute__((aligned(4)));
+
+static CacheSeg s_mirror[SC_LEVELS_PER_VOICE];
+static uint8_t s_mirror_segs = 0;
+static uint8_t s_mirror_next = 0;             // Segment being copied
+static uint8_t s_mirror_state = SC_EMPTY;
+
+static CacheWindow s_window[SC_WINDOW_COUNT];
+static uint8_t s_queue[SC_WINDOW_COUNT];      // Windows waiting for the DMA channel
+static uint8_t s_queue_head = 0, s_queue_count = 0;
+static uint8_t s_window_loading = SC_NONE;    // Window whose copy is in flight
+
+static SampleCacheStats s_stats;
+static int s_dma_mirror = -1;
+static int s_dma_window = -1;
+
+// ── Copy Engine ─────────────────────────────────────────────────────────────
+// One DMA channel for the mirror, one shared by the windows. Word transfers
+// when both ends are 4-byte aligned, halfwords otherwise. The host build
+// copies synchronously.
+
+static void sc_copy_start(int chan, int16_t* dst, const int16_t* src, uint32_t count) {
+#ifdef ARDUINO_ARCH_RP2040
+  const bool words = ((((uintptr_t)dst | (uintptr_t)src) & 3u) == 0) && ((count & 1u) == 0);
+  dma_channel_config cfg = dma_channel_get_default_config((uint)chan);
+  channel_config_set_transfer_data_size(&cfg, words ? DMA_SIZE_32 : DMA_SIZE_16);
+  channel_config_set_read_increment(&cfg, true);
+  channel_config_set_write_increment(&cfg, true);
+  dma_channel_configure((uint)chan, &cfg, dst, src, words ? count / 2u : count, true);
+#else
+  (void)chan;
+  memcpy(dst, src, count * sizeof(int16_t));
+#endif
+}
+
+static bool sc_copy_busy(int chan) {
+#ifdef ARDUINO_ARCH_RP2040
+  return dma_channel_is_busy((uint)chan);
+#else
+  (void)chan;
+  return false;
+#endif
+}
+
+static void sc_copy_abort(int chan) {
+#ifdef ARDUINO_ARCH_RP2040
+  if (chan >= 0) dma_channel_abort((uint)chan);
+#else
+  (void)chan;
+#endif
+}
+
+// ── Helpers ─────────────────────────────────────────────────────────────────
+
+static inline bool sc_covers(const CacheSeg& s, const int16_t* src, uint32_t lo, uint32_t hi) {
+  return s.src == src && s.lo <= lo && hi <= s.hi;
+}
+
+// Pointer p such that p[i] is sample i of the segment's source
+static inline const int16_t* sc_rebase(const CacheSeg& s) {
+  return (const int16_t*)((uintptr_t)s.sram - (uintptr_t)s.lo * sizeof(int16_t));
+}
+
+static bool sc_mirror_covers(const int16_t* src, uint32_t lo, uint32_t hi, const CacheSeg** seg) {
+  for (uint32_t i = 0; i < s_mirror_segs; ++i) {
+    if (sc_covers(s_mirror[i], src, lo, hi)) {
+      if (seg) *seg = &s_mirror[i];
+      return true;
+    }
+  }
+  return false;
+}
+
+static void sc_start_mirror_seg(void) {
+  const CacheSeg& s = s_mirror[s_mirror_next];
+  sc_copy_start(s_dma_mirror, s.sram, s.src + s.lo, s.hi - s.lo);
+}
+
+static void sc_start_window(uint8_t w) {
+  const CacheSeg& s = s_window[w].back;
+  s_window[w].back_state = SC_LOADING;
+  s_window_loading = w;
+  sc_copy_start(s_dma_window, s.sram, s.src + s.lo, s.hi - s.lo);
+  s_stats.window_loads++;
+}
+
+// Retire finished copies and start the next queued one
+static void sc_service(void) {
+  if (s_mirror_state == SC_LOADING && !sc_copy_busy(s_dma_mirror)) {
+    if (++s_mirror_next < s_mirror_segs) {
+      sc_start_mirror_seg();
+    } else {
+      s_mirror_state = SC_READY;
+    }
+  }
+
+  if (s_window_loading != SC_NONE) {
+    if (sc_copy_busy(s_dma_window)) return;
+    s_window[s_window_loading].back_state = SC_READY;
+    s_window_loading = SC_NONE;
+  }
+  if (s_queue_count) {
+    const uint8_t w = s_queue[s_queue_head];
+    s_queue_head = (uint8_t)((s_queue_head + 1u) % SC_WINDOW_COUNT);
+    s_queue_count--;
+    sc_start_window(w);
+  }
+}
+
+// ── Public API ──────────────────────────────────────────────────────────────
+
+void sc_invalidate(void) {
+  sc_copy_abort(s_dma_mirror);
+  sc_copy_abort(s_dma_window);
+  memset(s_mirror, 0, sizeof(s_mirror));
+  memset(s_window, 0, sizeof(s_window));
+  s_mirror_segs = 0;
+  s_mirror_next = 0;
+  s_mirror_state = SC_EMPTY;
+  s_queue_head = 0;
+  s_queue_count = 0;
+  s_window_loading = SC_NONE;
+}
+
+void sc_init(void) {
+#ifdef ARDUINO_ARCH_RP2040
+  if (s_dma_mirror < 0) s_dma_mirror = dma_claim_unused_channel(true);
+  if (s_dma_window < 0) s_dma_window = dma_claim_unused_channel(true);
+#else
+  s_dma_mirror = 0;
+  s_dma_window = 1;
+#endif
+  sc_invalidate();
+  memset(&s_stats, 0, sizeof(s_stats));
+}
+
+void sc_plan_mirror(const int16_t* src, uint32_t lo, uint32_t hi,
+                    const int16_t* src_up, uint32_t lo_up, uint32_t hi_up) {
+  if (s_dma_mirror < 0) return;  // sc_init() not called
+  sc_service();
+  if (!src || hi <= lo) return;
+
+  // Still covered (loaded or landing) - keep it
+  const bool up = src_up && hi_up > lo_up;
+  if (sc_mirror_covers(src, lo, hi, nullptr) && (!up || sc_mirror_covers(src_up, lo_up, hi_up, nullptr))) return;
+
+  // Second segment starts word-aligned so both copies can use word transfers
+  const uint32_t n0 = (hi - lo + 1u) & ~1u;
+  const uint32_t n1 = up ? hi_up - lo_up : 0u;
+  if ((n0 + n1) * sizeof(int16_t) > SC_MIRROR_BYTES) return;  // Too long - windows serve it
+
+  sc_copy_abort(s_dma_mirror);
+  s_mirror[0] = {src, lo, hi, s_mirror_buf};
+  s_mirror[1] = {src_up, lo_up, hi_up, s_mirror_buf + n0};
+  s_mirror_segs = up ? 2u : 1u;
+  s_mirror_next = 0;
+  s_mirror_state = SC_LOADING;
+  sc_start_mirror_seg();
+  s_stats.mirror_loads++;
+}
+
+const int16_t* sc_voice_base(uint8_t k, uint8_t slot, const int16_t* src, uint32_t lo, uint32_t hi) {
+  sc_service();
+
+  const CacheSeg* seg;
+  if (s_mirror_state == SC_READY && sc_mirror_covers(src, lo, hi, &seg)) {
+    s_stats.hits++;
+    return sc_rebase(*seg);
+  }
+
+  CacheWindow& w = s_window[k * SC_LEVELS_PER_VOICE + slot];
+  if (w.back_state == SC_READY && sc_covers(w.back, src, lo, hi)) {
+    const CacheSeg front = w.front;
+    w.front = w.back;
+    w.back = front;
+    w.back_state = SC_EMPTY;
+  }
+  if (sc_covers(w.front, src, lo, hi)) {
+    s_stats.hits++;
+    return sc_rebase(w.front);
+  }
+
+  s_stats.misses++;
+  if (w.back_state == SC_QUEUED || w.back_state == SC_LOADING) s_stats.stalls++;
+  return src;
+}
+
+void sc_prefetch(uint8_t k, uint8_t slot, const int16_t* src, uint32_t total,
+                 uint32_t lo, uint32_t hi, bool reverse) {
+  if (s_dma_window < 0 || !src || hi <= lo) return;
+  if (s_mirror_state != SC_EMPTY && sc_mirror_covers(src, lo, hi, nullptr)) return;
+
+  const uint8_t id = (uint8_t)(k * SC_LEVELS_PER_VOICE + slot);
+  CacheWindow& w = s_window[id];
+  if (sc_covers(w.front, src, lo, hi)) return;
+  if (w.back_state != SC_EMPTY && sc_covers(w.back, src, lo, hi)) return;
+  if (w.back_state == SC_LOADING) return;              // Retarget once it lands
+  if (hi - lo > SC_WINDOW_SAMPLES) return;             // Too fast for a window - reads PSRAM
+
+  // Place the window ahead of the playhead in the direction of travel
+  const uint32_t count = (total < SC_WINDOW_SAMPLES) ? total : SC_WINDOW_SAMPLES;
+  uint32_t wlo = reverse ? ((hi > count) ? hi - count : 0u) : lo;
+  if (wlo + count > total) wlo = total - count;
+
+  int16_t* const buf = (w.front.sram == s_window_buf[id][0]) ? s_window_buf[id][1] : s_window_buf[id][0];
+  w.back = {src, wlo, wlo + count, buf};
+  if (w.back_state != SC_QUEUED) {
+    s_queue[(s_queue_head + s_queue_count) % SC_WINDOW_COUNT] = id;
+    s_queue_count++;
+    w.back_state = SC_QUEUED;
+  }
+  sc_service();
+}
+
+const SampleCacheStats* sc_stats(void) {
+  return &s_stats;
+}
@@ -0,0 +1,103 @@
+/**
+ * @file sample_cache.h
+ * @brief SRAM cache in front of the PSRAM sample buffers
+ *
+ * The decoded sample and its mip levels live in PSRAM, behind the QMI and
+ * its 16 KB XIP cache. The render kernels read scattered taps from several
+ * voices at once, so the XIP cache thrashes and every miss stalls the core
+ * for a PSRAM burst. This module keeps the bytes the kernels are about to
+ * read in SRAM and copies them over by DMA, off the core.
+ *
+ * ## Loop mirror
+ *
+ * Once per block the render calls sc_plan_mirror() with the primary voice's
+ * loop region at the level(s) it reads. If the region (plus the crossfade
+ * run-out on both sides) fits in SC_MIRROR_BYTES it is copied into one SRAM
+ * buffer. Every voice whose reads for the block fall inside it reads SRAM.
+ * The mirror is only reloaded when the primary's loop leaves it, so it
+ * costs one copy per loop edit rather than one per pass.
+ *
+ * ## Prefetch windows
+ *
+ * Voices the mirror does not cover (long loops, released voices running
+ * past the loop) each get a double-buffered window of SC_WINDOW_SAMPLES per
+ * level read. After a voice renders, sc_prefetch() checks that its span for
+ * the next SC_PREFETCH_BLOCKS blocks is inside the front window; if not, the
+ * back window is queued for a DMA copy placed in the direction of travel.
+ * The copy lands while other blocks render and is swapped in by the first
+ * lookup that it covers.
+ *
+ * ## Lookup
+ *
+ * sc_voice_base() is called once per voice, level and block with the span of
+ * level samples the voice may touch. It returns a pointer rebased so that
+ * base[i] addresses sample i of the level; the kernels index it exactly like
+ * the PSRAM buffer. When no SRAM copy covers the span it returns the PSRAM
+ * buffer itself - playback never waits on a copy, it just counts a miss.
+ * 
+ * Spans count int16 values, not frames: the render passes a stereo voice's
+ * frame span doubled, so every copy starts and ends on a whole L/R frame and
+ * the rebased pointer stays word-aligned for the 32-bit frame reads.
+ *
+ * ## Counters (sc_stats)
+ *
+ * - hits / misses:  voice-level-blocks served from SRAM vs. PSRAM
+ * - stalls:         misses where a window copy was queued but had not landed
+ * - mirror_loads / window_loads: DMA copies started
+ *
+ * On the host build the copies are memcpy() and complete immediately, so
+ * stalls stay at 0 there; hits and misses still show the coverage.
+ *
+ * @author Brian Varren
+ * @version 1.0
+ * @date 2025
+ */
+
+#pragma once
+#include <stdint.h>
+#include "voice_pool.h"
+
+// ── Configuration ───────────────────────────────────────────────────────────
+#ifndef SC_MIRROR_BYTES
+#define SC_MIRROR_BYTES      (96u * 1024u)  // Loop mirror budget in SRAM
+#endif
+#ifndef SC_WINDOW_SAMPLES
+#define SC_WINDOW_SAMPLES    1024u          // Per voice, per level, per buffer (x2)
+#endif
+#define SC_PREFETCH_BLOCKS   2u             // Blocks of travel a window must hold ahead
+#define SC_TAP_MARGIN        8u             // Interpolation taps either side of the playhead
+#define SC_LEVELS_PER_VOICE  2u             // Level read + next level (mip crossfade)
+
+static_assert((SC_MIRROR_BYTES % 4u) == 0, "SC_MIRROR_BYTES must be a multiple of 4");
+static_assert((SC_WINDOW_SAMPLES % 2u) == 0, "SC_WINDOW_SAMPLES must be even");
+
+struct SampleCacheStats {
+  uint32_t hits;           // Voice-level-blocks read from SRAM
+  uint32_t misses;         // Voice-level-blocks read from PSRAM
+  uint32_t stalls;         // Misses with a window copy still in flight
+  uint32_t mirror_loads;   // Loop mirror copies started
+  uint32_t window_loads;   // Prefetch window copies started
+};
+
+// Claim the DMA channels and clear the cache (from audio_init()).
+void sc_init(void);
+
+// Drop every SRAM copy (call before a sample buffer is freed or replaced).
+void sc_invalidate(void);
+
+// Keep [lo, hi) of `src` (and [lo_up, hi_up) of `src_up` when non-null)
+// mirrored in SRAM if it fits the budget. Level sample indices, exclusive hi.
+// Also advances the DMA queue; call once per block before rendering.
+void sc_plan_mirror(const int16_t* src, uint32_t lo, uint32_t hi,
+                    const int16_t* src_up, uint32_t lo_up, uint32_t hi_up);
+
+// Base pointer voice k reads level slot `slot` through for this block.
+// [lo, hi) is every sample index of `src` the voice may touch.
+const int16_t* sc_voice_base(uint8_t k, uint8_t slot, const int16_t* src, uint32_t lo, uint32_t hi);
+
+// Queue a window copy so voice k's next blocks ([lo, hi) of `src`) are in
+// SRAM. `total` bounds the window; `reverse` places it below the playhead.
+void sc_prefetch(uint8_t k, uint8_t slot, const int16_t* src, uint32_t total,
+                 uint32_t lo, uint32_t hi, bool reverse);
+
+const SampleCacheStats* sc_stats(void);
@@ -0,0 +1,130 @@
+/**
+ * @file sample_mipmap.cpp
+ * @brief Octave mipmap generation (half-band filter + decimate)
+ * 
+ * @author Brian Varren
+ * @version 1.0
+ * @date 2025
+ */
+
+#include <stdlib.h>
+#include <math.h>
+#include "sample_mipmap.h"
+#ifdef ARDUINO_ARCH_RP2040
+#include <Arduino.h>   // pmalloc()
+#endif
+
+SampleMipmap g_sample_mipmap = {{nullptr}, {0}, 1, 1, nullptr};
+
+// ── Half-band Filter ────────────────────────────────────────────────────────
+#define MIP_HB_HALF  (MIP_HALFBAND_TAPS / 2)
+
+// Centre tap and odd-offset taps h[1], h[3], ... (symmetric), Q15
+static int32_t s_hb_centre;
+static int32_t s_hb_odd[(MIP_HB_HALF + 1) / 2];
+static bool s_hb_ready = false;
+
+static void mip_init_halfband(void) {
+  const float PI = 3.14159265359f;
+  float h[(MIP_HB_HALF + 1) / 2];
+  float sum = 0.5f;
+  for (uint32_t j = 0; j < (MIP_HB_HALF + 1) / 2; ++j) {
+    const int k = 2 * (int)j + 1;                                   // 1, 3, 5, ...
+    const float sinc = sinf(PI * k * 0.5f) / (PI * k);              // 0.5 * sinc(k/2)
+    const float w = (float)(k + MIP_HB_HALF + 1) / (float)(MIP_HALFBAND_TAPS + 1);
+    const float win = 0.42f - 0.5f * cosf(2.0f * PI * w) + 0.08f * cosf(4.0f * PI * w);
+    h[j] = sinc * win;
+    sum += 2.0f * h[j];
+  }
+  // Normalize to unity DC gain
+  s_hb_centre = (int32_t)lrintf(0.5f / sum * 32768.0f);
+  for (uint32_t j = 0; j < (MIP_HB_HALF + 1) / 2; ++j) {
+    s_hb_odd[j] = (int32_t)lrintf(h[j] / sum * 32768.0f);
+  }
+  s_hb_ready = true;
+}
+
+// One decimated level: dst[n] = halfband(src)[2n], edges clamped
+// Reads and writes every `stride`-th value, so one call filters one channel
+// of an interleaved buffer
+static void mip_decimate(const int16_t* src, uint32_t count, int16_t* dst, uint32_t dst_count, uint32_t stride) {
+  const int32_t last = (int32_t)count - 1;
+  const int32_t st = (int32_t)stride;
+  for (uint32_t n = 0; n < dst_count; ++n) {
+    const int32_t c = (int32_t)(2 * n);
+    int32_t acc = s_hb_centre * src[c * st] + (1 << 14);
+    if (c - MIP_HB_HALF >= 0 && c + MIP_HB_HALF <= last) {
+      for (uint32_t j = 0; j < (MIP_HB_HALF + 1) / 2; ++j) {
+        const int32_t k = 2 * (int32_t)j + 1;
+        acc += s_hb_odd[j] * ((int32_t)src[(c - k) * st] + src[(c + k) * st]);
+      }
+    } else {
+      for (uint32_t j = 0; j < (MIP_HB_HALF + 1) / 2; ++j) {
+        const int32_t k = 2 * (int32_t)j + 1;
+        const int32_t a = (c - k < 0) ? 0 : c - k;
+        const int32_t b = (c + k > last) ? last : c + k;
+        acc += s_hb_odd[j] * ((int32_t)src[a * st] + src[b * st]);
+      }
+    }
+    acc >>= 15;
+    if (acc > 32767) acc = 32767;
+    if (acc < -32768) acc = -32768;
+    dst[n * stride] = (int16_t)acc;
+  }
+}
+
+// ── Public API ──────────────────────────────────────────────────────────────
+
+uint32_t mip_required_bytes(uint32_t count, uint8_t channels) {
+  uint32_t total = 0;
+  for (uint32_t l = 1; l < MIP_LEVELS; ++l) {
+    count = (count + 1u) / 2u;
+    total += count;
+  }
+  return total * 2u * channels;
+}
+
+void mip_release(void) {
+  if (g_sample_mipmap.storage) free(g_sample_mipmap.storage);
+  g_sample_mipmap.storage = nullptr;
+  for (uint32_t l = 0; l < MIP_LEVELS; ++l) {
+    g_sample_mipmap.level[l] = nullptr;
+    g_sample_mipmap.count[l] = 0;
+  }
+  g_sample_mipmap.levels = 1;
+  g_sample_mipmap.channels = 1;
+}
+
+uint8_t mip_build(const int16_t* src, uint32_t count, uint8_t channels) {
+  mip_release();
+  g_sample_mipmap.level[0] = src;
+  g_sample_mipmap.count[0] = count;
+  g_sample_mipmap.channels = channels;
+  if (!src || count < 2u * MIP_HALFBAND_TAPS) return 1;
+
+  if (!s_hb_ready) mip_init_halfband();
+
+  const uint32_t bytes = mip_required_bytes(count, channels);
+#ifdef ARDUINO_ARCH_RP2040
+  if (bytes > rp2040.getFreePSRAMHeap()) return 1;
+  int16_t* storage = (int16_t*)pmalloc(bytes);
+#else
+  int16_t* storage = (int16_t*)malloc(bytes);
+#endif
+  if (!storage) return 1;
+  g_sample_mipmap.storage = storage;
+
+  int16_t* dst = storage;
+  for (uint32_t l = 1; l < MIP_LEVELS; ++l) {
+    const uint32_t prev = g_sample_mipmap.count[l - 1];
+    const uint32_t n = (prev + 1u) / 2u;
+    for (uint32_t c = 0; c < channels; ++c) {
+      mip_decimate(g_sample_mipmap.level[l - 1] + c, prev, dst + c, n, channels);
+    }
+    g_sample_mipmap.level[l] = dst;
+    g_sample_mipmap.count[l] = n;
+    g_sample_mipmap.levels = (uint8_t)(l + 1);
+    dst += n * channels;
+  }
+  return g_sample_mipmap.levels;
+}
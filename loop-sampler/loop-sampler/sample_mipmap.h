@@ -0,0 +1,84 @@
+/**
+ * @file sample_mipmap.h
+ * @brief Half-band decimated octave copies of the loaded sample
+ * 
+ * The octave switch plays the sample at up to 8x with no band-limiting, so
+ * the top positions fold everything above fs/16 back into the audio band.
+ * At load time the sample is filtered and decimated into ½, ¼ and ⅛ rate
+ * copies. The render kernel reads the level whose rate brings the current
+ * increment back to about 1x and crossfades to the next level as the
+ * increment grows, so transposition stays clean and higher speeds touch
+ * fewer PSRAM bytes per output sample.
+ * 
+ * ## Layout
+ * 
+ * Level 0 is the decoded buffer itself (audioData). Levels 1..MIP_LEVELS-1
+ * live in one extra PSRAM allocation, about 0.9x the size of level 0. If
+ * that allocation fails, playback still works from level 0 alone.
+ * 
+ * Sample n of level L covers level-0 samples around n << L, so a Q32.32
+ * phase maps to level L by shifting it right by L bits. A stereo source
+ * keeps its interleaved L/R layout at every level; counts are in frames.
+ * 
+ * ## Filter
+ * 
+ * Each level is the previous one through a 23-tap half-band FIR
+ * (Blackman-windowed, Q15) and decimated by 2. Half the taps are zero, so
+ * one output costs 7 multiply-adds; building all levels of a 10 s sample
+ * takes a few ms.
+ * 
+ * @author Brian Varren
+ * @version 1.0
+ * @date 2025
+ */
+
+#pragma once
+#include <stdint.h>
+
+// ── Configuration ───────────────────────────────────────────────────────────
+#define MIP_LEVELS          4      // Level 0 + ½, ¼, ⅛ (octave switch tops out at 8x)
+#define MIP_HALFBAND_TAPS   23     // Odd; taps at even offsets other than 0 are zero
+
+struct SampleMipmap {
+  const int16_t* level[MIP_LEVELS];   // Level sample data (level 0 = source buffer)
+  uint32_t       count[MIP_LEVELS];   // Frames per level
+  uint8_t        levels;              // Valid levels (1 = no mips)
+  uint8_t        channels;            // Q15 values per frame (1 or 2)
+  int16_t*       storage;             // Owned allocation for levels 1..
+};
+
+extern SampleMipmap g_sample_mipmap;
+
+// Build levels 1.. for the given level-0 buffer of `count` frames of
+// `channels` interleaved values (allocates in PSRAM).
+// Frees any previous levels first. Returns the number of valid levels.
+uint8_t mip_build(const int16_t* src, uint32_t count, uint8_t channels = 1);
+
+// Drop the levels (call before the level-0 buffer is freed).
+void mip_release(void);
+
+// Bytes mip_build() will allocate for a source of `count` frames.
+uint32_t mip_required_bytes(uint32_t count, uint8_t channels = 1);
+
+// Pick the level pair for a playback increment (Q32.32 magnitude).
+// Reads level `*level` and, with `*blend_q15` > 0, crossfades towards
+// level+1. Level L plays at inc / 2^L, so this keeps the read rate in
+// [1, 2) and fades to the next level (rate [0.5, 1)) as speed rises.
+static inline void mip_select_level(int64_t inc_mag_q32_32, uint8_t levels,
+                                    uint8_t* level, int32_t* blend_q15) {
+  *level = 0;
+  *blend_q15 = 0;
+  if (levels < 2 || inc_mag_q32_32 <= ((int64_t)1 << 32)) return;
+
+  const uint32_t whole = (uint32_t)(inc_mag_q32_32 >> 32);          // >= 1
+  const uint32_t l0 = 31u - (uint32_t)__builtin_clz(whole);         // floor(log2(inc))
+  if (l0 >= (uint32_t)levels - 1u) {
+    *level = (uint8_t)(levels - 1u);
+    return;
+  }
+  const int64_t base = (int64_t)1 << (32 + l0);
+  int32_t w = (int32_t)((inc_mag_q32_32 - base) >> (32 + l0 - 15)); // (inc - 2^l0) / 2^l0, Q15
+  if (w > 32767) w = 32767;
+  *level = (uint8_t)l0;
+  *blend_q15 = w;
+}
@@ -0,0 +1,257 @@
+/**
+ * @file sample_stream.cpp
+ * @brief PSRAM window over a file on the SD card: residency, fill order, probe
+ *
+ * @author Brian Varren
+ * @version 1.0
+ * @date 2025
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <Arduino.h>
+#include <hardware/sync.h>
+#include "sample_stream.h"
+
+#define SS_MAP_WORDS  (SS_MAX_CHUNKS / 32u)
+
+// ── State ───────────────────────────────────────────────────────────────────
+// Core 1 owns everything but the published playhead and the render tick. The
+// render reads win_lo and the residency map; a bit is only set after its
+// chunk landed, and only cleared (window jump) a block before the chunk is
+// overwritten.
+struct SsStream {
+  int16_t* window;
+  uint32_t frames;                        // Window frames (chunks * SS_CHUNK_FRAMES)
+  uint32_t chunks;
+  uint32_t total;                         // File frames
+  uint8_t  channels;
+  ss_read_fn read;
+  void*    user;
+  bool     waiting;                       // Window moved; wait for the next render tick
+  uint32_t move_tick;
+};
+static SsStream s_ss;
+static volatile bool s_open = false;
+static volatile uint32_t s_win_lo = 0;
+static volatile uint32_t s_resident[SS_MAP_WORDS];
+static volatile uint32_t s_tick = 0;
+
+// Published by the render for the fill order
+static volatile uint32_t s_play_pos = 0;
+static volatile uint32_t s_loop_start = 0;
+static volatile uint32_t s_loop_end = 0;
+static volatile bool s_reverse = false;
+
+static ss_stats_t s_stats;
+
+static inline bool chunk_resident(uint32_t c) {
+  return (s_resident[c >> 5] >> (c & 31u)) & 1u;
+}
+
+// True when chunks c0..c1 (inclusive) are all resident
+static bool range_resident(uint32_t c0, uint32_t c1) {
+  for (uint32_t w = c0 >> 5; w <= (c1 >> 5); ++w) {
+    uint32_t mask = 0xFFFFFFFFu;
+    if (w == (c0 >> 5)) mask &= 0xFFFFFFFFu << (c0 & 31u);
+    if (w == (c1 >> 5)) mask &= 0xFFFFFFFFu >> (31u - (c1 & 31u));
+    if ((s_resident[w] & mask) != mask) return false;
+  }
+  return true;
+}
+
+// ── Setup ───────────────────────────────────────────────────────────────────
+uint32_t ss_window_frames(uint32_t bytes, uint8_t channels) {
+  const uint32_t chunk_bytes = SS_CHUNK_FRAMES * 2u * channels;
+  uint32_t chunks = bytes / chunk_bytes;
+  if (chunks > SS_MAX_CHUNKS) chunks = SS_MAX_CHUNKS;
+  return (chunks < SS_MIN_CHUNKS) ? 0u : chunks * SS_CHUNK_FRAMES;
+}
+
+bool ss_open(int16_t* window, uint32_t window_frames, uint32_t total_frames, uint8_t channels,
+             ss_read_fn read, void* user) {
+  ss_close();
+  const uint32_t chunks = window_frames / SS_CHUNK_FRAMES;
+  if (!window || !read || chunks < SS_MIN_CHUNKS || chunks > SS_MAX_CHUNKS || !total_frames ||
+      (channels != 1u && channels != 2u)) {
+    return false;
+  }
+  SsStream& s = s_ss;
+  s.window = window;
+  s.chunks = chunks;
+  s.frames = chunks * SS_CHUNK_FRAMES;
+  s.total = total_frames;
+  s.channels = channels;
+  s.read = read;
+  s.user = user;
+  s.waiting = false;
+  s_win_lo = 0;
+  s_play_pos = 0;
+  s_loop_start = 0;
+  s_loop_end = 0;
+  s_reverse = false;
+  memset(&s_stats, 0, sizeof(s_stats));
+  __compiler_memory_barrier();
+  s_open = true;
+  return true;
+}
+
+void ss_close(void) {
+  s_open = false;
+  __compiler_memory_barrier();
+  for (uint32_t w = 0; w < SS_MAP_WORDS; ++w) s_resident[w] = 0;
+  s_ss.window = nullptr;
+  s_ss.total = 0;
+}
+
+// ── Chunk Loads ─────────────────────────────────────────────────────────────
+// Read chunk c of the window; the tail past the end of the file is silence
+static void load_chunk(uint32_t c) {
+  SsStream& s = s_ss;
+  const uint32_t frame = s_win_lo + c * SS_CHUNK_FRAMES;
+  int16_t* dst = s.window + (size_t)c * SS_CHUNK_FRAMES * s.channels;
+  const uint32_t n = (frame >= s.total) ? 0u
+                   : (s.total - frame < SS_CHUNK_FRAMES) ? s.total - frame : SS_CHUNK_FRAMES;
+  if (n && !s.read(s.user, frame, dst, n)) {
+    s_stats.read_errors++;
+    memset(dst, 0, (size_t)n * 2u * s.channels);
+  }
+  if (n < SS_CHUNK_FRAMES) memset(dst + (size_t)n * s.channels, 0, (size_t)(SS_CHUNK_FRAMES - n) * 2u * s.channels);
+  s_stats.loads++;
+  __compiler_memory_barrier();  // Data before bit
+  s_resident[c >> 5] |= 1u << (c & 31u);
+}
+
+bool ss_probe(uint32_t src_rate_hz) {
+  SsStream& s = s_ss;
+  if (!s_open) return false;
+  const uint32_t chunks = (s.chunks < SS_PROBE_CHUNKS) ? s.chunks : SS_PROBE_CHUNKS;
+  const uint32_t t0 = micros();
+  for (uint32_t c = 0; c < chunks; ++c) load_chunk(c);
+  const uint32_t dt = micros() - t0;
+  const uint64_t frames = (uint64_t)chunks * SS_CHUNK_FRAMES;
+  s_stats.probe_fps = dt ? (uint32_t)((frames * 1000000u) / dt) : 0xFFFFFFFFu;
+  return (uint64_t)s_stats.probe_fps >= (uint64_t)src_rate_hz * SS_MIN_RATE_X;
+}
+
+// Centre the window on file frames [lo, hi); its old contents are dropped
+static void move_window(uint32_t lo, uint32_t hi) {
+  SsStream& s = s_ss;
+  const uint32_t mid = lo + (hi - lo) / 2u;
+  uint32_t win_lo = (mid > s.frames / 2u) ? mid - s.frames / 2u : 0u;
+  if (win_lo + s.frames > s.total) win_lo = (s.total > s.frames) ? s.total - s.frames : 0u;
+  for (uint32_t w = 0; w < SS_MAP_WORDS; ++w) s_resident[w] = 0;
+  __compiler_memory_barrier();  // Bits cleared before the new origin shows
+  s_win_lo = win_lo;
+  s.move_tick = s_tick;
+  s.waiting = true;
+  s_stats.moves++;
+}
+
+bool ss_poll(void) {
+  SsStream& s = s_ss;
+  if (!s_open) return false;
+
+  // A render that saw the old window may still be reading it until the
+  // next block starts
+  if (s.waiting) {
+    if (s_tick == s.move_tick) return false;
+    s.waiting = false;
+  }
+
+  uint32_t pos = s_play_pos;
+  uint32_t ls = s_loop_start;
+  uint32_t le = s_loop_end;
+  const bool rev = s_reverse;
+  if (le <= ls || le > s.total) {
+    // Nothing played yet: the loop the knobs start with is at the file start
+    ls = 0;
+    le = (s.total < ss_loop_capacity()) ? s.total : ss_loop_capacity();
+  }
+  const uint32_t lo = (ls > SS_MARGIN_FRAMES) ? ls - SS_MARGIN_FRAMES : 0u;
+  const uint32_t hi = (le + SS_MARGIN_FRAMES < s.total) ? le + SS_MARGIN_FRAMES : s.total;
+  const uint32_t win_lo = s_win_lo;
+  if (lo < win_lo || hi > win_lo + s.frames) {
+    move_window(lo, hi);
+    return false;
+  }
+
+  // 1. The loop region from the playhead on, in the direction of travel
+  if (pos < lo) pos = lo;
+  if (pos >= hi) pos = hi - 1u;
+  const uint32_t c_lo = (lo - win_lo) / SS_CHUNK_FRAMES;
+  const uint32_t c_hi = (hi - 1u - win_lo) / SS_CHUNK_FRAMES;
+  const uint32_t c_pos = (pos - win_lo) / SS_CHUNK_FRAMES;
+  const uint32_t span = c_hi - c_lo + 1u;
+  for (uint32_t i = 0; i < span; ++i) {
+    const uint32_t off = rev ? (c_pos - c_lo + span - i) % span : (c_pos - c_lo + i) % span;
+    if (!chunk_resident(c_lo + off)) {
+      load_chunk(c_lo + off);
+      return true;
+    }
+  }
+
+  // 2. and 3. Read-ahead past the loop, then behind it
+  for (uint32_t pass = 0; pass < 2u; ++pass) {
+    const bool up = (pass == 0) != rev;
+    if (up) {
+      for (uint32_t c = c_hi + 1u; c < s.chunks; ++c) {
+        if (!chunk_resident(c)) { load_chunk(c); return true; }
+      }
+    } else {
+      for (uint32_t c = c_lo; c-- > 0;) {
+        if (!chunk_resident(c)) { load_chunk(c); return true; }
+      }
+    }
+  }
+  return false;
+}
+
+// ── Render ──────────────────────────────────────────────────────────────────
+bool ss_streaming(const int16_t* samples) {
+  return s_open && samples && samples == s_ss.window;
+}
+
+uint32_t ss_loop_capacity(void) {
+  return s_ss.frames - 2u * SS_MARGIN_FRAMES;
+}
+
+const int16_t* ss_voice_base(uint32_t lo, uint32_t hi) {
+  const SsStream& s = s_ss;
+  const uint32_t win_lo = s_win_lo;
+  __compiler_memory_barrier();  // Origin before bits (see move_window())
+  if (hi <= lo) hi = lo + 1u;
+  if (lo < win_lo || hi > win_lo + s.frames ||
+      !range_resident((lo - win_lo) / SS_CHUNK_FRAMES, (hi - 1u - win_lo) / SS_CHUNK_FRAMES)) {
+    s_stats.skips++;
+    return nullptr;
+  }
+  return s.window - (size_t)win_lo * s.channels;
+}
+
+void ss_render_tick(void) {
+  s_tick = s_tick + 1u;
+}
+
+void ss_note_block(uint32_t pos, bool reverse, uint32_t loop_start, uint32_t loop_end, bool starved) {
+  s_play_pos = pos;
+  s_reverse = reverse;
+  s_loop_start = loop_start;
+  s_loop_end = loop_end;
+  if (starved) s_stats.underruns++;
+}
+
+// ── Readout ─────────────────────────────────────────────────────────────────
+uint32_t ss_total_frames(void) {
+  return s_open ? s_ss.total : 0u;
+}
+
+uint32_t ss_resident_chunks(void) {
+  uint32_t n = 0;
+  for (uint32_t w = 0; w < SS_MAP_WORDS; ++w) n += (uint32_t)__builtin_popcount(s_resident[w]);
+  return n;
+}
+
+void ss_get_stats(ss_stats_t* out) {
+  if (out) *out = s_stats;
+}
@@ -0,0 +1,153 @@
+/**
+ * @file sample_stream.h
+ * @brief Playback of samples larger than PSRAM, streamed from the SD card
+ *
+ * When a file does not fit in PSRAM the loader falls back to streaming. It
+ * allocates the largest window that fits and hands it to ss_open() with a
+ * reader for the file. The engine is bound to the whole file's frame count,
+ * and the render plays from the window. Core 1 keeps the window filled
+ * around the playhead.
+ *
+ * ## Window
+ *
+ * The window holds the contiguous run of file frames [win_lo, win_lo + size).
+ * It is not a ring: the kernels address samples linearly through a rebased
+ * pointer, as they do with the SRAM copies (sample_cache.h). The window is
+ * cut into SS_CHUNK_FRAMES chunks, and each chunk has a residency bit. A chunk
+ * is read whole, and its bit is set after the data has landed.
+ *
+ * The primary voice's loop is always pinned: its region plus SS_MARGIN_FRAMES
+ * either side must lie inside the window. Loops are clamped to
+ * ss_loop_capacity() frames so that this is always possible. When the loop
+ * moves out of the window, the window jumps so that it is centred on the
+ * loop. All bits are cleared, and core 1 waits for the render to start a new
+ * block before it overwrites anything.
+ *
+ * ## Fill order
+ *
+ * ss_poll() loads one chunk per call, from loop1(). It takes the first chunk
+ * not yet resident, in this order:
+ *
+ * 1. the loop region, starting from the chunk under the playhead and going in
+ *    the direction of travel, wrapping at the loop edges;
+ * 2. the rest of the window ahead of the loop in the direction of travel;
+ * 3. the rest of the window behind it.
+ *
+ * ## Render
+ *
+ * Once per voice and block the render asks ss_voice_base() for the span it
+ * may read. If any chunk of that span is missing, it gets nullptr. The voice
+ * is then stepped through the block without reading samples, and stays
+ * silent. This counts as a skip, and as an underrun when the voice is the
+ * primary. Playback never waits for the card.
+ *
+ * Streaming plays level 0 only. There are no mip levels, zero crossings,
+ * slice map, SRAM loop mirror or seam recordings, and no overdub. All of
+ * these would need the whole file, or a copy that outlives the window's
+ * chunks.
+ *
+ * ## Load check
+ *
+ * ss_probe() times SS_PROBE_CHUNKS chunk reads. The load is refused when the
+ * reader delivers less than SS_MIN_RATE_X times the source rate. Below that,
+ * a loop edit or a retrigger leaves the voice starved for longer than a
+ * crossfade.
+ *
+ * @author Brian Varren
+ * @version 1.0
+ * @date 2025
+ */
+
+#pragma once
+#include <stdint.h>
+
+// ── Configuration ───────────────────────────────────────────────────────────
+#define SS_CHUNK_FRAMES    4096u    // Frames per read and per residency bit (85 ms at 48 kHz)
+#define SS_MAX_CHUNKS      1024u    // Largest window, in chunks (8 MB of stereo Q15)
+#define SS_MIN_CHUNKS      4u       // Smallest window worth streaming through
+#define SS_MARGIN_FRAMES   SS_CHUNK_FRAMES  // Kept resident beyond each loop edge
+#define SS_PROBE_CHUNKS    8u       // Chunks read by ss_probe()
+#define SS_MIN_RATE_X      4u       // Reader throughput needed, in multiples of the source rate
+#define SS_PSRAM_RESERVE   (256u * 1024u)   // PSRAM the loader leaves free (recorder takes, UI)
+
+// Read `frames` Q15 frames of the file from `frame` on into dst
+// (interleaved L/R when streaming stereo). Return false on a read error.
+typedef bool (*ss_read_fn)(void* user, uint32_t frame, int16_t* dst, uint32_t frames);
+
+struct ss_stats_t {
+  uint32_t loads;             // Chunks read
+  uint32_t moves;             // Window jumps
+  uint32_t skips;             // Voice-blocks stepped without data
+  uint32_t underruns;         // Blocks the primary voice was silent for lack of data
+  uint32_t read_errors;       // Chunks the reader failed (played as silence)
+  uint32_t probe_fps;         // Throughput measured by ss_probe(), frames/s
+};
+
+// ── Setup (core 1) ──────────────────────────────────────────────────────────
+
+/**
+ * @brief Window frames that fit in `bytes` of PSRAM (0 when too few to stream)
+ */
+uint32_t ss_window_frames(uint32_t bytes, uint8_t channels);
+
+/**
+ * @brief Start streaming a file through `window` (ss_window_frames() frames)
+ *
+ * The window is empty until ss_poll() fills it. Bind the engine to the
+ * window pointer with total_frames.
+ */
+bool ss_open(int16_t* window, uint32_t window_frames, uint32_t total_frames, uint8_t channels,
+             ss_read_fn read, void* user);
+
+/**
+ * @brief Stop streaming; call after the engine has been unbound from the
+ *        window and before the window is freed
+ */
+void ss_close(void);
+
+/**
+ * @brief Time SS_PROBE_CHUNKS reads and check them against the source rate
+ * @return false when the reader is slower than SS_MIN_RATE_X x src_rate_hz
+ */
+bool ss_probe(uint32_t src_rate_hz);
+
+/**
+ * @brief Load the next chunk the playhead needs
+ * @return true when a chunk was read
+ */
+bool ss_poll(void);
+
+// ── Render (core 0) ─────────────────────────────────────────────────────────
+
+/**
+ * @brief True when `samples` is the open window (the render streams it)
+ */
+bool ss_streaming(const int16_t* samples);
+
+/**
+ * @brief Longest loop the window can pin, in frames
+ */
+uint32_t ss_loop_capacity(void);
+
+/**
+ * @brief Read base for file frames [lo, hi), or nullptr when any is missing
+ *
+ * The pointer is rebased so that base[i * channels] is file frame i.
+ */
+const int16_t* ss_voice_base(uint32_t lo, uint32_t hi);
+
+/**
+ * @brief Called first thing in every render, playing or not
+ */
+void ss_render_tick(void);
+
+/**
+ * @brief Publish where the primary voice is for the fill order
+ * @param starved The primary was stepped without data this block
+ */
+void ss_note_block(uint32_t pos, bool reverse, uint32_t loop_start, uint32_t loop_end, bool starved);
+
+// ── Readout (any core) ──────────────────────────────────────────────────────
+uint32_t ss_total_frames(void);        // File frames (0 when not streaming)
+uint32_t ss_resident_chunks(void);
+void ss_get_stats(ss_stats_t* out);
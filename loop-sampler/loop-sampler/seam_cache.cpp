@@ -0,0 +1,84 @@
+/**
+ * @file seam_cache.cpp
+ * @brief Loop seam recording storage and key matching
+ *
+ * @author Brian Varren
+ * @version 1.0
+ * @date 2025
+ */
+
+#include <string.h>
+#include "seam_cache.h"
+
+static int16_t s_seam_buf[SEAM_CACHE_SAMPLES];
+static SeamKey s_key;
+static uint32_t s_len = 0;         // Samples recorded
+static bool s_recording = false;
+static bool s_ready = false;
+static SeamCacheStats s_stats;
+
+static bool seam_key_equal(const SeamKey* a, const SeamKey* b) {
+  return a->src == b->src && a->total_samples == b->total_samples &&
+         a->loop_start == b->loop_start && a->loop_end == b->loop_end &&
+         a->xfade_len == b->xfade_len && a->xfade_samples == b->xfade_samples &&
+         a->inc_q32_32 == b->inc_q32_32 && a->entry_phase_q32_32 == b->entry_phase_q32_32 &&
+         a->mip_blend_q15 == b->mip_blend_q15 && a->dir == b->dir && a->curve == b->curve &&
+         a->interp == b->interp && a->mip_level == b->mip_level;
+}
+
+void seam_reset(void) {
+  s_len = 0;
+  s_recording = false;
+  s_ready = false;
+}
+
+bool seam_match(const SeamKey* key) {
+  return s_ready && seam_key_equal(&s_key, key);
+}
+
+void seam_record_begin(const SeamKey* key) {
+  s_key = *key;
+  s_len = 0;
+  s_ready = false;
+  s_recording = key->xfade_samples <= SEAM_CACHE_SAMPLES;
+}
+
+bool seam_record(const int32_t* mix, uint32_t n) {
+  if (!s_recording) return false;
+  const uint32_t room = s_key.xfade_samples - s_len;
+  if (n > room) n = room;
+  for (uint32_t i = 0; i < n; ++i) {
+    int32_t s = mix[i];
+    if (s > 32767) s = 32767;
+    if (s < -32768) s = -32768;
+    s_seam_buf[s_len + i] = (int16_t)s;
+  }
+  s_len += n;
+  if (s_len < s_key.xfade_samples) return false;
+
+  s_recording = false;
+  s_ready = true;
+  s_stats.records++;
+  return true;
+}
+
+void seam_record_abandon(void) {
+  s_recording = false;
+  s_ready = false;
+}
+
+const int16_t* seam_data(void) {
+  return s_seam_buf;
+}
+
+void seam_note_replay(void) {
+  s_stats.replays++;
+}
+
+void seam_note_cancel(void) {
+  s_stats.cancels++;
+}
+
+const SeamCacheStats* seam_stats(void) {
+  return &s_stats;
+}
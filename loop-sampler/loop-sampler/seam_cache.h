@@ -0,0 +1,91 @@
+/**
+ * @file seam_cache.h
+ * @brief Recorded loop seam for replay while the knobs hold still
+ *
+ * Every FWD/REV loop pass ends in a seam: the outgoing primary fades out
+ * over the end of the loop while a new primary fades in from the other
+ * edge, so for xfade_samples output samples two interpolated voices run
+ * with envelopes. With the knobs left alone each pass repeats the same
+ * seam bit for bit: the new primary starts exactly on the loop edge and
+ * steps by the same increment, so it reaches the crossfade zone at the
+ * same phase every time.
+ *
+ * The first seam with a given key is recorded as it renders (the two seam
+ * voices mix into a side accumulator that is appended here). Later seams
+ * with the same key play the recording instead; the two voices only have
+ * their phase and envelope stepped arithmetically, so if anything changes
+ * mid-seam (trigger, knob, mode, FM) the render drops the replay and they
+ * carry on live from exactly where they would have been.
+ *
+ * ## Key
+ *
+ * Everything the two voices' output depends on: the sample buffer, loop
+ * bounds, crossfade zone length / duration / curve, the increment, the
+ * outgoing voice's phase at zone entry, direction, interpolation mode and
+ * mip level / blend. The key is checked again every block of the seam.
+ *
+ * ## Cost
+ *
+ * One SEAM_CACHE_SAMPLES Q15 buffer in SRAM; seams longer than that are
+ * never cached. The recording is saturated to Q15, so a replay differs from
+ * the live seam only where the crossfade sum itself would clip.
+ *
+ * @author Brian Varren
+ * @version 1.0
+ * @date 2025
+ */
+
+#pragma once
+#include <stdint.h>
+
+// ── Configuration ───────────────────────────────────────────────────────────
+#ifndef SEAM_CACHE_SAMPLES
+#define SEAM_CACHE_SAMPLES   8192u   // 16 KB; ~0.2 s seam at the PWM output rate
+#endif
+
+struct SeamKey {
+  const int16_t* src;          // Sample buffer (level 0)
+  uint32_t total_samples;
+  uint32_t loop_start;
+  uint32_t loop_end;
+  uint32_t xfade_len;          // Zone length (source samples)
+  uint32_t xfade_samples;      // Seam length (output samples)
+  int64_t  inc_q32_32;         // Block-constant increment (seams are never cached with FM)
+  uint64_t entry_phase_q32_32; // Outgoing voice at zone entry
+  int32_t  mip_blend_q15;
+  uint8_t  dir;
+  uint8_t  curve;
+  uint8_t  interp;
+  uint8_t  mip_level;
+};
+
+struct SeamCacheStats {
+  uint32_t records;    // Seams recorded
+  uint32_t replays;    // Seams played from the recording
+  uint32_t cancels;    // Recordings or replays dropped mid-seam
+};
+
+// Forget the recording (call before a sample buffer is freed or replaced).
+void seam_reset(void);
+
+// True when a complete recording exists for this key.
+bool seam_match(const SeamKey* key);
+
+// Start recording a seam for `key` (drops any previous recording).
+void seam_record_begin(const SeamKey* key);
+
+// Append n mixed samples of the seam being recorded (saturated to Q15).
+// Returns true once key->xfade_samples samples have been recorded.
+bool seam_record(const int32_t* mix, uint32_t n);
+
+// Drop a recording that did not complete.
+void seam_record_abandon(void);
+
+// Recorded seam (valid after seam_match() returns true).
+const int16_t* seam_data(void);
+
+// Count a replay / a dropped seam.
+void seam_note_replay(void);
+void seam_note_cancel(void);
+
+const SeamCacheStats* seam_stats(void);
@@ -0,0 +1,27 @@
+/**
+ * @file serial_commands.cpp
+ * @brief Serial key dispatch
+ *
+ * @author Brian Varren
+ * @version 1.0
+ * @date 2025
+ */
+
+#include <Arduino.h>
+#include "serial_commands.h"
+#include "render_profiler.h"
+#include "recorder.h"
+#include "waveshaper.h"
+#include "stereo_delay.h"
+#include "granular.h"
+
+void serial_commands_poll(void) {
+  while (Serial.available() > 0) {
+    const char c = (char)Serial.read();
+    prof_serial_command(c);
+    rec_serial_command(c);
+    ws_serial_command(c);
+    dly_serial_command(c);
+    gr_serial_command(c);
+  }
+}
@@ -0,0 +1,25 @@
+/**
+ * @file serial_commands.h
+ * @brief Single-key commands over the USB serial port
+ *
+ * serial_commands_poll() drains the receive buffer from loop1() and hands
+ * every byte to each module's key handler. Keys are single characters and
+ * no two modules share one:
+ *
+ * | Keys      | Module                                             |
+ * |-----------|----------------------------------------------------|
+ * | 'p' 'r'   | profiler dump / reset (render_profiler.h)          |
+ * | 'R' 'O'   | take / overdub (recorder.h)                        |
+ * | 'W' 'X'   | saturation curve / 2x oversampling (waveshaper.h)  |
+ * | 'D' 'T'   | delay / tempo sync (stereo_delay.h)                |
+ * | 'G'       | granular mode (granular.h)                         |
+ *
+ * @author Brian Varren
+ * @version 1.0
+ * @date 2025
+ */
+
+#pragma once
+
+// Read every pending byte and dispatch it (core 1, from loop1(); never blocks).
+void serial_commands_poll(void);
@@ -78,7 +78,8 @@
 // default namespace for compatibility with existing code.
 extern uint8_t*  audioData;          // Q15 audio samples in PSRAM buffer
 extern uint32_t  audioDataSize;      // Total bytes allocated in PSRAM
-extern uint32_t  audioSampleCount;   // Number of Q15 samples in buffer
+extern uint32_t  audioSampleCount;   // Number of sample frames in buffer
+extern uint8_t   audioChannels;      // Q15 values per frame: 1 = mono, 2 = interleaved L/R
 extern sf::WavInfo   currentWav;     // Original WAV file metadata
 
 // ── Namespace Aliases ──────────────────────────────────────────────────────────
@@ -88,7 +89,8 @@ extern sf::WavInfo   currentWav;     // Original WAV file metadata
 namespace sf {
   using ::audioData;        // Q15 audio samples in PSRAM
   using ::audioDataSize;    // PSRAM buffer size in bytes
-  using ::audioSampleCount; // Number of Q15 samples
+  using ::audioSampleCount; // Number of sample frames
+  using ::audioChannels;    // 1 = mono, 2 = interleaved L/R
   using ::currentWav;       // WAV file metadata
 }
 
@@ -0,0 +1,275 @@
+/**
+ * @file slice_map.cpp
+ * @brief Energy-flux onset scan, onset refinement and slice map publishing
+ *
+ * @author Brian Varren
+ * @version 1.0
+ * @date 2025
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <hardware/sync.h>
+#include "slice_map.h"
+
+#define SM_SUB          16u                  // Frames per envelope step when refining
+#define SM_REFINE_SUBS  (2u * SM_HOP / SM_SUB)
+#define SM_REF_HOPS     4u                   // Hops in the flux reference (1024 frames, > 1 cycle at 50 Hz)
+#define SM_NONE         0xFFFFFFFFu
+
+// ── Scan State (core 1) ─────────────────────────────────────────────────────
+// Energy flux is tracked in two bands: the signal itself (kicks, bass) and
+// its first difference, which tilts the energy towards the top end so hats
+// and snares still stand out over the tail of a low hit.
+enum SmBandId : uint8_t { SM_BAND_FULL = 0, SM_BAND_HIGH, SM_BANDS };
+
+struct SmBand {
+  uint32_t energy[SM_REF_HOPS];           // Energy of hops n-1 .. n-SM_REF_HOPS, ring
+  uint32_t f1, f2;                        // Flux of hops n-1, n-2
+  bool     r1;                            // Hop n-1 rose 1.5x over its reference
+  uint32_t hist[SM_FLUX_WINDOW];          // Recent flux, ring
+  uint64_t hist_sum;
+};
+
+struct SmScan {
+  const int16_t* samples;
+  uint32_t frames;
+  uint8_t  channels;
+  uint32_t min_gap;                       // SM_MIN_GAP_MS in frames
+  uint32_t hop;                           // Next hop to read
+  SmBand   band[SM_BANDS];
+  uint32_t cand_pos[SM_MAX_SLICES - 1];   // Onsets after frame 0, unordered
+  uint32_t cand_flux[SM_MAX_SLICES - 1];
+  uint32_t cand_count;
+  uint32_t last;                          // Slot of the latest onset kept (SM_NONE = dropped)
+  bool running;
+};
+static SmScan s_scan;
+
+// ── Published Maps ──────────────────────────────────────────────────────────
+static SliceMap s_maps[2];
+static uint32_t s_write = 0;                         // Table the next scan fills
+static const SliceMap* volatile s_published = nullptr;
+static volatile uint32_t s_generation = 0;
+static volatile bool s_slice_mode = SM_SLICE_MODE;
+
+static inline int32_t sm_frame(const SmScan& s, uint32_t i) {
+  return (s.channels == 2) ? (((int32_t)s.samples[2 * i] + s.samples[2 * i + 1]) >> 1) : s.samples[i];
+}
+
+static inline uint32_t sm_abs(int32_t x) {
+  return (uint32_t)((x < 0) ? -x : x);
+}
+
+// Frame i as seen by a band (the high band is x[i] - x[i-1])
+static inline int32_t sm_band_frame(const SmScan& s, SmBandId b, uint32_t i) {
+  const int32_t x = sm_frame(s, i);
+  if (b == SM_BAND_FULL) return x;
+  return i ? x - sm_frame(s, i - 1u) : 0;
+}
+
+void sm_cancel(void) {
+  s_scan.running = false;
+  if (s_published) {
+    s_published = nullptr;
+    __compiler_memory_barrier();
+    s_generation = s_generation + 1;
+  }
+}
+
+void sm_begin(const int16_t* samples, uint32_t frames, uint8_t channels, uint32_t sample_rate_hz) {
+  sm_cancel();
+  SmScan& s = s_scan;
+  memset(&s, 0, sizeof(s));
+  if (!samples || frames < 2u * SM_HOP) return;
+  s.samples = samples;
+  s.frames = frames;
+  s.channels = channels;
+  s.min_gap = (uint32_t)(((uint64_t)sample_rate_hz * SM_MIN_GAP_MS) / 1000u);
+  s.last = SM_NONE;
+  s.running = true;
+}
+
+// ── Onset Refinement ────────────────────────────────────────────────────────
+// The attack of an onset found in hop c lies in hops c-1..c. On the band that
+// found it, walk a 16-frame
+// peak envelope back from its maximum to where it first holds a quarter of
+// it, then step back sample by sample while the signal keeps falling towards
+// zero (at most SM_SUB frames, so a low tail under the hit is not followed).
+static uint32_t sm_refine(const SmScan& s, SmBandId b, uint32_t hop) {
+  const uint32_t lo = (hop - 1u) * SM_HOP;
+  uint32_t sub_peak[SM_REFINE_SUBS];
+  uint32_t peak = 0, peak_sub = 0;
+  for (uint32_t j = 0; j < SM_REFINE_SUBS; ++j) {
+    uint32_t m = 0;
+    for (uint32_t i = lo + j * SM_SUB; i < lo + (j + 1u) * SM_SUB; ++i) {
+      const uint32_t a = sm_abs(sm_band_frame(s, b, i));
+      if (a > m) m = a;
+    }
+    sub_peak[j] = m;
+    if (m > peak) { peak = m; peak_sub = j; }
+  }
+  const uint32_t thr = peak / 4u;
+  uint32_t j = peak_sub;
+  while (j > 0 && sub_peak[j - 1u] >= thr) --j;
+
+  uint32_t k = lo + j * SM_SUB;
+  while (sm_abs(sm_band_frame(s, b, k)) < thr) ++k;  // Sub-block j holds a sample >= thr
+
+  // Back to the foot of the attack: a sign change, a near-zero sample or
+  // the point where the magnitude stops falling
+  const uint32_t quiet = peak / 64u;
+  const uint32_t stop = (k - lo > SM_SUB) ? k - SM_SUB : lo;
+  int32_t x = sm_band_frame(s, b, k);
+  while (k > stop) {
+    const int32_t p = sm_band_frame(s, b, k - 1u);
+    if (sm_abs(p) <= quiet || ((p < 0) != (x < 0)) || sm_abs(p) >= sm_abs(x)) break;
+    x = p;
+    --k;
+  }
+  return k;
+}
+
+// ── Candidates ──────────────────────────────────────────────────────────────
+static void sm_add_onset(SmScan& s, uint32_t pos, uint32_t flux) {
+  if (pos < s.min_gap) return;  // Slice 0 covers the start of the buffer
+
+  // Too close to the previous onset: keep the stronger of the two
+  if (s.last != SM_NONE && pos - s.cand_pos[s.last] < s.min_gap) {
+    if (flux > s.cand_flux[s.last]) {
+      s.cand_pos[s.last] = pos;
+      s.cand_flux[s.last] = flux;
+    }
+    return;
+  }
+
+  uint32_t slot = s.cand_count;
+  if (slot == SM_MAX_SLICES - 1u) {
+    // Full: replace the weakest onset if this one is stronger
+    slot = 0;
+    for (uint32_t i = 1; i < s.cand_count; ++i) {
+      if (s.cand_flux[i] < s.cand_flux[slot]) slot = i;
+    }
+    if (flux <= s.cand_flux[slot]) {
+      s.last = SM_NONE;
+      return;
+    }
+  } else {
+    s.cand_count++;
+  }
+  s.cand_pos[slot] = pos;
+  s.cand_flux[slot] = flux;
+  s.last = slot;
+}
+
+static void sm_publish(SmScan& s) {
+  SliceMap& m = s_maps[s_write];
+  m.samples = s.samples;
+  m.frames = s.frames;
+  m.channels = s.channels;
+  m.pos[0] = 0;
+  m.count = 1;
+  for (uint32_t i = 0; i < s.cand_count; ++i) {
+    // Insertion sort - at most 63 entries, once per load
+    const uint32_t x = s.cand_pos[i];
+    uint32_t j = m.count;
+    while (j > 1u && m.pos[j - 1u] > x) { m.pos[j] = m.pos[j - 1u]; --j; }
+    m.pos[j] = x;
+    m.count++;
+  }
+  __compiler_memory_barrier();  // Table before pointer
+  s_published = &m;
+  __compiler_memory_barrier();
+  s_write ^= 1u;
+  s_generation = s_generation + 1;
+}
+
+// ── Scan ────────────────────────────────────────────────────────────────────
+// Take hop n's energy in one band. Returns true (and hop n-1's flux) when hop
+// n-1 is an onset in it: its flux peaks, it rose to 1.5x its reference and
+// it stands out from the recent flux.
+static bool sm_band_step(SmBand& b, uint32_t e, uint32_t hop, uint32_t* out_flux) {
+  // Flux against the loudest of the previous hops: a low tone's hop energy
+  // ripples at twice its frequency, its maximum over SM_REF_HOPS hops does not
+  uint32_t ref = 0;
+  for (uint32_t j = 0; j < SM_REF_HOPS; ++j) {
+    if (b.energy[j] > ref) ref = b.energy[j];
+  }
+  const uint32_t f = (e > ref) ? e - ref : 0u;
+
+  bool onset = false;
+  if (hop >= 2u) {
+    const uint64_t mean_x = (uint64_t)SM_FLUX_RATIO * b.hist_sum;   // x SM_FLUX_WINDOW
+    onset = b.r1 && b.f1 > b.f2 && b.f1 >= f && b.f1 > SM_FLUX_FLOOR &&
+            (uint64_t)b.f1 * SM_FLUX_WINDOW > mean_x;
+  }
+  *out_flux = b.f1;
+  if (hop >= 1u) {
+    uint32_t& h = b.hist[(hop - 1u) % SM_FLUX_WINDOW];
+    b.hist_sum += (uint64_t)b.f1 - h;
+    h = b.f1;
+  }
+  b.energy[hop % SM_REF_HOPS] = e;
+  b.f2 = b.f1;
+  b.f1 = f;
+  b.r1 = 2u * f >= ref;
+  return onset;
+}
+
+bool sm_poll(void) {
+  SmScan& s = s_scan;
+  if (!s.running) return false;
+
+  const uint32_t hops = s.frames / SM_HOP;
+  const uint32_t hop_end = (s.hop + SM_POLL_FRAMES / SM_HOP < hops) ? s.hop + SM_POLL_FRAMES / SM_HOP : hops;
+  for (; s.hop < hop_end; ++s.hop) {
+    // Hop energies: sum of x^2 / 1024 and (x[i] - x[i-1])^2 / 4096, each at
+    // most 2^28 for a full-scale hop
+    uint32_t e_full = 0, e_high = 0;
+    const uint32_t i0 = s.hop * SM_HOP;
+    int32_t prev = i0 ? sm_frame(s, i0 - 1u) : 0;
+    for (uint32_t i = i0; i < i0 + SM_HOP; ++i) {
+      const int32_t x = sm_frame(s, i);
+      const uint32_t d = sm_abs(x - prev);
+      e_full += (uint32_t)(x * x) >> 10;
+      e_high += (d * d) >> 12;
+      prev = x;
+    }
+    uint32_t f_full, f_high;
+    const bool on_full = sm_band_step(s.band[SM_BAND_FULL], e_full, s.hop, &f_full);
+    const bool on_high = sm_band_step(s.band[SM_BAND_HIGH], e_high, s.hop, &f_high);
+    if (on_full) {
+      sm_add_onset(s, sm_refine(s, SM_BAND_FULL, s.hop - 1u), (f_full > f_high) ? f_full : f_high);
+    } else if (on_high) {
+      sm_add_onset(s, sm_refine(s, SM_BAND_HIGH, s.hop - 1u), f_high);
+    }
+  }
+
+  if (s.hop < hops) return true;
+  s.running = false;
+  sm_publish(s);
+  return false;
+}
+
+bool sm_build(const int16_t* samples, uint32_t frames, uint8_t channels, uint32_t sample_rate_hz) {
+  sm_begin(samples, frames, channels, sample_rate_hz);
+  while (sm_poll()) {}
+  return sm_current() != nullptr;
+}
+
+// ── Readout ─────────────────────────────────────────────────────────────────
+const SliceMap* sm_current(void) {
+  return s_published;
+}
+
+uint32_t sm_generation(void) {
+  return s_generation;
+}
+
+void sm_set_slice_mode(bool on) {
+  s_slice_mode = on;
+}
+
+bool sm_slice_mode(void) {
+  return s_slice_mode;
+}
@@ -0,0 +1,109 @@
+/**
+ * @file slice_map.h
+ * @brief Onset slice map of the loaded sample and slice playback
+ *
+ * After a sample loads, core 1 scans it for transients and publishes a table
+ * of up to SM_MAX_SLICES onset positions. In slice mode (SM_SLICE_MODE or
+ * sm_set_slice_mode()) the loop start knob selects a slice instead of a free
+ * position. The length knob selects how many slices the loop spans, and a
+ * reset trigger restarts the loop on the selected slice's onset sample.
+ *
+ * ## Detection
+ *
+ * The sample is cut into SM_HOP-frame hops (L+R mid for stereo). Each hop's
+ * energy is taken in two bands: the signal itself, and its first difference,
+ * which favours the top end so a hat still shows over a kick's tail. A hop
+ * is an onset in a band when:
+ *
+ * - its energy flux (rise over the loudest of the previous four hops, which
+ *   rides over the ripple of low tones) is a local peak,
+ * - it rose to at least 1.5x that reference, and
+ * - the flux is SM_FLUX_RATIO times the mean flux of the last SM_FLUX_WINDOW
+ *   hops, above SM_FLUX_FLOOR.
+ *
+ * The onset is then refined to the sample on the band that found it. A
+ * 16-frame peak envelope is walked back from the attack's maximum to where
+ * it first holds a quarter of it. From there the position steps back (at
+ * most 16 frames) to the foot of the attack. Candidates closer than
+ * SM_MIN_GAP_MS keep the stronger one. Beyond SM_MAX_SLICES the weakest are
+ * dropped. Slice 0 always starts at frame 0.
+ *
+ * ## Threading
+ *
+ * storage_load_sample_q15_psram() withdraws the old map before it frees the
+ * buffer, then starts a new analysis and returns at once. sm_poll(), called
+ * from loop1(), scans SM_POLL_FRAMES frames per call, so the UI keeps
+ * running. When the scan ends the finished table is published with a single
+ * pointer store. The renderer reads that pointer once per block, and a map
+ * only counts if it names the buffer being played. The two tables
+ * alternate, so the one being written is never the one last published.
+ *
+ * @author Brian Varren
+ * @version 1.0
+ * @date 2025
+ */
+
+#pragma once
+#include <stdint.h>
+
+// ── Configuration ───────────────────────────────────────────────────────────
+#ifndef SM_SLICE_MODE
+#define SM_SLICE_MODE      0        // 1 = start knob selects slices at boot
+#endif
+#define SM_MAX_SLICES      64u      // Slices per sample, including the one at frame 0
+#define SM_HOP             256u     // Frames per energy hop (5.3 ms at 48 kHz)
+#define SM_FLUX_WINDOW     16u      // Hops in the adaptive flux mean
+#define SM_FLUX_RATIO      2u       // Flux must exceed this many times the mean
+#define SM_FLUX_FLOOR      4096u    // Minimum flux (a -48 dBFS hop, in hop energy units)
+#define SM_MIN_GAP_MS      50u      // Closest two onsets may be
+#define SM_POLL_FRAMES     8192u    // Frames scanned per sm_poll() call
+
+struct SliceMap {
+  const int16_t* samples;          // Buffer the map was built from
+  uint32_t frames;                 // Its frame count
+  uint8_t  channels;
+  uint32_t count;                  // Slices (1..SM_MAX_SLICES)
+  uint32_t pos[SM_MAX_SLICES];     // Onset frames, ascending; pos[0] = 0
+};
+
+// ── Analysis (core 1) ───────────────────────────────────────────────────────
+
+/**
+ * @brief Withdraw the published map and stop any analysis in progress
+ *
+ * Call before the buffer the map describes is freed.
+ */
+void sm_cancel(void);
+
+/**
+ * @brief Start analysing a freshly loaded buffer (returns immediately)
+ */
+void sm_begin(const int16_t* samples, uint32_t frames, uint8_t channels, uint32_t sample_rate_hz);
+
+/**
+ * @brief Scan the next SM_POLL_FRAMES frames; publishes the map when done
+ * @return true while an analysis is still running
+ */
+bool sm_poll(void);
+
+/**
+ * @brief Begin and poll to completion (host harness, tools)
+ */
+bool sm_build(const int16_t* samples, uint32_t frames, uint8_t channels, uint32_t sample_rate_hz);
+
+// ── Readout (any core) ──────────────────────────────────────────────────────
+
+/**
+ * @brief Published map, or nullptr while none is ready
+ *
+ * The map stays intact at least until the next sm_begin() finishes a scan.
+ */
+const SliceMap* sm_current(void);
+
+/**
+ * @brief Counter bumped every time a map is published or withdrawn
+ */
+uint32_t sm_generation(void);
+
+void sm_set_slice_mode(bool on);
+bool sm_slice_mode(void);
@@ -0,0 +1,234 @@
+/**
+ * @file stereo_delay.cpp
+ * @brief Delay lines in PSRAM, their block transfers and the tap loop
+ *
+ * @author Brian Varren
+ * @version 1.0
+ * @date 2025
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include <hardware/sync.h>
+#include <Arduino.h>   // pmalloc()
+#include "stereo_delay.h"
+#include "fx_chain.h"
+#include "interp_kernel.h"
+#include "tempo_clock.h"
+#include "psram_copy.h"
+
+#define DLY_MAX_RUNS  6u               // Two lines x (write + a window split at the line end)
+static_assert(DLY_MAX_RUNS <= PC_MAX_RUNS, "a block's transfers must fit one run list");
+
+// ── State ───────────────────────────────────────────────────────────────────
+// Core 1 allocates the ring once and posts the settings. The render owns
+// everything else.
+static int16_t* volatile s_ring = nullptr;     // Left line, then right (s_len frames each)
+static uint32_t s_len = 0;                     // Frames per line, a multiple of the block
+static volatile uint32_t s_time_ms = DLY_TIME_MS;
+static volatile bool s_sync = DLY_SYNC;
+static volatile int16_t s_feedback = DLY_FEEDBACK_Q15;
+static volatile int16_t s_mix = DLY_MIX_Q15;
+
+static uint32_t s_wp = 0;                      // Line frame the next block is written to
+static uint32_t s_fresh = 0;                   // Frames written since the start (up to s_len)
+static int64_t s_d_q16 = 0;                    // Delay at the start of the planned block
+static int32_t s_pos_q16 = 0;                  // Planned block's first tap in its window
+static int32_t s_inc_q16 = 0;
+static bool s_planned = false;                 // Last block planned this one and fetched its windows
+static float s_lfo = 0.0f;                     // LFO phase (cycles)
+
+static dly_stats_t s_stats;
+static PsramCopy s_copy;                       // A block's transfers, both lines
+
+void dly_init(void) {
+  pc_init(&s_copy);
+  memset(&s_stats, 0, sizeof(s_stats));
+#if DLY_ENABLED
+  dly_set_enabled(true);
+#endif
+}
+
+// ── Delay Time ──────────────────────────────────────────────────────────────
+
+// Where the delay is heading at the end of the next block (Q16 frames)
+static int64_t dly_target_q16(float sample_rate, uint32_t n) {
+  float frames = (float)s_time_ms * sample_rate * 0.001f;
+  if (s_sync && tc_locked()) {
+    const uint32_t div = tc_division_samples()[DLY_SYNC_DIV];
+    if (div) frames = (float)div;
+  }
+  const float longest = (float)DLY_MAX_MS * sample_rate * 0.001f;
+  while (frames > longest) frames *= 0.5f;
+
+  s_lfo += (float)n * DLY_MOD_HZ / sample_rate;
+  if (s_lfo >= 1.0f) s_lfo -= 1.0f;
+  frames += DLY_MOD_MS * sample_rate * 0.001f * sinf(6.28318531f * s_lfo);
+
+  // Reads stay behind the block being written and within the line
+  const float lo = (float)DLY_WIN_FRAMES;
+  const float hi = (float)(s_len - DLY_WIN_FRAMES - n);
+  if (frames < lo) frames = lo;
+  if (frames > hi) frames = hi;
+  return (int64_t)(frames * 65536.0f);
+}
+
+// Ramp from s_d_q16 towards target over n samples. Returns how many frames
+// before the block's first written frame its read window starts.
+static uint32_t dly_plan(int64_t target_q16, uint32_t n) {
+  const int64_t d0 = s_d_q16;
+  const int64_t max_step = ((int64_t)DLY_SLEW_FRAMES << 16) / n;
+  int64_t step = (target_q16 - d0) / (int64_t)n;
+  if (step > max_step) step = max_step;
+  if (step < -max_step) step = -max_step;
+
+  // Window from the tap before the first one: delay d0 puts sample 0 at
+  // -d0 frames, so the window starts ceil(d0) + 1 frames back
+  const uint32_t back = (uint32_t)((d0 + 0xFFFF) >> 16) + 1u;
+  s_pos_q16 = (int32_t)(((int64_t)back << 16) - d0);
+  s_inc_q16 = (int32_t)(65536 - step);
+  s_d_q16 = d0 + step * (int64_t)n;
+  return back;
+}
+
+// ── Render ──────────────────────────────────────────────────────────────────
+bool dly_update(float sample_rate, DlyBlockParams* out) {
+  if (!s_ring) return false;
+  if (pc_wait(&s_copy)) ++s_stats.stalls;
+  out->fresh = !s_planned;
+  if (!s_planned) {
+    // Starting: the line counts as empty and the delay jumps to its target
+    s_fresh = 0;
+    s_d_q16 = dly_target_q16(sample_rate, AUDIO_BLOCK_SIZE);
+    dly_plan(s_d_q16, AUDIO_BLOCK_SIZE);
+  }
+  s_planned = false;
+  out->pos_q16 = s_pos_q16;
+  out->inc_q16 = s_inc_q16;
+  out->feedback_q15 = s_feedback;
+  out->mix_q15 = s_mix;
+  out->tone = adc_to_ladder_coefficient(DLY_TONE_Q12);
+  ++s_stats.blocks;
+  return true;
+}
+
+static inline int16_t dly_sat16(int32_t v) {
+  if (v > 32767) v = 32767;
+  if (v < -32768) v = -32768;
+  return (int16_t)v;
+}
+
+void DelayLine::reset() {
+  tone.reset();
+  memset(window, 0, sizeof(window));
+  memset(staged, 0, sizeof(staged));
+  ran = false;
+  s_planned = false;  // The slot stopped: the next block starts the line over
+}
+
+void DelayLine::process_block(int16_t* buf, uint32_t n, const DlyBlockParams& p) {
+  if (p.fresh) memset(window, 0, sizeof(window));
+  int32_t pos = p.pos_q16;
+  for (uint32_t i = 0; i < n; ++i) {
+    const int32_t wet = interp_hermite4(window + (pos >> 16), (uint32_t)(pos & 0xFFFF) << 16);
+    const int32_t echo = tone.process((int16_t)wet, p.tone);
+    const int32_t in = buf[i];
+    staged[i] = dly_sat16(in + ((echo * p.feedback_q15) >> 15));
+    buf[i] = dly_sat16(in + ((wet * p.mix_q15) >> 15));
+    pos += p.inc_q16;
+  }
+  ran = true;
+}
+
+void dly_end_block(DelayLine* l, DelayLine* r, uint32_t n, float sample_rate) {
+  if (!r->ran) memcpy(r->staged, l->staged, n * sizeof(int16_t));
+  l->ran = r->ran = false;
+
+  const uint32_t len = s_len;
+  const uint32_t w = s_wp;
+  s_wp = (w + n) % len;
+  s_fresh = (s_fresh + n < len) ? s_fresh + n : len;
+
+  // Next block's window; frames older than the start read as silence
+  const uint32_t back = dly_plan(dly_target_q16(sample_rate, n), n);
+  uint32_t zero = (back > s_fresh) ? back - s_fresh : 0u;
+  if (zero > DLY_WIN_FRAMES) zero = DLY_WIN_FRAMES;
+  const uint32_t from = (s_wp + len - back + zero) % len;
+  const uint32_t count = DLY_WIN_FRAMES - zero;
+  const uint32_t first = (from + count <= len) ? count : len - from;
+
+  DelayLine* const lines[2] = {l, r};
+  for (uint32_t c = 0; c < 2u; ++c) {
+    int16_t* const line = s_ring + c * len;
+    int16_t* const win = lines[c]->window;
+    memset(win, 0, zero * sizeof(int16_t));
+    pc_add(&s_copy, lines[c]->staged, line + w, n);  // Written first: the window can reach it
+    pc_add(&s_copy, line + from, win + zero, first);
+    pc_add(&s_copy, line, win + zero + first, count - first);
+  }
+  pc_start(&s_copy);
+  s_planned = true;
+}
+
+// ── Control ─────────────────────────────────────────────────────────────────
+bool dly_set_enabled(bool on) {
+  const int slot = fx_find_slot("delay");
+  if (slot < 0) return false;
+  if (on && !s_ring) {
+    const uint32_t n = AUDIO_BLOCK_SIZE;
+    const uint32_t longest = (uint32_t)(audio_rate * ((float)DLY_MAX_MS + DLY_MOD_MS) * 0.001f) + 1u;
+    const uint32_t len = (longest + DLY_WIN_FRAMES + 2u * n + n - 1u) / n * n;
+#ifdef ARDUINO_ARCH_RP2040
+    int16_t* ring = (int16_t*)pmalloc(2u * len * sizeof(int16_t));
+#else
+    int16_t* ring = (int16_t*)malloc(2u * len * sizeof(int16_t));
+#endif
+    if (!ring) return false;
+    s_len = len;
+    __compiler_memory_barrier();  // Length before the ring is seen
+    s_ring = ring;
+  }
+  fx_set_enabled((uint32_t)slot, on);
+  return true;
+}
+
+void dly_set_time_ms(uint32_t ms) {
+  if (ms < 1u) ms = 1u;
+  if (ms > DLY_MAX_MS) ms = DLY_MAX_MS;
+  s_time_ms = ms;
+}
+
+void dly_set_sync(bool on) {
+  s_sync = on;
+}
+
+void dly_set_feedback_q15(int16_t feedback) {
+  s_feedback = (feedback < 0) ? 0 : feedback;
+}
+
+void dly_set_mix_q15(int16_t mix) {
+  s_mix = (mix < 0) ? 0 : mix;
+}
+
+void dly_serial_command(char c) {
+  if (c == 'D') dly_set_enabled(!dly_enabled());
+  else if (c == 'T') dly_set_sync(!s_sync);
+}
+
+bool dly_enabled(void) {
+  const int slot = fx_find_slot("delay");
+  return s_ring && slot >= 0 && fx_enabled((uint32_t)slot);
+}
+
+bool dly_sync(void) {
+  return s_sync;
+}
+
+uint32_t dly_time_ms(void) {
+  return s_time_ms;
+}
+
+void dly_get_stats(dly_stats_t* out) {
+  *out = s_stats;
+}
@@ -0,0 +1,166 @@
+/**
+ * @file stereo_delay.h
+ * @brief Tempo-syncable stereo delay with its lines in PSRAM
+ *
+ * The delay is the last slot of the effects chain (fx_chain.h). Each channel
+ * has its own line in PSRAM, next to the sample buffer. Echoes go back into
+ * the line through a Ladder8PoleLowpassFilter, so every repeat is darker
+ * than the one before.
+ *
+ * ## Block Transfers
+ *
+ * The render never touches PSRAM. Each line has two SRAM staging buffers:
+ *
+ * - the block written: the input plus the filtered feedback, n frames
+ * - the read window: the DLY_WIN_FRAMES frames the next block's taps can
+ *   reach
+ *
+ * At the end of each block the delay works out the next block's delay-time
+ * trajectory, then starts one DMA run list (psram_copy.h) that writes the
+ * block to the line and reads the next window into SRAM. The list has two
+ * runs per line, or three when the window wraps at the line end. The next block waits for
+ * the list before its first sample. That wait is counted as a stall. A
+ * 16-sample block moves about 90 bytes per line, so in practice the list is
+ * done long before then. Reading the block ahead is why the delay can never
+ * be shorter than the window (DLY_WIN_FRAMES).
+ *
+ * ## Delay Time
+ *
+ * The time is DLY_TIME_MS, or with sync on and the tempo clock locked
+ * (tempo_clock.h), the clock's DLY_SYNC_DIV division, halved until it fits
+ * in DLY_MAX_MS. A sine LFO of DLY_MOD_MS at DLY_MOD_HZ is added to it.
+ * Over a block the delay ramps linearly from its last value towards that
+ * target, by at most DLY_SLEW_FRAMES. Taps are read at fractional positions
+ * with the voices' Hermite interpolator (interp_kernel.h). A time change is
+ * therefore heard as a short, bounded pitch bend, never as a click.
+ *
+ * When the slot starts (or comes back after a bypass), the line counts as
+ * empty. Reads older than what has been written since return silence.
+ *
+ * ## Control
+ *
+ * The ring is allocated on the first dly_set_enabled(true) and kept after
+ * that. It is DLY_MAX_MS long per channel, plus a window. The delay is off
+ * at boot unless DLY_ENABLED is set. Over serial, 'D' toggles it and 'T'
+ * toggles tempo sync. A mono sample runs the left line only, and the right
+ * line copies it, so it is primed when a stereo sample loads.
+ *
+ * @author Brian Varren
+ * @version 1.0
+ * @date 2025
+ */
+
+#pragma once
+#include <stdint.h>
+#include "DACless.h"
+#include "ladder_filter.h"
+
+// ── Configuration ───────────────────────────────────────────────────────────
+#ifndef DLY_ENABLED
+#define DLY_ENABLED         0          // 1 = allocate and switch the delay on at boot
+#endif
+#ifndef DLY_MAX_MS
+#define DLY_MAX_MS          2000u      // Longest delay (PSRAM per channel)
+#endif
+#ifndef DLY_TIME_MS
+#define DLY_TIME_MS         375u       // Free-running delay time
+#endif
+#ifndef DLY_SYNC
+#define DLY_SYNC            1          // Follow the tempo clock when it is locked
+#endif
+#define DLY_SYNC_DIV        1u         // tc_division_samples() entry (1 = eighth note)
+#define DLY_FEEDBACK_Q15    14746      // Echo back into the line (0.45)
+#define DLY_MIX_Q15         16384      // Wet level added to the dry signal (0.5)
+#define DLY_TONE_Q12        3000u      // Feedback lowpass, as an FX1-style knob value
+#define DLY_MOD_MS          1.0f       // LFO depth on the delay time
+#define DLY_MOD_HZ          0.5f       // LFO rate
+#define DLY_SLEW_FRAMES     (AUDIO_BLOCK_SIZE / 2u)  // Largest delay change per block (+-50% pitch)
+#define DLY_WIN_FRAMES      (AUDIO_BLOCK_SIZE + DLY_SLEW_FRAMES + 4u)  // Read window per block
+
+/**
+ * @brief What the lines do this block (from dly_update())
+ */
+struct DlyBlockParams {
+  int32_t  pos_q16;           // First tap, Q16 frames into the read window
+  int32_t  inc_q16;           // Tap step per sample (1 - delay change per sample)
+  int16_t  feedback_q15;
+  int16_t  mix_q15;
+  uint16_t tone;              // Ladder8PoleLowpassFilter coefficient
+  bool     fresh;             // First block after a start: the window is empty
+};
+
+// ── Setup ───────────────────────────────────────────────────────────────────
+
+/**
+ * @brief Claim the DMA channels; allocate and enable if DLY_ENABLED (from audio_init())
+ */
+void dly_init(void);
+
+// ── Render (core 0) ─────────────────────────────────────────────────────────
+
+/**
+ * @brief Wait for the last block's transfers and take this block's parameters
+ * @return false when the delay has no line to play
+ */
+bool dly_update(float sample_rate, DlyBlockParams* out);
+
+/**
+ * @class DelayLine
+ * @brief One channel's staging buffers and feedback filter
+ */
+class DelayLine {
+public:
+  DelayLine() { reset(); }
+
+  /**
+   * @brief Add the echoes to n Q15 samples in place, and stage the line's input
+   */
+  void process_block(int16_t* buf, uint32_t n, const DlyBlockParams& p);
+
+  /**
+   * @brief Clear the filter and the staging buffers
+   */
+  void reset();
+
+private:
+  friend void dly_end_block(DelayLine* l, DelayLine* r, uint32_t n, float sample_rate);
+
+  Ladder8PoleLowpassFilter tone;
+  int16_t window[DLY_WIN_FRAMES] __attribute__((aligned(4)));   // Filled by DMA
+  int16_t staged[AUDIO_BLOCK_SIZE] __attribute__((aligned(4))); // Copied to the line by DMA
+  bool ran;                                                      // Processed this block
+};
+
+/**
+ * @brief Plan the next block and start the line transfers (once per block)
+ * @param r Right line; a mono block (r not run) copies the left one into it
+ */
+void dly_end_block(DelayLine* l, DelayLine* r, uint32_t n, float sample_rate);
+
+// ── Control (core 1) ────────────────────────────────────────────────────────
+
+/**
+ * @brief Switch the delay slot; the first call allocates the ring
+ * @return false if the ring could not be allocated
+ */
+bool dly_set_enabled(bool on);
+void dly_set_time_ms(uint32_t ms);
+void dly_set_sync(bool on);
+void dly_set_feedback_q15(int16_t feedback);
+void dly_set_mix_q15(int16_t mix);
+
+/**
+ * @brief Serial keys: 'D' toggles the delay, 'T' toggles tempo sync
+ */
+void dly_serial_command(char c);
+
+// ── Readout (any core) ──────────────────────────────────────────────────────
+typedef struct {
+  uint32_t blocks;            // Blocks the delay ran
+  uint32_t stalls;            // Blocks that waited on the line transfers
+} dly_stats_t;
+
+bool dly_enabled(void);
+bool dly_sync(void);
+uint32_t dly_time_ms(void);
+void dly_get_stats(dly_stats_t* out);
@@ -1,23 +1,134 @@
-#include <SdFat.h>
+#include <stdlib.h>
 #include <string.h>
+#ifdef ARDUINO_ARCH_RP2040
+#include <Arduino.h>   // pmalloc()
+#endif
 #include "audio_engine.h"
 #include "storage_loader.h"
 #include "storage_wav_meta.h"
-#include "driver_sh1122.h"
-#include "driver_sdcard.h"
 #include "sf_globals_bridge.h"
-#include "ui_display.h"
-
-extern SdFat sd;  // defined in storage_sd_hal.cpp
+#include "sample_mipmap.h"
+#include "sample_cache.h"
+#include "seam_cache.h"
+#include "zero_cross.h"
+#include "slice_map.h"
+#include "sample_stream.h"
 
 namespace sf {
 
+// ───────────────────────────── Buffer Lifetime ─────────────────────────────
+
+static uint32_t s_src_rate_hz = 0;  // Source rate of the published buffer
+static bool s_streaming = false;    // audioData is a stream window (sample_stream.h)
+
+// Drop everything derived from the current buffer: slice map, mip levels,
+// zero-crossing index and any SRAM copies of it. The render owns the SRAM
+// copies, so the engine must be unbound first.
+static void release_derived(void)
+{
+  sm_cancel();
+  mip_release();
+  zc_release(&g_zero_cross);
+  sc_invalidate();
+  seam_reset();
+}
+
+// Stop the engine reading the current buffer and wait out the block that
+// may still be playing it. Comes before the buffer or anything derived from
+// it is freed or rebuilt.
+static void unbind_buffer(void)
+{
+  if (audioData) playback_unbind_buffer();
+}
+
+// Free the current buffer (engine unbound)
+static void release_buffer(void)
+{
+  if (audioData && s_streaming) {
+    // The engine plays the window as the whole file - stop the reader
+    ss_close();
+    wav_stream_close();
+    s_streaming = false;
+  }
+  if (audioData) {
+    free(audioData);
+    audioData = nullptr;
+    audioDataSize = 0;
+    audioSampleCount = 0;
+    audioChannels = 1;
+  }
+}
+
+// Publish a filled buffer: globals, mip levels, engine binding, onset scan.
+// The zero-crossing index is the caller's (the loader builds it in decode).
+static void publish_buffer(uint8_t* buf, uint32_t bytes, uint8_t channels, uint32_t src_rate_hz)
+{
+  audioData        = buf;
+  audioDataSize    = bytes;
+  audioSampleCount = bytes / (2u * channels);
+  audioChannels    = channels;
+  s_src_rate_hz    = src_rate_hz;
+
+  // Band-limited octave copies for fast playback (best effort - level 0
+  // alone still plays if PSRAM is short)
+  mip_build((const int16_t*)audioData, audioSampleCount, channels);
+
+  // Your PWM/engine output rate. Replace with your symbol if different:
+  // e.g., DACless_get_sample_rate_hz(), AUDIO_OUT_RATE_HZ, or PWM_SAMPLE_RATE_HZ.
+  const uint32_t out_rate_hz = audio_rate;   // <-- use your project’s constant
+
+  // Tell the audio engine about the new PSRAM buffer and rates.
+  playback_bind_loaded_buffer(src_rate_hz, out_rate_hz, audioSampleCount, channels);
+
+  // Onset scan for slice mode; loop1() runs it via sm_poll() and it
+  // publishes the slice map when done, so the load returns now
+  sm_begin((const int16_t*)audioData, audioSampleCount, channels, src_rate_hz);
+}
+
+// Stream a file that does not fit: the largest window the free PSRAM allows
+// (less SS_PSRAM_RESERVE), read from the card around the playhead. The first
+// chunks double as the throughput probe. Nothing is derived from the file:
+// no mip levels, zero crossings or slice map.
+#ifdef ARDUINO_ARCH_RP2040
+static bool load_streamed(const char* path, const WavInfo& wi, uint32_t frames, uint8_t channels,
+                          uint8_t load_flags, float* out_mbps, uint32_t* out_bytes_read)
+{
+  const uint32_t free_bytes = rp2040.getFreePSRAMHeap();
+  const uint32_t budget = (free_bytes > SS_PSRAM_RESERVE) ? free_bytes - SS_PSRAM_RESERVE : 0u;
+  const uint32_t window_frames = ss_window_frames(budget, channels);
+  if (!window_frames) return false;
+  const uint32_t window_bytes = window_frames * 2u * channels;
+
+  int16_t* window = (int16_t*)pmalloc(window_bytes);
+  if (!window) return false;
+  if (!wav_stream_open(path, load_flags)) {
+    free(window);
+    return false;
+  }
+  if (!ss_open(window, window_frames, frames, channels, wav_stream_read, nullptr) ||
+      !ss_probe(wi.sampleRate)) {
+    ss_close();
+    wav_stream_close();
+    free(window);
+    return false;
+  }
+  ss_stats_t st;
+  ss_get_stats(&st);
+  storage_adopt_stream_q15_psram(window, window_frames, frames, channels, wi.sampleRate);
+
+  if (out_mbps)       *out_mbps = (float)((double)st.probe_fps * 2.0 * channels / (1024.0 * 1024.0));
+  if (out_bytes_read) *out_bytes_read = window_bytes;
+  return true;
+}
+#endif
+
 // ───────────────────────────── Orchestrator ─────────────────────────────
 
 bool storage_load_sample_q15_psram(const char* path,
                                    float* out_mbps,
                                    uint32_t* out_bytes_read,
-                                   uint32_t* out_required_bytes)
+                                   uint32_t* out_required_bytes,
+                                   uint8_t load_flags)
 {
   if (out_mbps)        *out_mbps = 0.0f;
   if (out_bytes_read)  *out_bytes_read = 0;
@@ -30,52 +141,45 @@ bool storage_load_sample_q15_psram(const char* path,
   if (bytes_per_in == 0) return false;
 
   const uint32_t total_input_samples = wi.dataSize / bytes_per_in;
-  const uint32_t required_out_bytes  = total_input_samples * 2u; // mono Q15
+  if (!AE_STEREO) load_flags &= (uint8_t)~SF_LOAD_STEREO;  // No stereo kernels to play it
+  const uint8_t channels = ((load_flags & SF_LOAD_STEREO) && wi.numChannels == 2) ? 2u : 1u;
+  const uint32_t required_out_bytes  = total_input_samples * 2u * channels; // Q15 mono or L/R frames
   if (out_required_bytes) *out_required_bytes = required_out_bytes;
 
-  // Optional headroom check
+  // Drop previous buffer (if any), its mip levels and any SRAM copies of it
+  storage_release_sample_q15_psram();
+
+  // Too large for the PSRAM left: stream it from the card
   #ifdef ARDUINO_ARCH_RP2040
   if (required_out_bytes > rp2040.getFreePSRAMHeap()) {
-    return false;
+    return load_streamed(path, wi, total_input_samples, channels, load_flags, out_mbps, out_bytes_read);
   }
   #endif
 
-  // Drop previous buffer (if any)
-  if (audioData) {
-    free(audioData);
-    audioData = nullptr;
-    audioDataSize = 0;
-    audioSampleCount = 0;
-  }
-
   // Allocate PSRAM
+  #ifdef ARDUINO_ARCH_RP2040
   uint8_t* buf = (uint8_t*)pmalloc(required_out_bytes);
+  #else
+  uint8_t* buf = (uint8_t*)malloc(required_out_bytes);
+  #endif
   if (!buf) return false;
 
-  // Decode into PSRAM
+  // Decode into PSRAM; the zero-crossing index is built alongside when
+  // there is room for it (best effort, like the mip levels)
   uint32_t written = 0;
   float mbps = 0.0f;
-  const bool ok = wav_decode_q15_into_buffer(path, (int16_t*)buf, required_out_bytes, &written, &mbps);
+  ZeroCrossIndex* zc = zc_begin(&g_zero_cross, total_input_samples) ? &g_zero_cross : nullptr;
+  const bool ok = wav_decode_q15_into_buffer(path, (int16_t*)buf, required_out_bytes, &written, &mbps, load_flags, zc);
 
   if (!ok || written != required_out_bytes) {
+    zc_release(&g_zero_cross);
     free(buf);
     return false;
   }
-
-  // Publish globals
-  audioData        = buf;
-  audioDataSize    = written;
-  audioSampleCount = written / 2u;
+  if (zc) zc_finish(zc);
 
   // Source (WAV) sample rate from WavInfo
-  const uint32_t src_rate_hz = wi.sampleRate;
-
-  // Your PWM/engine output rate. Replace with your symbol if different:
-  // e.g., DACless_get_sample_rate_hz(), AUDIO_OUT_RATE_HZ, or PWM_SAMPLE_RATE_HZ.
-  const uint32_t out_rate_hz = audio_rate;   // <-- use your project’s constant
-
-  // Tell the audio engine about the new PSRAM buffer and rates.
-  playback_bind_loaded_buffer(src_rate_hz, out_rate_hz, audioSampleCount);
+  publish_buffer(buf, written, channels, wi.sampleRate);
 
   if (out_mbps)       *out_mbps = mbps;
   if (out_bytes_read) *out_bytes_read = written;
@@ -83,4 +187,53 @@ bool storage_load_sample_q15_psram(const char* path,
   return true;
 }
 
+bool storage_adopt_sample_q15_psram(int16_t* samples, uint32_t frames, uint8_t channels, uint32_t src_rate_hz)
+{
+  if (!samples || frames < 2u || (channels != 1u && channels != 2u)) return false;
+  unbind_buffer();  // A take usually lands while the old loop plays
+  release_derived();
+  if ((uint8_t*)samples != audioData) release_buffer();
+  zc_build(&g_zero_cross, samples, frames, channels);  // Best effort, like the mip levels
+  publish_buffer((uint8_t*)samples, frames * 2u * channels, channels, src_rate_hz);
+  return true;
+}
+
+bool storage_adopt_stream_q15_psram(int16_t* window, uint32_t window_frames, uint32_t frames, uint8_t channels,
+                                    uint32_t src_rate_hz)
+{
+  if (!window || !window_frames || audioData || (channels != 1u && channels != 2u)) return false;
+  audioData        = (uint8_t*)window;
+  audioDataSize    = window_frames * 2u * channels;
+  audioSampleCount = window_frames;   // What the UI may read
+  audioChannels    = channels;
+  s_src_rate_hz    = src_rate_hz;
+  s_streaming      = true;
+  playback_bind_loaded_buffer(src_rate_hz, audio_rate, frames, channels);
+  return true;
+}
+
+void storage_release_sample_q15_psram(void)
+{
+  unbind_buffer();
+  release_derived();
+  release_buffer();
+}
+
+void storage_refresh_sample_q15_psram(void)
+{
+  if (!audioData || !audioSampleCount || s_streaming) return;
+  const int16_t* samples = (const int16_t*)audioData;
+  unbind_buffer();  // The render reads the mip levels and crossings rebuilt here
+  sm_cancel();
+  mip_build(samples, audioSampleCount, audioChannels);
+  zc_build(&g_zero_cross, samples, audioSampleCount, audioChannels);
+
+  // Only now drop the SRAM copies: the new levels may land where the old
+  // ones were, and a copy is matched by address and range alone
+  sc_invalidate();
+  seam_reset();
+  playback_bind_loaded_buffer(s_src_rate_hz, audio_rate, audioSampleCount, audioChannels);
+  sm_begin(samples, audioSampleCount, audioChannels, s_src_rate_hz);
+}
+
 } // namespace sf
@@ -9,15 +9,19 @@
  * ## Key Features
  * 
  * **Multi-format WAV Support**: Handles 8/16/24/32-bit PCM WAV files in
- * mono or stereo format. All files are converted to mono Q15 format for
- * consistent processing.
+ * mono or stereo format. Files are converted to mono Q15 by default; with
+ * SF_LOAD_STEREO a stereo file keeps both channels as interleaved Q15
+ * frames (L, R), which doubles its PSRAM footprint.
  * 
  * **Two-pass Normalization**: 
  * - Pass 1: Scans entire file to find peak amplitude
- * - Pass 2: Converts to mono, normalizes to -3dB, outputs as Q15
+ * - Pass 2: Converts to mono (or keeps L/R), normalizes to -3dB, outputs as Q15
+ *   and indexes the rising zero crossings (zero_cross.h) as it goes
  * 
  * **PSRAM Integration**: Automatically allocates PSRAM buffers for large
- * samples and manages memory efficiently.
+ * samples and manages memory efficiently. A file larger than the free PSRAM
+ * streams from the card instead (sample_stream.h): the loader allocates a
+ * window and checks the card can keep it filled.
  * 
  * **File Indexing**: Scans SD card for WAV files and maintains an index
  * for fast browsing and selection.
@@ -27,9 +31,10 @@
  * 1. **File Discovery**: Scan SD card for *.wav files (case-insensitive)
  * 2. **Metadata Extraction**: Read WAV headers to get sample rate, bit depth, channels
  * 3. **Peak Detection**: First pass to find maximum amplitude for normalization
- * 4. **Conversion**: Second pass converts to mono Q15 with -3dB normalization
+ * 4. **Conversion**: Second pass converts to mono (or stereo) Q15 with -3dB normalization
  * 5. **PSRAM Storage**: Allocates PSRAM buffer and stores converted samples
  * 6. **Engine Binding**: Binds sample to audio engine for playback
+ * 7. **Onset Scan**: Core 1 builds the slice map afterwards (slice_map.h)
  * 
  * @author Brian Varren
  * @version 1.0
@@ -39,6 +44,15 @@
 #pragma once
 #include <stdint.h>
 
+struct ZeroCrossIndex;
+
+// ── Load flags ──────────────────────────────────────────────────────────────
+#define SF_LOAD_STEREO  0x01u   // Keep stereo files as interleaved L/R Q15 (2x PSRAM)
+
+#ifndef STORAGE_LOAD_FLAGS
+#define STORAGE_LOAD_FLAGS  0u  // Flags the browser loads with
+#endif
+
 namespace sf {
 
 constexpr int MAX_WAV_FILES   = 100;
@@ -77,20 +91,66 @@ const char* file_index_get(const FileIndex& idx, int i);
 
 // Pure decode: WAV (8/16/24/32-bit PCM, mono/stereo) → mono Q15 into caller buffer.
 // - No allocation, no globals, no printing.
-// - dst_q15 capacity (dst_bytes) must be >= required size (2 * total_samples).
+// - With SF_LOAD_STEREO in load_flags a stereo file is written as interleaved
+//   L/R frames instead, normalized by the louder channel so the image holds.
+// - dst_q15 capacity (dst_bytes) must be >= required size (2 * frames * channels out).
+// - With zc (already zc_begin()'d for the frame count) pass 2 also feeds every
+//   decoded chunk to the zero-crossing index; the caller zc_finish()es it.
 // Returns true on success. Writes bytes written and MB/s (overall decode throughput).
 bool wav_decode_q15_into_buffer(const char* path,
                                 int16_t* dst_q15,
                                 uint32_t dst_bytes,
                                 uint32_t* out_bytes_written,
-                                float* out_mbps);
+                                float* out_mbps,
+                                uint8_t load_flags = 0u,
+                                ZeroCrossIndex* zc = nullptr);
+
+// Streaming reader for files larger than PSRAM (sample_stream.h):
+// - wav_stream_open() keeps the file open; wav_stream_read() is the
+//   ss_read_fn, decoding frames to Q15 as the loader would, but without the
+//   peak pass (the file plays at its own level).
+bool wav_stream_open(const char* path, uint8_t load_flags = 0u);
+bool wav_stream_read(void* user, uint32_t frame, int16_t* dst, uint32_t frames);
+void wav_stream_close(void);
 
 // High level orchestrator: allocates PSRAM, decodes, and publishes globals.
-// - Computes required bytes, checks PSRAM, pmallocs, decodes, sets audioData/audioSampleCount.
+// - Computes required bytes, checks PSRAM, pmallocs, decodes, sets
+//   audioData/audioSampleCount (frames) and audioChannels.
+// - Starts the onset scan (sm_begin()) without waiting for it.
+// - When the file does not fit, streams it instead: audioData is then the
+//   PSRAM window and audioSampleCount its frames, while the engine is bound
+//   to the whole file. out_mbps is the card throughput measured by
+//   ss_probe(); a card too slow to stream fails the load.
 // - On failure, frees any allocation and returns false.
 bool storage_load_sample_q15_psram(const char* path,
                                    float* out_mbps,
                                    uint32_t* out_bytes_read,
-                                   uint32_t* out_required_bytes);
+                                   uint32_t* out_required_bytes,
+                                   uint8_t load_flags = STORAGE_LOAD_FLAGS);
+
+// Publish a Q15 buffer filled elsewhere (a recorder take) as the loaded sample.
+// - Takes ownership of `samples` (PSRAM, freed like a loaded file's buffer)
+//   and frees the previous buffer.
+// - Builds the zero-crossing index and mip levels, binds the engine and
+//   starts the onset scan, as the loader does.
+bool storage_adopt_sample_q15_psram(int16_t* samples, uint32_t frames, uint8_t channels, uint32_t src_rate_hz);
+
+// Publish a stream window (sample_stream.h) as the loaded sample, bound to
+// the whole file of `frames` frames. The stream is already ss_open()ed over
+// `window` and nothing may be loaded (storage_release_sample_q15_psram()).
+// - Takes ownership of `window` and of the stream: the next release closes
+//   both, with wav_stream_close().
+// - Derives nothing from it (no mip levels, zero crossings or slice map).
+bool storage_adopt_stream_q15_psram(int16_t* window, uint32_t window_frames, uint32_t frames, uint8_t channels,
+                                    uint32_t src_rate_hz);
+
+// Unbind the engine, then free the loaded buffer and everything derived
+// from it, closing the stream if it is one. audioData is null afterwards.
+void storage_release_sample_q15_psram(void);
+
+// Rebuild what is derived from the loaded buffer after it was written in
+// place (overdub): mip levels, zero-crossing index, SRAM copies and slice
+// map. The engine is unbound while they are rebuilt (a gap of silence).
+void storage_refresh_sample_q15_psram(void);
 
 } // namespace sf
@@ -2,6 +2,7 @@
 #include <string.h>
 #include "storage_loader.h"
 #include "storage_wav_meta.h"
+#include "zero_cross.h"
 
 extern SdFat sd;  // provided by SD HAL
 
@@ -14,11 +15,45 @@ static inline int32_t le24_to_i32(const uint8_t* p) {
   return v;
 }
 
+// Utility: -1..+1 float to Q15, rounded and clamped
+static inline int16_t q15_from_float(float v) {
+  float s = v * 32767.0f;
+  int32_t q = (int32_t)(s + (s >= 0 ? 0.5f : -0.5f));
+  if (q >  32767) q =  32767;
+  if (q < -32768) q = -32768;
+  return (int16_t)q;
+}
+
+// Utility: one PCM input frame at p as -1..+1 floats (rch = 0 for mono); advances p
+static inline void decode_frame(const uint8_t*& p, int ch, int bps, float& l, float& rch) {
+  l = 0.0f;
+  rch = 0.0f;
+  if (bps == 8) {
+    uint8_t a = *p++; l = ((int)a - 128) / 128.0f;
+    if (ch == 2) { uint8_t b = *p++; rch = ((int)b - 128) / 128.0f; }
+  } else if (bps == 16) {
+    int16_t a = (int16_t)(p[0] | (p[1] << 8)); p += 2; l = (float)a / 32768.0f;
+    if (ch == 2) { int16_t b = (int16_t)(p[0] | (p[1] << 8)); p += 2; rch = (float)b / 32768.0f; }
+  } else if (bps == 24) {
+    int32_t a = le24_to_i32(p); p += 3; l = (float)a / 8388608.0f;
+    if (ch == 2) { int32_t b = le24_to_i32(p); p += 3; rch = (float)b / 8388608.0f; }
+  } else {
+    int32_t a = (int32_t)(p[0] | (p[1] << 8) | (p[2] << 16) | (p[3] << 24)); p += 4; l = (float)a / 2147483648.0f;
+    if (ch == 2) { int32_t b = (int32_t)(p[0] | (p[1] << 8) | (p[2] << 16) | (p[3] << 24)); p += 4; rch = (float)b / 2147483648.0f; }
+  }
+}
+
+// Raw read buffer, shared by the loader and the stream reader (both core 1)
+static const uint32_t CHUNK_RAW = 8192;
+static uint8_t chunk_buf[CHUNK_RAW];
+
 bool wav_decode_q15_into_buffer(const char* path,
                                 int16_t* dst_q15,
                                 uint32_t dst_bytes,
                                 uint32_t* out_bytes_written,
-                                float* out_mbps)
+                                float* out_mbps,
+                                uint8_t load_flags,
+                                ZeroCrossIndex* zc)
 {
   if (out_bytes_written) *out_bytes_written = 0;
   if (out_mbps)          *out_mbps = 0.0f;
@@ -33,18 +68,15 @@ bool wav_decode_q15_into_buffer(const char* path,
   const uint32_t bytes_per_in = (wi.bitsPerSample / 8u) * (uint32_t)wi.numChannels;
   if (bytes_per_in == 0) return false;
 
-  const uint32_t total_input_samples = wi.dataSize / bytes_per_in;   // after downmix
-  const uint32_t required_out_bytes  = total_input_samples * 2u;     // Q15 mono
+  const uint32_t total_input_samples = wi.dataSize / bytes_per_in;   // frames
+  const bool stereo_out = (load_flags & SF_LOAD_STEREO) && wi.numChannels == 2;
+  const uint32_t required_out_bytes  = total_input_samples * (stereo_out ? 4u : 2u);  // Q15 mono or L/R
   if (dst_bytes < required_out_bytes) return false;
 
   FsFile f = sd.open(path, O_RDONLY);
   if (!f) return false;
 
-  // Chunk buffer
-  static const uint32_t CHUNK_RAW = 8192;
-  static uint8_t  chunk_buf[CHUNK_RAW];
-
-  // Pass 1: find peak after downmix
+  // Pass 1: find peak after downmix (of either channel when kept stereo)
   float peak = 0.0f;
   {
     f.seekSet(wi.dataOffset);
@@ -61,22 +93,15 @@ bool wav_decode_q15_into_buffer(const char* path,
       const int bps = wi.bitsPerSample;
       const uint8_t* p = chunk_buf;
       for (uint32_t i = 0; i < frames; ++i) {
-        float l = 0.0f, rch = 0.0f;
-        if (bps == 8) {
-          uint8_t a = *p++; l = ((int)a - 128) / 128.0f;
-          if (ch == 2) { uint8_t b = *p++; rch = ((int)b - 128) / 128.0f; }
-        } else if (bps == 16) {
-          int16_t a = (int16_t)(p[0] | (p[1] << 8)); p += 2; l = (float)a / 32768.0f;
-          if (ch == 2) { int16_t b = (int16_t)(p[0] | (p[1] << 8)); p += 2; rch = (float)b / 32768.0f; }
-        } else if (bps == 24) {
-          int32_t a = le24_to_i32(p); p += 3; l = (float)a / 8388608.0f;
-          if (ch == 2) { int32_t b = le24_to_i32(p); p += 3; rch = (float)b / 8388608.0f; }
+        float l, rch;
+        decode_frame(p, ch, bps, l, rch);
+        if (stereo_out) {
+          float rabs = rch >= 0.0f ? rch : -rch;
+          if (rabs > peak) peak = rabs;
         } else {
-          int32_t a = (int32_t)(p[0] | (p[1] << 8) | (p[2] << 16) | (p[3] << 24)); p += 4; l = (float)a / 2147483648.0f;
-          if (ch == 2) { int32_t b = (int32_t)(p[0] | (p[1] << 8) | (p[2] << 16) | (p[3] << 24)); p += 4; rch = (float)b / 2147483648.0f; }
+          l = (ch == 2) ? 0.5f * (l + rch) : l;
         }
-        float mono = (ch == 2) ? 0.5f * (l + rch) : l;
-        float aabs = mono >= 0.0f ? mono : -mono;
+        float aabs = l >= 0.0f ? l : -l;
         if (aabs > peak) peak = aabs;
       }
       remaining -= (uint32_t)r;
@@ -91,7 +116,8 @@ bool wav_decode_q15_into_buffer(const char* path,
     gain = (g > 1.0f) ? 1.0f : g;
   }
 
-  // Pass 2: decode into Q15 with gain, measure throughput
+  // Pass 2: decode into Q15 with gain, measure throughput (and index the
+  // zero crossings of each chunk while it is still in cache)
   uint32_t written_bytes = 0;
   uint32_t t0 = millis();
   {
@@ -109,28 +135,19 @@ bool wav_decode_q15_into_buffer(const char* path,
       const int ch = wi.numChannels;
       const int bps = wi.bitsPerSample;
       const uint8_t* p = chunk_buf;
+      const uint32_t chunk_start = out_index;
       for (uint32_t i = 0; i < frames; ++i) {
-        float l = 0.0f, rch = 0.0f;
-        if (bps == 8) {
-          uint8_t a = *p++; l = ((int)a - 128) / 128.0f;
-          if (ch == 2) { uint8_t b = *p++; rch = ((int)b - 128) / 128.0f; }
-        } else if (bps == 16) {
-          int16_t a = (int16_t)(p[0] | (p[1] << 8)); p += 2; l = (float)a / 32768.0f;
-          if (ch == 2) { int16_t b = (int16_t)(p[0] | (p[1] << 8)); p += 2; rch = (float)b / 32768.0f; }
-        } else if (bps == 24) {
-          int32_t a = le24_to_i32(p); p += 3; l = (float)a / 8388608.0f;
-          if (ch == 2) { int32_t b = le24_to_i32(p); p += 3; rch = (float)b / 8388608.0f; }
+        float l, rch;
+        decode_frame(p, ch, bps, l, rch);
+        if (stereo_out) {
+          dst_q15[out_index++] = q15_from_float(l * gain);
+          dst_q15[out_index++] = q15_from_float(rch * gain);
         } else {
-          int32_t a = (int32_t)(p[0] | (p[1] << 8) | (p[2] << 16) | (p[3] << 24)); p += 4; l = (float)a / 2147483648.0f;
-          if (ch == 2) { int32_t b = (int32_t)(p[0] | (p[1] << 8) | (p[2] << 16) | (p[3] << 24)); p += 4; rch = (float)b / 2147483648.0f; }
+          float mono = (ch == 2) ? 0.5f * (l + rch) : l;
+          dst_q15[out_index++] = q15_from_float(mono * gain);
         }
-        float mono = (ch == 2) ? 0.5f * (l + rch) : l;
-        float s = mono * gain * 32767.0f;
-        int32_t q = (int32_t)(s + (s >= 0 ? 0.5f : -0.5f));
-        if (q >  32767) q =  32767;
-        if (q < -32768) q = -32768;
-        dst_q15[out_index++] = (int16_t)q;
       }
+      if (zc) zc_feed(zc, dst_q15 + chunk_start, frames, stereo_out ? 2u : 1u);
       written_bytes = out_index * 2u;
       remaining -= (uint32_t)r;
     }
@@ -149,6 +166,62 @@ bool wav_decode_q15_into_buffer(const char* path,
   return (written_bytes == required_out_bytes);
 }
 
+// ───────────────────────────── Streaming ─────────────────────────────
+// A file too large for PSRAM is read a chunk at a time (sample_stream.h).
+// There is no peak pass over a file that size, so it plays at its own level.
+
+static FsFile  s_stream_file;
+static WavInfo s_stream_info;
+static bool    s_stream_stereo = false;
+
+bool wav_stream_open(const char* path, uint8_t load_flags)
+{
+  wav_stream_close();
+  WavInfo wi;
+  if (!wav_read_info(path, wi) || !wi.ok) return false;
+  if (wi.numChannels == 0 || wi.numChannels > 2 || wi.dataSize == 0) return false;
+  if (wi.bitsPerSample != 8 && wi.bitsPerSample != 16 &&
+      wi.bitsPerSample != 24 && wi.bitsPerSample != 32) return false;
+  s_stream_file = sd.open(path, O_RDONLY);
+  if (!s_stream_file) return false;
+  s_stream_info = wi;
+  s_stream_stereo = (load_flags & SF_LOAD_STEREO) && wi.numChannels == 2;
+  return true;
+}
+
+bool wav_stream_read(void* user, uint32_t frame, int16_t* dst, uint32_t frames)
+{
+  (void)user;
+  const WavInfo& wi = s_stream_info;
+  const uint32_t bytes_per_in = (wi.bitsPerSample / 8u) * (uint32_t)wi.numChannels;
+  if (!s_stream_file || !s_stream_file.seekSet((uint64_t)wi.dataOffset + (uint64_t)frame * bytes_per_in)) return false;
+
+  while (frames > 0) {
+    uint32_t n = CHUNK_RAW / bytes_per_in;
+    if (n > frames) n = frames;
+    const int r = s_stream_file.read(chunk_buf, n * bytes_per_in);
+    if (r != (int)(n * bytes_per_in)) return false;
+    const uint8_t* p = chunk_buf;
+    for (uint32_t i = 0; i < n; ++i) {
+      float l, rch;
+      decode_frame(p, wi.numChannels, wi.bitsPerSample, l, rch);
+      if (s_stream_stereo) {
+        *dst++ = q15_from_float(l);
+        *dst++ = q15_from_float(rch);
+      } else {
+        *dst++ = q15_from_float((wi.numChannels == 2) ? 0.5f * (l + rch) : l);
+      }
+    }
+    frames -= n;
+  }
+  return true;
+}
+
+void wav_stream_close(void)
+{
+  if (s_stream_file) s_stream_file.close();
+}
+
 } // namespace sf
 
 
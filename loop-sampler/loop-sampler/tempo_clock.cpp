@@ -0,0 +1,143 @@
+/**
+ * @file tempo_clock.cpp
+ * @brief Median + PLL tempo tracker and division table
+ *
+ * @author Brian Varren
+ * @version 1.0
+ * @date 2025
+ */
+
+#include <stdint.h>
+#include "tempo_clock.h"
+
+static const char* const s_division_names[TC_DIVISIONS] = {
+  "1/16", "1/8", "1/4", "1/2", "1 bar", "2 bars", "4 bars"
+};
+
+// ── Tracker State (core 0) ──────────────────────────────────────────────────
+static uint32_t s_intervals[TC_MEDIAN_LEN];  // Most recent intervals (us), ring
+static uint32_t s_interval_count = 0;        // Valid intervals since the last clear
+static uint32_t s_last_edge_us = 0;
+static bool     s_have_edge = false;
+static uint32_t s_period_q8 = 0;             // Tracked period, us in Q24.8
+static uint32_t s_pred_us = 0;               // Predicted next edge
+static bool     s_locked = false;
+
+// ── Division Table ──────────────────────────────────────────────────────────
+static uint32_t s_samples_per_us_q16 = 0;
+static uint32_t s_table_period_q8 = 0;       // Period the table was built for
+static uint32_t s_division_samples[TC_DIVISIONS];
+static volatile uint32_t s_generation = 0;
+static volatile float s_bpm = 0.0f;
+static volatile bool s_snap = TC_LOOP_SNAP;
+
+void tc_init(float sample_rate_hz) {
+    s_samples_per_us_q16 = (uint32_t)(sample_rate_hz * 65536.0f / 1e6f + 0.5f);
+}
+
+static uint32_t tc_median(void) {
+    const uint32_t n = (s_interval_count < TC_MEDIAN_LEN) ? s_interval_count : TC_MEDIAN_LEN;
+    uint32_t v[TC_MEDIAN_LEN];
+    for (uint32_t i = 0; i < n; ++i) {
+        // Insertion sort - at most five entries
+        const uint32_t x = s_intervals[i];
+        uint32_t j = i;
+        while (j > 0 && v[j - 1] > x) { v[j] = v[j - 1]; --j; }
+        v[j] = x;
+    }
+    return v[n / 2];
+}
+
+static void tc_unlock(void) {
+    s_interval_count = 0;
+    s_locked = false;
+    s_bpm = 0.0f;
+    for (uint32_t i = 0; i < TC_DIVISIONS; ++i) s_division_samples[i] = 0;
+    s_generation = s_generation + 1;
+}
+
+// Sixteenth note = period * triggers-per-beat / 4; division i is 2^i of them
+static void tc_build_table(void) {
+    const uint64_t sixteenth_q8 = (uint64_t)s_period_q8 * TC_TRIGGERS_PER_BEAT / 4u;
+    for (uint32_t i = 0; i < TC_DIVISIONS; ++i) {
+        s_division_samples[i] = (uint32_t)(((sixteenth_q8 << i) * s_samples_per_us_q16) >> 24);
+    }
+    s_table_period_q8 = s_period_q8;
+    s_bpm = 60e6f * 256.0f / ((float)s_period_q8 * TC_TRIGGERS_PER_BEAT);
+    s_generation = s_generation + 1;
+}
+
+void tc_edge(uint32_t t_us) {
+    if (!s_have_edge) {
+        s_have_edge = true;
+        s_last_edge_us = t_us;
+        return;
+    }
+    const uint32_t interval = t_us - s_last_edge_us;
+    if (interval < TC_MIN_PERIOD_US) return;  // Bounce: keep the earlier edge
+    s_last_edge_us = t_us;
+    if (interval > TC_MAX_PERIOD_US) {
+        if (s_locked || s_interval_count) tc_unlock();  // Clock stopped: start over
+        return;
+    }
+
+    s_intervals[s_interval_count % TC_MEDIAN_LEN] = interval;
+    s_interval_count++;
+    if (s_interval_count < 3u) return;
+    const uint32_t median_q8 = tc_median() << 8;
+
+    // Lock, or relock on a tempo jump larger than 1/8
+    const uint32_t dev_q8 = (median_q8 > s_period_q8) ? median_q8 - s_period_q8 : s_period_q8 - median_q8;
+    if (!s_locked || dev_q8 > (s_period_q8 >> 3)) {
+        s_period_q8 = median_q8;
+        s_pred_us = t_us + (s_period_q8 >> 8);
+        s_locked = true;
+        tc_build_table();
+        return;
+    }
+
+    // PLL: phase error against the prediction, clamped to half a period
+    const int32_t half = (int32_t)(s_period_q8 >> 9);
+    int32_t err = (int32_t)(t_us - s_pred_us);
+    if (err > half) err = half;
+    if (err < -half) err = -half;
+    int32_t period_q8 = (int32_t)s_period_q8;
+    period_q8 += ((int32_t)median_q8 - period_q8) >> 3;  // Towards the median
+    period_q8 += err * 16;                               // 1/16 of the phase error, in Q8
+    if (period_q8 < (int32_t)(TC_MIN_PERIOD_US << 8)) period_q8 = (int32_t)(TC_MIN_PERIOD_US << 8);
+    s_period_q8 = (uint32_t)period_q8;
+    s_pred_us = s_pred_us + (uint32_t)(err / 4) + (s_period_q8 >> 8);
+
+    // Rebuild the table only when the tempo moved audibly (1/256 = 0.4%)
+    const uint32_t drift_q8 = (s_period_q8 > s_table_period_q8) ? s_period_q8 - s_table_period_q8
+                                                                 : s_table_period_q8 - s_period_q8;
+    if (drift_q8 > (s_table_period_q8 >> 8)) tc_build_table();
+}
+
+bool tc_locked(void) {
+    return s_locked;
+}
+
+const uint32_t* tc_division_samples(void) {
+    return s_division_samples;
+}
+
+uint32_t tc_generation(void) {
+    return s_generation;
+}
+
+void tc_set_snap(bool on) {
+    s_snap = on;
+}
+
+bool tc_snap_enabled(void) {
+    return s_snap;
+}
+
+float tc_bpm(void) {
+    return s_bpm;
+}
+
+const char* tc_division_name(uint32_t div) {
+    return (div < TC_DIVISIONS) ? s_division_names[div] : "";
+}
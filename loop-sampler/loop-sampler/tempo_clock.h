@@ -0,0 +1,82 @@
+/**
+ * @file tempo_clock.h
+ * @brief Tempo tracking from reset-trigger edges and musical loop lengths
+ *
+ * Every reset-trigger edge the renderer takes (reset_trigger.h) is fed to
+ * tc_edge() with its IRQ timestamp. The clock follows it in two stages:
+ *
+ * 1. **Median**: the median of the last TC_MEDIAN_LEN intervals, so a single
+ *    missed or doubled pulse does not move the estimate. Intervals outside
+ *    TC_MIN_PERIOD_US..TC_MAX_PERIOD_US are bounce (ignored) or a stopped
+ *    clock (history cleared, the clock relocks on the next three edges).
+ * 2. **PLL**: a second-order loop on the edge phase error smooths jitter.
+ *    The period moves 1/8 of the way towards the median and 1/16 of the
+ *    phase error per edge; the predicted edge moves 1/4 of the phase error.
+ *    When the median jumps by more than 1/8 the loop relocks onto it at
+ *    once rather than gliding to the new tempo.
+ *
+ * ## Loop snapping
+ *
+ * With snapping on (TC_LOOP_SNAP or tc_set_snap()) and the clock locked, the
+ * loop length knob selects one of TC_DIVISIONS note values, 1/16 to 4 bars,
+ * instead of a free length. TC_TRIGGERS_PER_BEAT sets how many edges make a
+ * quarter note. The table of division lengths in output samples is rebuilt
+ * only when the tracked period moves by more than 1/256 (or relocks). The
+ * renderer converts it to source samples at the playback increment when
+ * either changes. Per block only the knob picks an entry.
+ *
+ * @author Brian Varren
+ * @version 1.0
+ * @date 2025
+ */
+
+#pragma once
+#include <stdint.h>
+
+// ── Configuration ───────────────────────────────────────────────────────────
+#ifndef TC_LOOP_SNAP
+#define TC_LOOP_SNAP          0           // 1 = loop length snaps to the clock at boot
+#endif
+#ifndef TC_TRIGGERS_PER_BEAT
+#define TC_TRIGGERS_PER_BEAT  1           // Reset edges per quarter note (1, 2, 4 or 24)
+#endif
+#define TC_MEDIAN_LEN         5u          // Intervals in the median window
+#define TC_MIN_PERIOD_US      5000u       // Shorter intervals are contact bounce
+#define TC_MAX_PERIOD_US      4000000u    // Longer intervals mean the clock stopped
+#define TC_DIVISIONS          7u          // 1/16, 1/8, 1/4, 1/2, 1, 2, 4 bars
+
+// ── Clock (render, core 0) ──────────────────────────────────────────────────
+
+/**
+ * @brief Set the output sample rate the division lengths are computed for
+ */
+void tc_init(float sample_rate_hz);
+
+/**
+ * @brief Feed one reset-trigger edge (time_us_32() timestamp)
+ */
+void tc_edge(uint32_t t_us);
+
+/**
+ * @brief True once three consistent intervals have been seen
+ */
+bool tc_locked(void);
+
+/**
+ * @brief Division lengths in output samples (0 while unlocked)
+ *
+ * Entry i is 2^i sixteenth notes. The pointer stays valid; the contents
+ * change only when tc_generation() does.
+ */
+const uint32_t* tc_division_samples(void);
+
+/**
+ * @brief Counter bumped every time the division table is rebuilt
+ */
+uint32_t tc_generation(void);
+
+// ── Mode and Readout (any core) ─────────────────────────────────────────────
+void tc_set_snap(bool on);
+bool tc_snap_enabled(void);
+float tc_bpm(void);                            // 0 while unlocked
+const char* tc_division_name(uint32_t div);    // "1/16" .. "4 bars"
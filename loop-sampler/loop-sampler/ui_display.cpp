@@ -9,6 +9,9 @@
 #include <pico/time.h>         // pico-sdk timer API
 #include "adc_filter.h"
 #include "audio_engine.h"
+#ifdef PROFILER_PAGE
+#include "render_profiler.h"
+#endif
 
 namespace sf {
 
@@ -194,7 +197,8 @@ void display_tick(void) {
           sd_format_size(bytesRead, sizeBuf, sizeof(sizeBuf));
           snprintf(line, sizeof(line), "Speed: %.2f MB/s", mbps);
           view_print_line(line);
-          snprintf(line, sizeof(line), "✓ Loaded %s (%u samples)", sizeBuf, (unsigned)(bytesRead / 2));
+          snprintf(line, sizeof(line), "✓ Loaded %s (%u samples%s)", sizeBuf, (unsigned)audioSampleCount,
+                   (audioChannels == 2) ? ", stereo" : "");
           view_print_line(line);
         } else {
           view_print_line("✗ Load failed");
@@ -223,10 +227,15 @@ void display_tick(void) {
         adc_debug_init();
         adc_debug_draw();
         s_state = DS_ADC_DEBUG;
+    #elif defined(PROFILER_PAGE)
+        // Show render timing while the sample plays
+        profiler_page_init();
+        profiler_page_draw();
+        s_state = DS_PROFILER;
     #else
         // Normal waveform behavior
         if (audioData && audioSampleCount > 0u) {
-          waveform_init((const int16_t*)audioData, audioSampleCount, currentWav.sampleRate);
+          waveform_init((const int16_t*)audioData, audioSampleCount, currentWav.sampleRate, audioChannels);
           waveform_draw();
           s_state = DS_WAVEFORM;
         } else {
@@ -254,6 +263,14 @@ void display_tick(void) {
       adc_debug_draw();
       break;
 #endif
+
+#ifdef PROFILER_PAGE
+    case DS_PROFILER:
+      profiler_page_draw();
+      audio_engine_arm(true);
+      audio_engine_play(true);
+      break;
+#endif
   }
 }
 
@@ -284,6 +301,12 @@ void display_on_turn(int8_t inc) {
       }
     } break;
 
+#ifdef PROFILER_PAGE
+    case DS_PROFILER:
+      profiler_page_on_turn(inc);
+      break;
+#endif
+
     // Ignore input during load/delay/setup
     case DS_SETUP:
     case DS_LOADING:
@@ -312,6 +335,12 @@ void display_on_button(void) {
       s_pendingUpdate = true;
     } break;
 
+#ifdef PROFILER_PAGE
+    case DS_PROFILER:
+      profiler_page_on_button();
+      break;
+#endif
+
     // Ignore extra presses during load/delay/setup
     case DS_SETUP:
     case DS_LOADING:
@@ -436,4 +465,61 @@ void adc_debug_exit(void) {
 }
 #endif
 
+#ifdef PROFILER_PAGE
+// ────────────────────────── Render profiler view ─────────────────────────
+static uint32_t s_profView = 0;           // 0 = stage table, 1 = totals
+static uint32_t s_profDrawnBlocks = ~0u;  // Snapshot shown (redraw on change)
+
+void profiler_page_init(void) {
+    s_profView = 0;
+    s_profDrawnBlocks = ~0u;
+}
+
+void profiler_page_draw(void) {
+    ProfSnapshot snap;
+    prof_get_snapshot(&snap);
+    if (snap.blocks == s_profDrawnBlocks) return;
+    s_profDrawnBlocks = snap.blocks;
+
+    view_clear_log();
+    char line[MAX_LINE_CHARS + 1];
+    const uint32_t first = s_profView ? PROF_PAGE_LINES : 0u;
+    for (uint32_t i = 0; i < (uint32_t)LINES_PER_SCREEN; ++i) {
+        if (!prof_format_line(&snap, first + i, line, sizeof(line))) break;
+        view_print_line(line);
+    }
+    view_flush_if_dirty();
+}
+
+bool profiler_page_on_turn(int8_t inc) {
+    (void)inc;
+    s_profView ^= 1u;
+    s_profDrawnBlocks = ~0u;
+    profiler_page_draw();
+    return true;
+}
+
+bool profiler_page_on_button(void) {
+    profiler_page_exit();
+    return false;
+}
+
+bool profiler_page_is_active(void) {
+    return s_state == DS_PROFILER;
+}
+
+void profiler_page_exit(void) {
+    view_clear_log();
+    view_flush_if_dirty();
+    if (audioData && audioSampleCount > 0u) {
+        waveform_init((const int16_t*)audioData, audioSampleCount, currentWav.sampleRate, audioChannels);
+        waveform_draw();
+        s_state = DS_WAVEFORM;
+    } else {
+        s_state = DS_BROWSER;
+        browser_render_sample_list();
+    }
+}
+#endif
+
 } // namespace sf
\ No newline at end of file
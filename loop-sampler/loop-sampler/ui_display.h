@@ -2,6 +2,7 @@
 #include <stdint.h>
 
 // #define ADC_DEBUG
+// #define PROFILER_PAGE   // Render timing page after load (render_profiler.h)
 
 // Global ISR entry you can call from ANY timer/ISR source
 extern "C" void displayTimerCallback(void);
@@ -29,13 +30,16 @@ enum DisplayState : uint8_t {
 #ifdef ADC_DEBUG
   ,DS_ADC_DEBUG         // Add ADC debug state
 #endif
+#ifdef PROFILER_PAGE
+  ,DS_PROFILER          // Render profiler page
+#endif
 };
 
 DisplayState display_state(void);
 void display_set_state(DisplayState st);
 
 // Waveform subview (kept public; you don't call these from the sketch)
-void waveform_init(const int16_t* samples, uint32_t count, uint32_t sampleRate);
+void waveform_init(const int16_t* samples, uint32_t count, uint32_t sampleRate, uint8_t channels = 1);
 void waveform_draw(void);
 bool waveform_on_turn(int8_t inc);
 bool waveform_on_button(void);
@@ -76,4 +80,14 @@ void adc_debug_exit(void);
 bool adc_debug_is_active(void);
 #endif
 
+// Render profiler page (audio keeps playing; turn flips views, button exits)
+#ifdef PROFILER_PAGE
+void profiler_page_init(void);
+void profiler_page_draw(void);
+bool profiler_page_on_turn(int8_t inc);
+bool profiler_page_on_button(void);
+void profiler_page_exit(void);
+bool profiler_page_is_active(void);
+#endif
+
 } // namespace sf
\ No newline at end of file
@@ -28,7 +28,8 @@ bool           s_wave_ready     = false;
 
 // Waveform state
 static const int16_t* s_samples     = 0;    // Q15 pointer in PSRAM
-static uint32_t       s_sampleCount = 0;
+static uint32_t       s_sampleCount = 0;    // Frames
+static uint8_t        s_channels    = 1;    // 2 = interleaved L/R
 static uint32_t       s_sampleRate  = 0;
 
 static inline int adc12ToPx256(uint16_t v) {
@@ -65,9 +66,10 @@ static inline void draw_center_line_if_empty(void) {
 }
 
 // ───────────────────────────── Waveform view ─────────────────────────────
-void waveform_init(const int16_t* samples, uint32_t count, uint32_t sampleRate) {
+void waveform_init(const int16_t* samples, uint32_t count, uint32_t sampleRate, uint8_t channels) {
   s_samples     = samples;
   s_sampleCount = count;
+  s_channels    = channels ? channels : 1;
   s_sampleRate  = sampleRate;
 }
 
@@ -91,9 +93,11 @@ void waveform_draw(void) {
     const uint32_t step = (s_sampleCount > 4096u) ? (s_sampleCount / 4096u) : 1u;
     int16_t maxabs = 1;
     for (uint32_t i = 0; i < s_sampleCount; i += step) {
-      int16_t v = s_samples[i];
-      int16_t a = (v < 0) ? (int16_t)-v : v;
-      if (a > maxabs) maxabs = a;
+      for (uint32_t c = 0; c < s_channels; ++c) {
+        int16_t v = s_samples[i * s_channels + c];
+        int16_t a = (v < 0) ? (int16_t)-v : v;
+        if (a > maxabs) maxabs = a;
+      }
     }
     peak = (maxabs < 128) ? 128 : maxabs;
   }
@@ -110,7 +114,8 @@ void waveform_draw(void) {
     if (end > s_sampleCount) end = s_sampleCount;
 
     int16_t cmin =  32767, cmax = -32768;
-    for (uint32_t i = start; i < end; ++i) {
+    // Stereo columns span both channels
+    for (uint32_t i = start * s_channels; i < end * s_channels; ++i) {
       int16_t v = s_samples[i];
       if (v < cmin) cmin = v;
       if (v > cmax) cmax = v;
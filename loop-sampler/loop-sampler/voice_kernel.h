@@ -0,0 +1,86 @@
+/**
+ * @file voice_kernel.h
+ * @brief Fixed-point increment and gain helpers for the per-sample voice loop
+ * 
+ * Everything the render loop needs per sample is prepared once per block as
+ * integers: the pitch increment (Q32.32), the TZFM modulation amount (Q15)
+ * and the resulting target increment. Inside the block the increment is
+ * linearly ramped from the previous block's value to the new target with a
+ * single 64-bit add per sample, which replaces the old per-sample float
+ * conversion, one-pole smoothing and fmaxf/fminf clamps.
+ * 
+ * ## Formats
+ * 
+ * - **Increment**: signed Q32.32 (`int64_t`), 1.0 = one source sample per output sample
+ * - **Modulator / depth**: Q15 (`int32_t`), ±32767 ≈ ±1.0
+ * - **Gain**: unsigned Q15 (`int32_t`), 32768 = 1.0
+ * 
+ * @author Brian Varren
+ * @version 1.0
+ * @date 2025
+ */
+
+#pragma once
+#include <stdint.h>
+
+// ── Limits ──────────────────────────────────────────────────────────────────
+#define VK_INC_MAX          (1LL << 37)   // ±32x speed: keeps the Q32.32 phase well in range
+#define VK_TZFM_DEPTH_MIN   33            // Q15 depth below this (~0.001) disables TZFM
+#define VK_XFADE_INC_MIN    429497LL      // ~0.0001x, floor for crossfade-time division
+
+// ── Block-rate conversions ──────────────────────────────────────────────────
+
+// Centered 12-bit ADC (2048 = 0) to bipolar Q15, clamped to -32768..32767.
+static inline int32_t vk_adc_to_bipolar_q15(uint16_t adc12) {
+  int32_t v = ((int32_t)adc12 - 2048) * 16;
+  if (v > 32767) v = 32767;
+  return v;
+}
+
+// 12-bit ADC (0..4095) to unipolar Q15 depth 0..32760.
+static inline int32_t vk_adc_to_depth_q15(uint16_t adc12) {
+  return (int32_t)adc12 << 3;
+}
+
+// Through-zero FM target increment: base * (1 + mod * depth), clamped.
+// mod and depth are Q15; base is Q32.32 with direction already applied.
+static inline int64_t vk_tzfm_increment(int64_t base_inc, int32_t mod_q15, int32_t depth_q15) {
+  int64_t inc = base_inc;
+  if (depth_q15 >= VK_TZFM_DEPTH_MIN) {
+    const int32_t fm_q15 = (mod_q15 * depth_q15) >> 15;        // -1..+1
+    inc += (base_inc * fm_q15) >> 15;
+  }
+  if (inc >  VK_INC_MAX) inc =  VK_INC_MAX;
+  if (inc < -VK_INC_MAX) inc = -VK_INC_MAX;
+  return inc;
+}
+
+// ── Per-sample increment ramp ───────────────────────────────────────────────
+// Retarget once per block, then call vk_inc_next() once per sample. After
+// `n` samples the increment lands on the target (to within n LSBs).
+struct IncRamp {
+  int64_t inc_q32_32;      // current increment
+  int64_t step_q32_32;     // per-sample delta
+};
+
+static inline void vk_inc_snap(IncRamp* r, int64_t target) {
+  r->inc_q32_32  = target;
+  r->step_q32_32 = 0;
+}
+
+static inline void vk_inc_retarget(IncRamp* r, int64_t target, uint32_t n) {
+  r->step_q32_32 = n ? (target - r->inc_q32_32) / (int64_t)n : 0;
+}
+
+static inline int64_t vk_inc_next(IncRamp* r) {
+  r->inc_q32_32 += r->step_q32_32;
+  return r->inc_q32_32;
+}
+
+// ── Buffer-edge fade ────────────────────────────────────────────────────────
+// Linear fade over the last 8 samples of the buffer: distance 7 -> ~1.0, 0 -> 0.
+// 4681 = round(32768 / 7), so the result is sample * distance / 7 in Q15.
+static inline int16_t vk_edge_fade(int16_t sample, uint32_t distance_from_end) {
+  if (distance_from_end >= 7u) return sample;
+  return (int16_t)(((int32_t)sample * (int32_t)(distance_from_end * 4681u)) >> 15);
+}
@@ -0,0 +1,46 @@
+/**
+ * @file voice_pool.cpp
+ * @brief Voice allocation and stealing for the N-voice pool
+ * 
+ * @author Brian Varren
+ * @version 1.0
+ * @date 2025
+ */
+
+#include <string.h>
+#include "voice_pool.h"
+
+void vp_init(VoicePool* p) {
+  memset(p, 0, sizeof(*p));
+  for (uint32_t k = 0; k < VP_MAX_VOICES; ++k) p->dir[k] = 1;
+  p->primary = 0;
+  p->stage[0] = VS_STEADY;
+  p->gain_q15[0] = XF_GAIN_UNITY;
+  p->active_mask = 1u;
+}
+
+uint8_t vp_alloc(VoicePool* p) {
+  uint8_t k;
+  const uint32_t full = (VP_MAX_VOICES == 32) ? 0xFFFFFFFFu : ((1u << VP_MAX_VOICES) - 1u);
+  const uint32_t free_mask = ~p->active_mask & full;
+
+  if (free_mask) {
+    k = (uint8_t)__builtin_ctz(free_mask);
+  } else {
+    // Steal the quietest released voice, oldest first on ties
+    k = (p->primary == 0) ? 1 : 0;
+    for (uint8_t i = 0; i < VP_MAX_VOICES; ++i) {
+      if (i == p->primary) continue;
+      if (p->gain_q15[i] < p->gain_q15[k] ||
+          (p->gain_q15[i] == p->gain_q15[k] && (int32_t)(p->stamp[i] - p->stamp[k]) < 0)) {
+        k = i;
+      }
+    }
+    p->steals++;
+  }
+
+  p->active_mask |= 1u << k;
+  p->stamp[k] = p->next_stamp++;
+  p->gain_q15[k] = 0;
+  return k;
+}
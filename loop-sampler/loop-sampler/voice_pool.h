@@ -0,0 +1,81 @@
+/**
+ * @file voice_pool.h
+ * @brief N-voice pool with structure-of-arrays voice state
+ * 
+ * Every sounding voice - the looping primary, the incoming voice of a loop
+ * seam and the tails left behind by retriggers - lives in one fixed pool.
+ * State is stored as parallel arrays so the render kernels walk tightly
+ * packed phase / bound / gain data, and the set of sounding voices is a
+ * bitmask so the render loop iterates only active slots.
+ * 
+ * ## Voice Stages
+ * 
+ * - **STEADY**: the primary voice at unity gain, wrapping at its loop edges
+ * - **ATTACK**: the primary voice fading in (new seam or retrigger)
+ * - **RELEASE**: any other voice, fading out along its own envelope; it is
+ *   not wrapped, so a retrigger lets the previous pass ring out
+ * 
+ * Exactly one voice is primary. Only the primary checks the crossfade zone
+ * and picks up new loop bounds; released voices never come back.
+ * 
+ * ## Allocation
+ * 
+ * A free slot is used when there is one. Otherwise the quietest released
+ * voice is stolen (oldest first on ties); the primary is never stolen.
+ * 
+ * @author Brian Varren
+ * @version 1.0
+ * @date 2025
+ */
+
+#pragma once
+#include <stdint.h>
+#include "crossfade.h"
+
+// ── Configuration ───────────────────────────────────────────────────────────
+// 4-8 voices fit the RP2350 budget; every voice costs one interpolated read
+// and a multiply-add per sample while it sounds.
+#ifndef VP_MAX_VOICES
+#define VP_MAX_VOICES   4
+#endif
+
+static_assert(VP_MAX_VOICES >= 2 && VP_MAX_VOICES <= 32, "VP_MAX_VOICES must be 2..32");
+
+typedef enum {
+  VS_STEADY  = 0,
+  VS_ATTACK  = 1,
+  VS_RELEASE = 2,
+  VS_COUNT
+} voice_stage_t;
+
+// ── Pool State (SoA) ────────────────────────────────────────────────────────
+struct VoicePool {
+  uint64_t  phase_q32_32[VP_MAX_VOICES];   // Q32.32 phase accumulators
+  uint32_t  loop_start[VP_MAX_VOICES];     // Loop start (samples)
+  uint32_t  loop_end[VP_MAX_VOICES];       // Loop end (samples, exclusive)
+  int32_t   gain_q15[VP_MAX_VOICES];       // Last rendered gain, unsigned Q15 (stealing + display)
+  XfadeRamp env[VP_MAX_VOICES];            // Attack / release envelope
+  int8_t    dir[VP_MAX_VOICES];            // Ping-pong travel direction (+1 / -1)
+  uint8_t   stage[VP_MAX_VOICES];          // voice_stage_t
+  uint32_t  stamp[VP_MAX_VOICES];          // Allocation order, for oldest-first stealing
+
+  uint32_t  active_mask;                   // Bit k set = voice k is sounding
+  uint32_t  next_stamp;
+  uint8_t   primary;                       // Index of the looping voice
+  uint32_t  steals;                        // Voices stolen since init
+};
+
+// Reset the pool: voice 0 is the primary at unity, all others free.
+void vp_init(VoicePool* p);
+
+// Claim a voice slot (free, or stolen). Never returns the primary.
+uint8_t vp_alloc(VoicePool* p);
+
+static inline void vp_free(VoicePool* p, uint8_t k) {
+  p->active_mask &= ~(1u << k);
+  p->gain_q15[k] = 0;
+}
+
+static inline uint32_t vp_active_count(const VoicePool* p) {
+  return (uint32_t)__builtin_popcount(p->active_mask);
+}
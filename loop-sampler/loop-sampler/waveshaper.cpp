@@ -0,0 +1,199 @@
+/**
+ * @file waveshaper.cpp
+ * @brief Transfer-curve tables, their rebuilds and the 1x / 2x shaping passes
+ *
+ * @author Brian Varren
+ * @version 1.0
+ * @date 2025
+ */
+
+#include <math.h>
+#include <string.h>
+#include "waveshaper.h"
+
+// Half-band taps 1, 3, 5, ... either side of the centre, Q15 of 2h (each side
+// sums to 0.5). Kaiser-windowed sinc, beta 5.
+static const int16_t WS_HB[WS_HB_TAPS] = {20473, -5871, 2570, -1093, 375, -70};
+
+// ── State ───────────────────────────────────────────────────────────────────
+// Core 0 owns the tables and the steps; core 1 only posts the curve and the
+// oversampling flag.
+static int16_t s_tables[2][WS_TABLE_SIZE];
+static uint8_t s_live = 0;                  // Table playing
+static uint8_t s_live_step = 0;             // Its drive step (0 = bypass, or none built yet)
+static ws_curve_t s_live_curve = WS_CURVE;
+static uint8_t s_step = 0;                  // Knob step after hysteresis
+static bool s_building = false;
+static uint8_t s_build_step = 0;
+static ws_curve_t s_build_curve = WS_CURVE;
+static uint32_t s_build_pos = 0;
+
+static volatile uint8_t s_curve = WS_CURVE;
+static volatile bool s_oversample = WS_OVERSAMPLE;
+
+// ── Tables ──────────────────────────────────────────────────────────────────
+static float curve_at(ws_curve_t c, float u) {
+  switch (c) {
+    case WS_CURVE_TUBE: {
+      // Slope 1 at zero: positive peaks clip near 1 / (1 + tb), negative ones
+      // only at full scale
+      const float tb = tanhf(WS_TUBE_BIAS);
+      return (tanhf(u + WS_TUBE_BIAS) - tb) / (1.0f - tb * tb);
+    }
+    case WS_CURVE_FOLD:
+      return sinf(1.57079633f * u);
+    default:
+      return tanhf(u);
+  }
+}
+
+static void build_entries(int16_t* t, uint32_t from, uint32_t to, uint8_t step, ws_curve_t c) {
+  const float a = (float)step / (float)(WS_DRIVE_STEPS - 1u);
+  const float drive = 1.0f + a * (WS_DRIVE_MAX - 1.0f);
+  for (uint32_t i = from; i < to; ++i) {
+    const float x = (float)((int32_t)(i << (16u - WS_TABLE_BITS)) - 32768) * (1.0f / 32768.0f);
+    const float y = (1.0f - a) * x + a * curve_at(c, drive * x);
+    int32_t q = (int32_t)lrintf(y * 32768.0f);
+    if (q > 32767) q = 32767;
+    if (q < -32768) q = -32768;
+    t[i] = (int16_t)q;
+  }
+}
+
+WsBlockParams ws_update(uint16_t drive_q12) {
+  // Step with hysteresis
+  const uint32_t width = 4096u / WS_DRIVE_STEPS;
+  const uint32_t lo = (uint32_t)s_step * width;
+  if ((uint32_t)drive_q12 + WS_DRIVE_HYST < lo || (uint32_t)drive_q12 >= lo + width + WS_DRIVE_HYST) {
+    s_step = (uint8_t)(drive_q12 / width);
+  }
+
+  const ws_curve_t curve = (ws_curve_t)s_curve;
+  if (s_step == 0) {
+    s_live_step = 0;
+    s_building = false;
+  } else if (!s_building && (s_step != s_live_step || curve != s_live_curve)) {
+    s_building = true;
+    s_build_step = s_step;
+    s_build_curve = curve;
+    s_build_pos = 0;
+  }
+  if (s_building) {
+    uint32_t end = s_build_pos + WS_BUILD_PER_BLOCK;
+    if (end > WS_TABLE_SIZE) end = WS_TABLE_SIZE;
+    build_entries(s_tables[s_live ^ 1u], s_build_pos, end, s_build_step, s_build_curve);
+    s_build_pos = end;
+    if (end == WS_TABLE_SIZE) {
+      s_live ^= 1u;
+      s_live_step = s_build_step;
+      s_live_curve = s_build_curve;
+      s_building = false;
+    }
+  }
+
+  WsBlockParams p;
+  p.table = s_live_step ? s_tables[s_live] : nullptr;
+  p.oversample = s_oversample;
+  return p;
+}
+
+// ── Shaping ─────────────────────────────────────────────────────────────────
+static inline int16_t lookup(const int16_t* t, int16_t x) {
+  const uint32_t u = (uint32_t)((int32_t)x + 32768);
+  const uint32_t i = u >> (16u - WS_TABLE_BITS);
+  const int32_t f = (int32_t)(u & ((1u << (16u - WS_TABLE_BITS)) - 1u));
+  const int32_t a = t[i];
+  return (int16_t)(a + (((t[i + 1] - a) * f) >> (16u - WS_TABLE_BITS)));
+}
+
+// Half-band taps around the centre between w[WS_HB_TAPS - 1] and w[WS_HB_TAPS]
+// (sums to at most 2^31 - 1 for any Q15 input)
+static inline int32_t hb_odd(const int16_t* w) {
+  int32_t acc = 0;
+  for (uint32_t j = 0; j < WS_HB_TAPS; ++j) {
+    acc += (int32_t)WS_HB[j] * ((int32_t)w[WS_HB_TAPS - 1u - j] + (int32_t)w[WS_HB_TAPS + j]);
+  }
+  return acc;
+}
+
+static inline int16_t sat16(int32_t v) {
+  if (v > 32767) v = 32767;
+  if (v < -32768) v = -32768;
+  return (int16_t)v;
+}
+
+void Waveshaper::reset() {
+  memset(in_hist, 0, sizeof(in_hist));
+  memset(odd_hist, 0, sizeof(odd_hist));
+  memset(even_hist, 0, sizeof(even_hist));
+  was_oversampling = false;
+}
+
+void Waveshaper::process_block(int16_t* buf, uint32_t n, const WsBlockParams& p) {
+  if (!p.table) {
+    was_oversampling = false;  // History is stale when the stage comes back
+    return;
+  }
+  if (!p.oversample) {
+    was_oversampling = false;
+    for (uint32_t i = 0; i < n; ++i) buf[i] = lookup(p.table, buf[i]);
+    return;
+  }
+  if (!was_oversampling) reset();
+  was_oversampling = true;
+  while (n) {
+    const uint32_t c = (n < WS_CHUNK) ? n : WS_CHUNK;
+    process_2x(buf, c, p.table);
+    buf += c;
+    n -= c;
+  }
+}
+
+// Per input sample: the even sample (the input WS_HB_TAPS back) and the odd
+// one after it (half-band) are shaped. The output is the half-band decimation
+// centred on the even sample WS_HB_TAPS - 1 back.
+void Waveshaper::process_2x(int16_t* buf, uint32_t n, const int16_t* table) {
+  const uint32_t XH = 2u * WS_HB_TAPS - 1u;
+  const uint32_t EH = WS_HB_TAPS - 1u;
+  int16_t x[XH + WS_CHUNK];
+  int16_t odd[XH + WS_CHUNK];
+  int16_t even[EH + WS_CHUNK];
+  memcpy(x, in_hist, sizeof(in_hist));
+  memcpy(x + XH, buf, n * sizeof(int16_t));
+  memcpy(odd, odd_hist, sizeof(odd_hist));
+  memcpy(even, even_hist, sizeof(even_hist));
+
+  for (uint32_t i = 0; i < n; ++i) {
+    const int16_t o = sat16((hb_odd(x + i) + 16384) >> 15);
+    even[EH + i] = lookup(table, x[i + WS_HB_TAPS - 1u]);
+    odd[XH + i] = lookup(table, o);
+    const int32_t y = (hb_odd(odd + i) >> 1) + (int32_t)even[i] * 16384 + 16384;
+    buf[i] = sat16(y >> 15);
+  }
+
+  memcpy(in_hist, x + n, sizeof(in_hist));
+  memcpy(odd_hist, odd + n, sizeof(odd_hist));
+  memcpy(even_hist, even + n, sizeof(even_hist));
+}
+
+// ── Control ─────────────────────────────────────────────────────────────────
+void ws_set_curve(ws_curve_t curve) {
+  if (curve < WS_CURVE_COUNT) s_curve = curve;
+}
+
+void ws_set_oversample(bool on) {
+  s_oversample = on;
+}
+
+void ws_serial_command(char c) {
+  if (c == 'W') ws_set_curve((ws_curve_t)((s_curve + 1u) % WS_CURVE_COUNT));
+  else if (c == 'X') ws_set_oversample(!s_oversample);
+}
+
+ws_curve_t ws_curve(void) {
+  return (ws_curve_t)s_curve;
+}
+
+bool ws_oversample(void) {
+  return s_oversample;
+}
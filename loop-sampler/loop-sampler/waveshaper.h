@@ -0,0 +1,148 @@
+/**
+ * @file waveshaper.h
+ * @brief Table waveshaper for the output saturation (FX2)
+ *
+ * The saturation stage looks every sample up in a WS_TABLE_SIZE-entry Q15
+ * transfer curve and interpolates linearly between entries. The curve holds
+ * the whole stage: the FX2 knob's drive, the curve family and the dry/wet
+ * mix. The per-sample cost is a load pair and one multiply whatever the
+ * curve.
+ *
+ * ## Curves
+ *
+ * - **TANH**: symmetric soft clip, odd harmonics (the default, and the
+ *   closest to the float polynomial this replaces)
+ * - **TUBE**: tanh with a bias, clipping the negative half later than the
+ *   positive one for even harmonics; zero in gives zero out
+ * - **FOLD**: sine wavefolder; past full drive the peaks fold back down
+ *
+ * For knob amount a (0..1) and drive d = 1 + a (WS_DRIVE_MAX - 1), the
+ * table holds (1 - a) x + a curve(d x), clamped to Q15.
+ *
+ * ## Table Updates
+ *
+ * The FX2 knob is quantized to WS_DRIVE_STEPS steps with WS_DRIVE_HYST of
+ * hysteresis, so a noisy knob does not rebuild the table. When the step or
+ * the curve changes, ws_update() builds the new table into the spare
+ * buffer, WS_BUILD_PER_BLOCK entries per block, and swaps it in when it is
+ * complete. Until then the old table keeps playing. The first step
+ * bypasses the stage.
+ *
+ * ## Oversampling
+ *
+ * With oversampling on, the stage runs at twice the output rate. A
+ * half-band FIR interpolates, the table shapes both samples, and the same
+ * half-band decimates. The half-band has WS_HB_TAPS taps each side of its
+ * centre, and every other tap is zero. It is flat to 16 kHz and rejects
+ * ~49 dB from 32 kHz (at 48 kHz out). The harmonics the curve adds above
+ * Nyquist are then filtered instead of folding back. It costs about
+ * 2 x WS_HB_TAPS multiplies and a second lookup per sample, and delays the
+ * output by 2 x WS_HB_TAPS - 1 samples.
+ *
+ * ## Cost and Aliasing (`make bench-shaper`)
+ *
+ * Host figures at full drive, TSC cycles per sample, and the power outside
+ * a 5 kHz sine's harmonics against the total:
+ *
+ *   legacy float polynomial   ~7.4 cyc
+ *   table 1x                  ~3   cyc   tanh -26 dB, tube -21 dB, fold -15 dB
+ *   table 2x                  ~27  cyc   tanh -36 dB, tube -28 dB, fold -24 dB
+ *
+ * What 2x leaves is mostly harmonics in the half-band's transition band
+ * (16-32 kHz), which fold back above 16 kHz.
+ *
+ * ## Control
+ *
+ * The curve and oversampling are set at compile time (WS_CURVE,
+ * WS_OVERSAMPLE), or from core 1 with ws_set_curve() / ws_set_oversample().
+ * Over serial, 'W' steps the curve and 'X' toggles oversampling.
+ *
+ * @author Brian Varren
+ * @version 1.0
+ * @date 2025
+ */
+
+#pragma once
+#include <stdint.h>
+
+// ── Configuration ───────────────────────────────────────────────────────────
+typedef enum : uint8_t {
+  WS_CURVE_TANH = 0,
+  WS_CURVE_TUBE = 1,
+  WS_CURVE_FOLD = 2,
+  WS_CURVE_COUNT
+} ws_curve_t;
+
+#ifndef WS_CURVE
+#define WS_CURVE            WS_CURVE_TANH
+#endif
+#ifndef WS_OVERSAMPLE
+#define WS_OVERSAMPLE       0          // 1 = run the shaper at 2x through the half-band
+#endif
+
+#define WS_TABLE_BITS       8u                          // Index bits of a Q15 sample
+#define WS_TABLE_SIZE       ((1u << WS_TABLE_BITS) + 1u) // 257 entries, last one for the interpolation
+#define WS_DRIVE_STEPS      64u        // FX2 knob steps with their own table
+#define WS_DRIVE_HYST       16u        // Knob counts past a step edge before the step changes
+#define WS_DRIVE_MAX        3.0f       // Gain into the curve at full drive
+#define WS_TUBE_BIAS        0.35f      // TUBE curve offset
+#define WS_BUILD_PER_BLOCK  33u        // Table entries built per block (257 in 8 blocks)
+#define WS_HB_TAPS          6u         // Non-zero half-band taps each side of the centre
+#define WS_CHUNK            64u        // Samples oversampled per pass (stack scratch)
+
+/**
+ * @brief What the stage does this block (from ws_update())
+ */
+struct WsBlockParams {
+  const int16_t* table;       // Transfer curve, or nullptr to bypass
+  bool oversample;            // Shape at 2x through the half-band
+};
+
+// ── Render (core 0) ─────────────────────────────────────────────────────────
+
+/**
+ * @brief Track the FX2 knob and the requested curve, build tables
+ * @param drive_q12 FX2 knob (0-4095)
+ * @return This block's parameters, shared by both channels
+ */
+WsBlockParams ws_update(uint16_t drive_q12);
+
+/**
+ * @class Waveshaper
+ * @brief One channel's shaping pass (the half-band history is per channel)
+ */
+class Waveshaper {
+public:
+  Waveshaper() { reset(); }
+
+  /**
+   * @brief Shape n Q15 samples in place
+   */
+  void process_block(int16_t* buf, uint32_t n, const WsBlockParams& p);
+
+  /**
+   * @brief Clear the half-band history
+   */
+  void reset();
+
+private:
+  void process_2x(int16_t* buf, uint32_t n, const int16_t* table);
+
+  int16_t in_hist[2 * WS_HB_TAPS - 1];     // Last inputs (interpolator taps)
+  int16_t odd_hist[2 * WS_HB_TAPS - 1];    // Last shaped odd samples (decimator taps)
+  int16_t even_hist[WS_HB_TAPS - 1];       // Shaped even samples waiting for the centre tap
+  bool was_oversampling;
+};
+
+// ── Control (core 1) ────────────────────────────────────────────────────────
+void ws_set_curve(ws_curve_t curve);
+void ws_set_oversample(bool on);
+
+/**
+ * @brief Serial keys: 'W' steps the curve, 'X' toggles oversampling
+ */
+void ws_serial_command(char c);
+
+// ── Readout (any core) ──────────────────────────────────────────────────────
+ws_curve_t ws_curve(void);
+bool ws_oversample(void);
@@ -0,0 +1,147 @@
+/**
+ * @file zero_cross.cpp
+ * @brief Zero-crossing bitmap, rank/select and nearest-crossing lookup
+ *
+ * @author Brian Varren
+ * @version 1.0
+ * @date 2025
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "zero_cross.h"
+#ifdef ARDUINO_ARCH_RP2040
+#include <Arduino.h>   // pmalloc()
+#endif
+
+ZeroCrossIndex g_zero_cross = {nullptr, nullptr, 0, 0, 0, 0, false};
+
+static volatile bool s_snap = ZC_LOOP_SNAP;
+
+static inline uint32_t zc_words(uint32_t frames) { return (frames + 31u) / 32u; }
+static inline uint32_t zc_superblocks(uint32_t frames) { return (zc_words(frames) + ZC_SB_WORDS - 1u) / ZC_SB_WORDS; }
+
+uint32_t zc_required_bytes(uint32_t frames) {
+  return (zc_words(frames) + zc_superblocks(frames) + 1u) * 4u;
+}
+
+void zc_release(ZeroCrossIndex* zc) {
+  if (zc->bits) free(zc->bits);
+  zc->bits = nullptr;
+  zc->rank = nullptr;
+  zc->frames = 0;
+  zc->crossings = 0;
+  zc->fed = 0;
+  zc->prev = 0;
+  zc->valid = false;
+}
+
+bool zc_begin(ZeroCrossIndex* zc, uint32_t frames) {
+  zc_release(zc);
+  if (frames < 2u) return false;
+  const uint32_t bytes = zc_required_bytes(frames);
+#ifdef ARDUINO_ARCH_RP2040
+  if (bytes > rp2040.getFreePSRAMHeap()) return false;
+  uint32_t* storage = (uint32_t*)pmalloc(bytes);
+#else
+  uint32_t* storage = (uint32_t*)malloc(bytes);
+#endif
+  if (!storage) return false;
+  memset(storage, 0, bytes);
+  zc->bits = storage;
+  zc->rank = storage + zc_words(frames);
+  zc->frames = frames;
+  return true;
+}
+
+void zc_feed(ZeroCrossIndex* zc, const int16_t* q15, uint32_t frames, uint8_t channels) {
+  if (!zc->bits) return;
+  if (frames > zc->frames - zc->fed) frames = zc->frames - zc->fed;
+  int32_t prev = zc->prev;
+  uint32_t i = zc->fed;
+  for (uint32_t n = 0; n < frames; ++n, ++i) {
+    const int32_t x = (channels == 2) ? (((int32_t)q15[2 * n] + q15[2 * n + 1]) >> 1) : q15[n];
+    if (prev < 0 && x >= 0 && i > 0) zc->bits[i >> 5] |= 1u << (i & 31u);
+    prev = x;
+  }
+  zc->prev = prev;
+  zc->fed = i;
+}
+
+bool zc_finish(ZeroCrossIndex* zc) {
+  if (!zc->bits || zc->fed != zc->frames) return false;
+  const uint32_t words = zc_words(zc->frames);
+  const uint32_t sbs = zc_superblocks(zc->frames);
+  uint32_t total = 0;
+  for (uint32_t s = 0; s < sbs; ++s) {
+    zc->rank[s] = total;
+    const uint32_t w1 = (s + 1u) * ZC_SB_WORDS;
+    for (uint32_t w = s * ZC_SB_WORDS; w < w1 && w < words; ++w) total += (uint32_t)__builtin_popcount(zc->bits[w]);
+  }
+  zc->rank[sbs] = total;
+  zc->crossings = total;
+  zc->valid = true;
+  return true;
+}
+
+bool zc_build(ZeroCrossIndex* zc, const int16_t* q15, uint32_t frames, uint8_t channels) {
+  if (!zc_begin(zc, frames)) return false;
+  zc_feed(zc, q15, frames, channels);
+  return zc_finish(zc);
+}
+
+// ── Rank / Select ───────────────────────────────────────────────────────────
+
+// Crossings at indices < pos
+static uint32_t zc_rank(const ZeroCrossIndex* zc, uint32_t pos) {
+  const uint32_t word = pos >> 5;
+  uint32_t r = zc->rank[word / ZC_SB_WORDS];
+  for (uint32_t w = (word / ZC_SB_WORDS) * ZC_SB_WORDS; w < word; ++w) r += (uint32_t)__builtin_popcount(zc->bits[w]);
+  const uint32_t bit = pos & 31u;
+  if (bit) r += (uint32_t)__builtin_popcount(zc->bits[word] & ((1u << bit) - 1u));
+  return r;
+}
+
+// Index of crossing k (0-based, k < crossings)
+static uint32_t zc_select(const ZeroCrossIndex* zc, uint32_t k) {
+  // Last superblock whose rank is <= k
+  uint32_t lo = 0, hi = zc_superblocks(zc->frames);
+  while (hi - lo > 1u) {
+    const uint32_t mid = (lo + hi) / 2u;
+    if (zc->rank[mid] <= k) lo = mid; else hi = mid;
+  }
+  uint32_t left = k - zc->rank[lo];
+  uint32_t w = lo * ZC_SB_WORDS;
+  for (;; ++w) {
+    const uint32_t c = (uint32_t)__builtin_popcount(zc->bits[w]);
+    if (left < c) break;
+    left -= c;
+  }
+  uint32_t bits = zc->bits[w];
+  while (left--) bits &= bits - 1u;  // Drop the lower crossings in this word
+  return (w << 5) + (uint32_t)__builtin_ctz(bits);
+}
+
+uint32_t zc_nearest(const ZeroCrossIndex* zc, uint32_t pos, uint32_t lo, uint32_t hi) {
+  if (!zc->valid || zc->crossings == 0 || pos >= zc->frames) return pos;
+  const uint32_t r = zc_rank(zc, pos);
+  uint32_t best = pos;
+  uint32_t best_dist = ZC_SNAP_RANGE + 1u;
+  if (r < zc->crossings) {
+    const uint32_t after = zc_select(zc, r);  // First crossing >= pos
+    if (after < hi && after - pos < best_dist) { best = after; best_dist = after - pos; }
+  }
+  if (r > 0) {
+    const uint32_t before = zc_select(zc, r - 1u);
+    if (before >= lo && pos - before < best_dist) best = before;
+  }
+  return best;
+}
+
+void zc_set_snap(bool on) {
+  s_snap = on;
+}
+
+bool zc_snap_enabled(void) {
+  return s_snap;
+}
@@ -0,0 +1,83 @@
+/**
+ * @file zero_cross.h
+ * @brief Rising zero-crossing index of the loaded sample
+ *
+ * The loop knobs map linearly onto arbitrary sample indices, so a loop
+ * usually starts and ends mid-waveform and the seam needs a crossfade to
+ * hide the step. This index records every rising zero crossing of the
+ * sample (x[i-1] < 0 <= x[i], on the L+R mid for stereo). With ZC_LOOP_SNAP
+ * on, calculate_boundaries() moves both loop points to the nearest crossing.
+ * Both sides of the seam then sit at zero on an upward slope, so the
+ * crossfade can shrink to a single sample. With one sample, a seam or
+ * retrigger renders two voices for that sample only.
+ *
+ * ## Layout
+ *
+ * One bit per frame (bit i set = crossing at i), plus a rank table holding
+ * the number of crossings before every 512-frame superblock. Together they
+ * take about 1/16 of a mono Q15 buffer and live in PSRAM next to it.
+ *
+ * - rank(p), the crossings before p: one table read and up to 16 popcounts.
+ * - select(k), the k-th crossing: binary search over the rank table and up
+ *   to 16 popcounts.
+ *
+ * zc_nearest() is rank plus two selects, O(log n) whatever the distance to
+ * the next crossing (silence included).
+ *
+ * ## Building
+ *
+ * wav_decode_q15_into_buffer() feeds every decoded chunk of its second pass
+ * through zc_feed(), so the index costs no extra pass over PSRAM. The host
+ * harness builds it from the whole buffer with zc_build().
+ *
+ * @author Brian Varren
+ * @version 1.0
+ * @date 2025
+ */
+
+#pragma once
+#include <stdint.h>
+
+// ── Configuration ───────────────────────────────────────────────────────────
+#ifndef ZC_LOOP_SNAP
+#define ZC_LOOP_SNAP       0        // 1 = snap loop points to crossings at boot
+#endif
+#define ZC_SNAP_RANGE      2048u    // Furthest a loop point moves (frames; ~23 Hz at 48 kHz)
+#define ZC_SB_WORDS        16u      // Bitmap words per rank superblock (512 frames)
+
+struct ZeroCrossIndex {
+  uint32_t* bits;        // Crossing bitmap, one bit per frame
+  uint32_t* rank;        // Crossings before each superblock, plus the total at the end
+  uint32_t  frames;      // Frames covered
+  uint32_t  crossings;   // Set bits
+  uint32_t  fed;         // Frames seen so far while building
+  int32_t   prev;        // Last sample fed (mid for stereo)
+  bool      valid;       // Built for the current buffer
+};
+
+extern ZeroCrossIndex g_zero_cross;
+
+// Bytes zc_begin() allocates for `frames` frames.
+uint32_t zc_required_bytes(uint32_t frames);
+
+// Allocate and clear the index for `frames` frames (PSRAM). Frees any old one.
+bool zc_begin(ZeroCrossIndex* zc, uint32_t frames);
+
+// Add `frames` decoded frames of `channels` interleaved Q15 values, in order.
+void zc_feed(ZeroCrossIndex* zc, const int16_t* q15, uint32_t frames, uint8_t channels);
+
+// Build the rank table; the index is usable once this returns true.
+bool zc_finish(ZeroCrossIndex* zc);
+
+// Begin + feed the whole buffer + finish.
+bool zc_build(ZeroCrossIndex* zc, const int16_t* q15, uint32_t frames, uint8_t channels);
+
+void zc_release(ZeroCrossIndex* zc);
+
+// Crossing nearest to pos within [lo, hi) and ZC_SNAP_RANGE of pos, or pos
+// itself if there is none (or the index is not valid).
+uint32_t zc_nearest(const ZeroCrossIndex* zc, uint32_t pos, uint32_t lo, uint32_t hi);
+
+// ── Mode ────────────────────────────────────────────────────────────────────
+void zc_set_snap(bool on);
+bool zc_snap_enabled(void);